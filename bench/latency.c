@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+/*
+ * Time how long a command takes from being handed to spawn_run(), as a
+ * rule fires, to running: each run execs this program again, which
+ * writes the time it started at to a fifo.  Commands are run in each of
+ * the ways evev may run them, in the order the helper and the launcher
+ * are started, as neither can be stopped again.
+ */
+
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "spawner.h"
+#include "types.h"
+
+#define RUNS 2000
+
+static u64 bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int bench_cmp(const void *a, const void *b)
+{
+	u64 ua = *(const u64 *)a;
+	u64 ub = *(const u64 *)b;
+
+	return ua < ub ? -1 : ua > ub;
+}
+
+/* the child's side: report when it got to run */
+static int bench_stamp(const char *fifo)
+{
+	u64 now = bench_now();
+	int fd;
+
+	fd = open(fifo, O_WRONLY);
+	if (fd == -1 || write(fd, &now, sizeof(now)) != sizeof(now))
+		return 1;
+
+	return 0;
+}
+
+static void bench_run(const char *name, const char *command, int fd,
+		unsigned int runs)
+{
+	struct pollfd pfd = { fd, POLLIN, };
+	u64 *lat;
+	u64 t0, t1;
+	int rc;
+
+	lat = calloc(runs, sizeof(*lat));
+	if (lat == NULL)
+		err(1, "calloc");
+
+	if (spawn_prepare(command))
+		err(1, "%s", command);
+
+	for (unsigned int i = 0; i < runs; ++i) {
+		t0 = bench_now();
+		rc = spawn_run(command, NULL);
+		if (rc)
+			errx(1, "%s: %s", command, strerror(rc));
+
+		do {
+			spawn_reap(NULL);
+			rc = poll(&pfd, 1, 10);
+		} while (rc == 0 || (rc == -1 && errno == EINTR));
+		if (rc == -1)
+			err(1, "poll");
+
+		if (read(fd, &t1, sizeof(t1)) != sizeof(t1))
+			errx(1, "short read");
+		lat[i] = t1 - t0;
+		spawn_reap(NULL);
+	}
+
+	qsort(lat, runs, sizeof(*lat), bench_cmp);
+	printf("%-24s p50 %8.1f us  p99 %8.1f us  max %8.1f us\n", name,
+			lat[runs / 2] / 1e3, lat[runs * 99 / 100] / 1e3,
+			lat[runs - 1] / 1e3);
+	free(lat);
+}
+
+int main(int argc, char **argv)
+{
+	char dir[] = "/tmp/evev-latency.XXXXXX";
+	unsigned int runs = RUNS;
+	char direct[PATH_MAX * 3];
+	char shell[PATH_MAX * 3 + 16];
+	char fifo[sizeof(dir) + 8];
+	char self[PATH_MAX];
+	char *end;
+	int fd;
+
+	if (argc == 3 && !strcmp(argv[1], "-w"))
+		return bench_stamp(argv[2]);
+
+	if (argc == 2) {
+		runs = strtoul(argv[1], &end, 0);
+		if (*end != '\0' || runs == 0 || runs > 1000000)
+			argc = 0;
+	}
+	if (argc > 2 || argc == 0) {
+		fprintf(stderr, "usage: %s [runs]\n", argv[0]);
+		return 1;
+	}
+
+	if (realpath("/proc/self/exe", self) == NULL)
+		err(1, "/proc/self/exe");
+
+	if (mkdtemp(dir) == NULL)
+		err(1, "mkdtemp");
+	snprintf(fifo, sizeof(fifo), "%s/fifo", dir);
+	if (mkfifo(fifo, 0600))
+		err(1, "%s", fifo);
+
+	/* read-write, so it doesn't see end of file between children */
+	fd = open(fifo, O_RDWR | O_NONBLOCK);
+	if (fd == -1)
+		err(1, "%s", fifo);
+
+	snprintf(direct, sizeof(direct), "'%s' -w '%s'", self, fifo);
+	snprintf(shell, sizeof(shell), "%s > /dev/null", direct);
+
+	bench_run("sh -c", shell, fd, runs);
+	bench_run("direct", direct, fd, runs);
+
+	if (spawn_init())
+		err(1, "spawn helper");
+	bench_run("helper, sh -c", shell, fd, runs);
+
+	if (spawn_pipeline(256))
+		err(1, "launcher");
+	bench_run("launcher (-t), direct", direct, fd, runs);
+
+	close(fd);
+	unlink(fifo);
+	rmdir(dir);
+
+	return 0;
+}
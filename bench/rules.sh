@@ -0,0 +1,29 @@
+#!/usr/bin/bash
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Print a configuration of n rules over the key codes of
+# input-event-codes.h, the same for the same n, for timing startup.
+
+n="$1"
+input_event_codes="${2:-/usr/include/linux/input-event-codes.h}"
+
+sed -n 's/^#define\s\+\(KEY_[A-Z0-9_]\+\)\s\+[0-9xA-Fa-f]\+\(\s.*\)\?$/\1/p' \
+	"$input_event_codes" |
+grep -v '_MAX$' |
+awk -v n="$n" '
+{
+	codes[ncodes++] = $1
+}
+
+END {
+	srand(1)
+	for (i = 0; i < n; ++i) {
+		a = codes[int(rand() * ncodes)]
+		b = codes[int(rand() * ncodes)]
+		c = codes[int(rand() * ncodes)]
+		if (i % 4 == 0)
+			printf "%s & (%s | !%s)[100ms] <= true\n", a, b, c
+		else
+			printf "%s & (%s | !%s) <= true\n", a, b, c
+	}
+}'
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+/*
+ * Time parsing a configuration and building its context, the work evev
+ * does at startup and on every reload, as the best of a few runs.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "context.h"
+#include "parser.h"
+#include "types.h"
+
+#define RUNS 5
+
+static u64 bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static char *bench_read(const char *path, size_t *len)
+{
+	struct stat st;
+	ssize_t n;
+	char *data;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1 || fstat(fd, &st))
+		err(1, "%s", path);
+
+	data = malloc(st.st_size + 1);
+	if (data == NULL)
+		err(1, "malloc");
+
+	n = read(fd, data, st.st_size);
+	if (n != st.st_size)
+		errx(1, "%s: short read", path);
+	close(fd);
+
+	*len = n;
+	return data;
+}
+
+int main(int argc, char **argv)
+{
+	u64 parse = -1;
+	u64 init = -1;
+	unsigned int n = 0;
+	size_t len;
+	char *data;
+
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s <cfg>\n", argv[0]);
+		return 1;
+	}
+
+	data = bench_read(argv[1], &len);
+
+	for (unsigned int run = 0; run < RUNS; ++run) {
+		struct arena arena = { 0, };
+		struct binding *bindings = NULL;
+		struct context ctx;
+		u64 t0, t1, t2;
+
+		t0 = bench_now();
+		if (psr_parse(data, len, &arena, &bindings))
+			errx(1, "%s: failed parsing", argv[1]);
+		t1 = bench_now();
+		if (ctx_init(&ctx, bindings, 0))
+			errx(1, "failed to initialize context");
+		t2 = bench_now();
+
+		if (t1 - t0 < parse)
+			parse = t1 - t0;
+		if (t2 - t1 < init)
+			init = t2 - t1;
+		n = ctx.nbindings;
+
+		ctx_free(&ctx);
+		arena_free(&arena);
+	}
+
+	printf("%8u rules  parse %8.2f ms  init %8.2f ms\n",
+			n, parse / 1e6, init / 1e6);
+
+	free(data);
+	return 0;
+}
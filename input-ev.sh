@@ -3,9 +3,6 @@
 
 export LC_COLLATE=C
 input_event_codes="$1"
-declare -A evtab
-declare -A nametabs
-table=""
 
 parse_codes()
 {
@@ -26,62 +23,245 @@ codes_to_nametabs()
 	done
 }
 
-codes_to_codetab()
+# Input is "<ctab> <code> <name>", sorted such that the preferred name for
+# a code comes last.  Output is:
+#  - code_strings: every name, NUL terminated; offset 0 is the empty string
+#  - codetab: a minimal perfect hash of name -> (type, code), built with
+#    hash & displace, where d = disp[h1 % nbuckets] and
+#    slot = (h1 + (d % size) * step(h2) + d / size) % size
+#  - code_names/typetab: (type, code) -> name, as 16 bit pool offsets
+gen_tables()
 {
-	parse_codes "$1" |
-	while read ctab code name; do
-		if [ x"$ctab" == x"BTN" ]; then
-			ctab="KEY"
-		fi
-		if [ x"${name:(-4)}" == x"_MAX" ]; then
-			continue
-		fi
-		printf "%s %s %d\n" "$name" "$ctab" "$code"
-	done
+	awk '
+	function mulmod(h, m) {
+		return ((int(h / 65536) * m) % 65536 * 65536 + (h % 65536) * m) % 4294967296
+	}
+
+	function hash(s, h, m,    i) {
+		for (i = 1; i <= length(s); ++i)
+			h = (mulmod(h, m) + ord[substr(s, i, 1)]) % 4294967296
+		return h
+	}
+
+	function isprime(n,    i) {
+		for (i = 2; i * i <= n; ++i)
+			if (n % i == 0)
+				return 0
+		return n > 1
+	}
+
+	function slot(k, d,    step) {
+		step = h2[k] % (size - 1) + 1
+		return (h1[k] % size + (d % size) * step % size + int(d / size)) % size
+	}
+
+	# returns 1 if every bucket found a displacement for the given seed
+	function place(seed,    k, b, i, d, s, n, sz, ok, used, taken) {
+		for (b = 0; b < nbuckets; ++b) {
+			bcount[b] = 0
+			disp[b] = 0
+		}
+		for (k = 0; k < nkeys; ++k) {
+			h1[k] = hash(keys[k], seed, 16777619)
+			h2[k] = hash(keys[k], seed, 2654435761)
+			b = h1[k] % nbuckets
+			bkeys[b, bcount[b]++] = k
+		}
+
+		split("", used)
+		split("", table)
+		for (sz = nkeys; sz > 0; --sz) {
+			for (b = 0; b < nbuckets; ++b) {
+				if (bcount[b] != sz)
+					continue
+				for (d = 0; d < 65536; ++d) {
+					split("", taken)
+					ok = 1
+					for (i = 0; i < sz && ok; ++i) {
+						s = slot(bkeys[b, i], d)
+						if (s in used || s in taken)
+							ok = 0
+						taken[s] = 1
+					}
+					if (ok)
+						break
+				}
+				if (!ok)
+					return 0
+				disp[b] = d
+				for (i = 0; i < sz; ++i) {
+					k = bkeys[b, i]
+					used[slot(k, d)] = 1
+					table[slot(k, d)] = k
+				}
+			}
+		}
+
+		return 1
+	}
+
+	BEGIN {
+		for (i = 32; i < 127; ++i)
+			ord[sprintf("%c", i)] = i
+		poolsz = 1
+		nkeys = 0
+	}
+
+	{
+		if (!($3 in offset)) {
+			offset[$3] = poolsz
+			pool[npool++] = $3
+			poolsz += length($3) + 1
+
+			keys[nkeys] = $3
+			kctab[nkeys] = $1
+			kcode[nkeys] = $2
+			nkeys++
+		}
+
+		if ($1 == "EV")
+			evtab[substr($3, 4)] = $2
+
+		if (!($1 in ntypes)) {
+			ntypes[$1] = 0
+			tabs[ntabs++] = $1
+		}
+		names[$1, $2] = $3
+		if ($2 + 1 > ntypes[$1])
+			ntypes[$1] = $2 + 1
+	}
+
+	END {
+		if (poolsz > 65535) {
+			print "input-ev.sh: string pool exceeds 16 bits" > "/dev/stderr"
+			exit 1
+		}
+
+		for (size = nkeys; !isprime(size); ++size)
+			;
+		nbuckets = int((nkeys + 3) / 4)
+		for (seed = 0; !place(seed); ++seed)
+			;
+
+		print "#include <string.h>"
+		print ""
+		print "#include \"tables.h\""
+		print "#include \"types.h\""
+		print ""
+
+		print "const char code_strings[] ="
+		print "\t\"\\0\""
+		for (i = 0; i < npool; ++i)
+			printf "\t\"%s\\0\"\n", pool[i]
+		print ";"
+		print ""
+
+		printf "#define CODE_SEED %d\n", seed
+		printf "#define CODE_SIZE %d\n", size
+		printf "#define CODE_BUCKETS %d\n", nbuckets
+		print ""
+
+		print "static const unsigned short code_disp[CODE_BUCKETS] = {"
+		for (b = 0; b < nbuckets; ++b)
+			printf "%s%d,", (b % 8 ? " " : (b ? "\n\t" : "\t")), disp[b]
+		print "\n};"
+		print ""
+
+		print "static const struct code_entry codetab[CODE_SIZE] = {"
+		for (s = 0; s < size; ++s) {
+			if (!(s in table))
+				continue
+			k = table[s]
+			type = kctab[k] in evtab ? evtab[kctab[k]] : 0
+			printf "\t[%4d] = { %5d, %#x, %#x },\t/* %s */\n", s,
+				offset[keys[k]], type, kcode[k], keys[k]
+		}
+		print "};"
+		print ""
+
+		base = 0
+		print "static const unsigned short code_names[] = {"
+		for (t = 0; t < ntabs; ++t) {
+			ctab = tabs[t]
+			if (!(ctab in evtab))
+				continue
+			tbase[ctab] = base
+			for (c = 0; c < ntypes[ctab]; ++c) {
+				if ((ctab, c) in names)
+					printf "\t[%5d] = %5d,\t/* %s */\n", base + c,
+						offset[names[ctab, c]], names[ctab, c]
+			}
+			base += ntypes[ctab]
+		}
+		print "};"
+		print ""
+
+		print "static const struct {"
+		print "\tunsigned short name;"
+		print "\tunsigned short base;"
+		print "\tunsigned short count;"
+		print "} typetab[] = {"
+		for (t = 0; t < ntabs; ++t) {
+			ctab = tabs[t]
+			if (!(ctab in evtab))
+				continue
+			printf "\t[%#5x] = { %5d, %5d, %5d },\t/* %s */\n",
+				evtab[ctab], offset["EV_" ctab] + 3,
+				tbase[ctab], ntypes[ctab], ctab
+		}
+		print "};"
+	}
+	'
 }
 
-echo "#include \"tables.h\""
-echo "#include \"types.h\""
-echo
+gen_tables < <(codes_to_nametabs $input_event_codes | sort -V) || exit 1
 
-while read ctab code name; do
-	if [ x"$ctab" != x"$table" ]; then
-		if [ x"$table" != x"" ]; then
-			echo "};"
-			echo
-		fi
-		table="$ctab"
-		echo "static const char *nametab_$ctab[] = {"
-		nametabs[$ctab]="$ctab"
-	fi
-	if [ x"$ctab" == x"EV" ]; then
-		evtab["${name:3}"]="$code"
-	fi
-	printf "\t[%# 5x] = \"%s\",\n" "$code" "$name"
-	
-done << EOS
-$(codes_to_nametabs $input_event_codes | sort -V)
-EOS
-echo "};"
-echo
-
-echo "const struct code_entry codetab[] = {"
-while read name ctab code; do
-	printf "\t{ %-30s %#x, %#x },\n" "\"$name\"," "${evtab[$ctab]}" "$code"
-done << EOS
-$(codes_to_codetab $input_event_codes | sort -nk 1.1,2.1)
-EOS
-echo "};"
-echo "const unsigned int codetab_sz = ARRAY_SIZE(codetab);"
-echo
-
-echo "const struct nametab_entry nametab[] = {"
-for name in ${!evtab[@]}; do
-	code=${evtab[$name]}
-	if [ x"${nametabs[$name]}" == x"" ]; then
-		continue
-	fi
-	printf "\t[%# 5x] = { \"%s\", nametab_%s },\n" "$code" "$name" "$name"
-done
-echo "};"
-echo "const unsigned int nametab_sz = ARRAY_SIZE(nametab);"
+cat << EOF
+
+static u32 code_hash(const char *name, unsigned int len, u32 h, u32 m)
+{
+	while (len--)
+		h = h * m + (unsigned char)*name++;
+
+	return h;
+}
+
+const struct code_entry *code_lookup(const char *name, unsigned int len)
+{
+	const struct code_entry *e;
+	u32 h1 = code_hash(name, len, CODE_SEED, 16777619);
+	u32 h2 = code_hash(name, len, CODE_SEED, 2654435761u);
+	u32 d = code_disp[h1 % CODE_BUCKETS];
+
+	e = &codetab[(h1 % CODE_SIZE +
+			(d % CODE_SIZE) * (h2 % (CODE_SIZE - 1) + 1) % CODE_SIZE +
+			d / CODE_SIZE) % CODE_SIZE];
+	if (e->name == 0 || strncmp(code_strings + e->name, name, len) ||
+			code_strings[e->name + len] != '\0')
+		return NULL;
+
+	return e;
+}
+
+const char *code_type_name(unsigned int type)
+{
+	if (type >= ARRAY_SIZE(typetab) || typetab[type].name == 0)
+		return NULL;
+
+	return code_strings + typetab[type].name;
+}
+
+const char *code_name(unsigned int type, unsigned int code)
+{
+	unsigned short name;
+
+	if (type >= ARRAY_SIZE(typetab) || code >= typetab[type].count)
+		return NULL;
+
+	name = code_names[typetab[type].base + code];
+	if (name == 0)
+		return NULL;
+
+	return code_strings + name;
+}
+EOF
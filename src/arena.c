@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+#ifndef ARENA_CHUNK_SIZE
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+#define ARENA_ALIGN(x) (((x) + 15) & ~(size_t)15)
+
+struct arena_chunk {
+	struct arena_chunk *next;
+	char data[] __attribute__((aligned(16)));
+};
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	struct arena_chunk *chunk;
+	size_t csize;
+
+	size = ARENA_ALIGN(size);
+
+	if (arena->chunks == NULL || arena->size - arena->used < size) {
+		csize = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+
+		chunk = calloc(1, sizeof(*chunk) + csize);
+		if (chunk == NULL)
+			return NULL;
+
+		chunk->next = arena->chunks;
+		arena->chunks = chunk;
+		arena->used = 0;
+		arena->size = csize;
+	}
+
+	arena->used += size;
+
+	return arena->chunks->data + arena->used - size;
+}
+
+void arena_free(struct arena *arena)
+{
+	struct arena_chunk *next;
+
+	for (struct arena_chunk *c = arena->chunks; c; c = next) {
+		next = c->next;
+		free(c);
+	}
+
+	memset(arena, 0, sizeof(*arena));
+}
@@ -0,0 +1,22 @@
+#ifndef __ARENA_H_
+#define __ARENA_H_
+
+#include <stddef.h>
+
+struct arena_chunk;
+
+/*
+ * Bump allocator for objects sharing one lifetime, such as everything
+ * parsed from a configuration.  Allocations are zeroed and can only be
+ * released all at once with arena_free().
+ */
+struct arena {
+	struct arena_chunk *chunks;
+	size_t used;
+	size_t size;
+};
+
+void *arena_alloc(struct arena *arena, size_t size);
+void arena_free(struct arena *arena);
+
+#endif
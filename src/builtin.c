@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "builtin.h"
+#include "tables.h"
+#include "types.h"
+#include "uinput.h"
+
+enum {
+	BUILTIN_WRITE,
+	BUILTIN_SIGNAL,
+	BUILTIN_EMIT,
+};
+
+/*
+ * An action evev carries out itself rather than running a command for:
+ * writing data to path, through fd once that is open, sending signal to
+ * the process whose pid is in the file at path, or emitting the nevs
+ * events of evs through the output device.
+ */
+struct builtin {
+	int type;
+	int fd;
+	int signal;
+	size_t len;
+	char *data;
+	struct input_event *evs;
+	unsigned int nevs;
+	char path[];
+};
+
+static const struct {
+	const char *name;
+	int signal;
+} builtin_signals[] = {
+	{ "HUP", SIGHUP },
+	{ "INT", SIGINT },
+	{ "QUIT", SIGQUIT },
+	{ "KILL", SIGKILL },
+	{ "USR1", SIGUSR1 },
+	{ "USR2", SIGUSR2 },
+	{ "ALRM", SIGALRM },
+	{ "TERM", SIGTERM },
+	{ "CONT", SIGCONT },
+	{ "STOP", SIGSTOP },
+	{ "TSTP", SIGTSTP },
+	{ "WINCH", SIGWINCH },
+};
+
+/* a signal by number, or by name with or without "SIG" */
+static int builtin_signal(const char *p, size_t len)
+{
+	char *ep;
+	long n;
+
+	n = strtol(p, &ep, 10);
+	if (ep == p + len)
+		return n > 0 && n < NSIG ? n : -1;
+
+	if (len > 3 && !strncmp(p, "SIG", 3)) {
+		p += 3;
+		len -= 3;
+	}
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(builtin_signals); ++i) {
+		if (strlen(builtin_signals[i].name) == len &&
+				!strncmp(builtin_signals[i].name, p, len))
+			return builtin_signals[i].signal;
+	}
+
+	return -1;
+}
+
+static const char *builtin_word(const char *p, size_t *len)
+{
+	while (*p == ' ' || *p == '\t')
+		++p;
+	*len = strcspn(p, " \t");
+
+	return p;
+}
+
+static void builtin_event(struct input_event *ev, unsigned int type,
+		unsigned int code, int value)
+{
+	ev->type = type;
+	ev->code = code;
+	ev->value = value;
+}
+
+/*
+ * Parse the events of "=emit" into evs, each word being a key, which is
+ * pressed and released, or an event and its value, as in "KEY_A:1" or
+ * "REL_WHEEL:-1".  Every event is followed by a SYN_REPORT, so they are
+ * seen one after the other.  Returns the number of events, or -1.
+ */
+static int builtin_events(const char *p, struct input_event *evs)
+{
+	const struct code_entry *e;
+	const char *word;
+	unsigned int n = 0;
+	size_t namelen;
+	size_t len;
+	char *ep;
+	long value;
+
+	for (;;) {
+		word = builtin_word(p, &len);
+		if (len == 0)
+			break;
+		p = word + len;
+
+		namelen = strcspn(word, ":");
+		if (namelen > len)
+			namelen = len;
+
+		e = code_lookup(word, namelen);
+		if (e == NULL || !uinput_supports(e->type, e->code))
+			return -1;
+
+		if (namelen == len) {
+			if (e->type != EV_KEY)
+				return -1;
+			builtin_event(&evs[n++], e->type, e->code, 1);
+			builtin_event(&evs[n++], EV_SYN, SYN_REPORT, 0);
+			value = 0;
+		} else {
+			value = strtol(word + namelen + 1, &ep, 10);
+			if (ep != p || ep == word + namelen + 1)
+				return -1;
+		}
+
+		builtin_event(&evs[n++], e->type, e->code, value);
+		builtin_event(&evs[n++], EV_SYN, SYN_REPORT, 0);
+	}
+
+	return n;
+}
+
+static int builtin_parse_emit(const char *p, struct builtin **bp)
+{
+	struct builtin *b;
+	int n;
+
+	b = calloc(1, sizeof(*b) + 1);
+	if (b == NULL)
+		return -1;
+	b->fd = -1;
+
+	/* a word takes two bytes or more with its blank, and four events */
+	b->evs = calloc(strlen(p) * 2 + 1, sizeof(*b->evs));
+	if (b->evs == NULL)
+		goto err;
+
+	n = builtin_events(p, b->evs);
+	if (n <= 0) {
+		errno = EINVAL;
+		goto err;
+	}
+
+	b->type = BUILTIN_EMIT;
+	b->nevs = n;
+
+	/* the device is needed anyway; create it ahead of the first use */
+	uinput_open();
+
+	*bp = b;
+	return 0;
+
+err:
+	builtin_free(b);
+	return -1;
+}
+
+/*
+ * Parse text as a builtin action, one of:
+ *   =write <path> <data>	write data and a newline to path
+ *   =signal <sig> <pidfile>	send sig to the process in pidfile
+ *   =emit <event>...		emit events through the output device
+ * Text not starting with "=" is left alone, with *bp set to NULL; what
+ * isn't understood fails with EINVAL.  The file to write to, or the
+ * output device, is opened here already, if it can be.
+ */
+int builtin_parse(const char *text, struct builtin **bp)
+{
+	struct builtin *b;
+	const char *name;
+	const char *path;
+	const char *arg;
+	size_t namelen;
+	size_t pathlen;
+	size_t arglen;
+	int type;
+	int sig = 0;
+
+	*bp = NULL;
+	if (text[0] != '=')
+		return 0;
+
+	name = builtin_word(text + 1, &namelen);
+	if (namelen == 5 && !strncmp(name, "write", namelen)) {
+		type = BUILTIN_WRITE;
+		path = builtin_word(name + namelen, &pathlen);
+		arg = builtin_word(path + pathlen, &arglen);
+		/* the data is the rest of the line */
+		arglen = strlen(arg);
+		while (arglen > 0 && strchr(" \t", arg[arglen - 1]))
+			--arglen;
+	} else if (namelen == 6 && !strncmp(name, "signal", namelen)) {
+		type = BUILTIN_SIGNAL;
+		arg = builtin_word(name + namelen, &arglen);
+		path = builtin_word(arg + arglen, &pathlen);
+		sig = builtin_signal(arg, arglen);
+		builtin_word(path + pathlen, &namelen);
+		if (sig == -1 || namelen != 0)
+			goto inval;
+	} else if (namelen == 4 && !strncmp(name, "emit", namelen)) {
+		return builtin_parse_emit(name + namelen, bp);
+	} else {
+		goto inval;
+	}
+
+	if (pathlen == 0 || arglen == 0)
+		goto inval;
+
+	b = calloc(1, sizeof(*b) + pathlen + 1 + arglen + 1);
+	if (b == NULL)
+		return -1;
+
+	b->type = type;
+	b->signal = sig;
+	memcpy(b->path, path, pathlen);
+	b->data = b->path + pathlen + 1;
+	memcpy(b->data, arg, arglen);
+	b->data[arglen] = '\n';
+	b->len = arglen + 1;
+
+	b->fd = -1;
+	if (type == BUILTIN_WRITE)
+		b->fd = open(b->path, O_WRONLY | O_CLOEXEC);
+
+	*bp = b;
+	return 0;
+
+inval:
+	errno = EINVAL;
+	return -1;
+}
+
+void builtin_free(struct builtin *b)
+{
+	if (b == NULL)
+		return;
+
+	if (b->fd != -1)
+		close(b->fd);
+	free(b->evs);
+	free(b);
+}
+
+/*
+ * Sysfs and procfs attributes take a write at offset 0 as a whole, which
+ * lets the same descriptor be used over and over.  Should it fail, the
+ * file is opened anew the next time, in case it was replaced.
+ */
+static int builtin_write(struct builtin *b)
+{
+	ssize_t n;
+
+	if (b->fd == -1) {
+		b->fd = open(b->path, O_WRONLY | O_CLOEXEC);
+		if (b->fd == -1)
+			return -1;
+	}
+
+	n = pwrite(b->fd, b->data, b->len, 0);
+	if (n == -1 && errno == ESPIPE)
+		n = write(b->fd, b->data, b->len);
+	if (n == b->len)
+		return 0;
+
+	if (n != -1)
+		errno = EIO;
+	close(b->fd);
+	b->fd = -1;
+
+	return -1;
+}
+
+/* the pidfile is read every time, as the process may have been restarted */
+static int builtin_kill(struct builtin *b)
+{
+	char buf[24];
+	ssize_t n;
+	char *ep;
+	long pid;
+	int fd;
+
+	fd = open(b->path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return -1;
+
+	n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (n == -1)
+		return -1;
+	buf[n] = '\0';
+
+	pid = strtol(buf, &ep, 10);
+	if (ep == buf || pid <= 0 || (*ep != '\0' && *ep != '\n')) {
+		errno = ESRCH;
+		return -1;
+	}
+
+	return kill(pid, b->signal);
+}
+
+/* carry out b, failing with errno set */
+int builtin_run(struct builtin *b)
+{
+	switch (b->type) {
+	case BUILTIN_WRITE:
+		return builtin_write(b);
+	case BUILTIN_SIGNAL:
+		return builtin_kill(b);
+	case BUILTIN_EMIT:
+		return uinput_emit(b->evs, b->nevs);
+	}
+
+	errno = EINVAL;
+	return -1;
+}
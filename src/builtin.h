@@ -0,0 +1,10 @@
+#ifndef __BUILTIN_H_
+#define __BUILTIN_H_
+
+struct builtin;
+
+int builtin_parse(const char *text, struct builtin **bp);
+int builtin_run(struct builtin *b);
+void builtin_free(struct builtin *b);
+
+#endif
@@ -0,0 +1,394 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "arena.h"
+#include "cache.h"
+#include "context.h"
+#include "types.h"
+
+#define CACHE_MAGIC "evevcfg"
+#define CACHE_VERSION 1
+#define CACHE_LAYOUT ((sizeof(struct insn) << 16) | sizeof(struct evstate))
+
+/*
+ * Image layout; every section starts 8 byte aligned:
+ *   header
+ *   nsources * (cache_source, path)
+ *   states, listeners, insns, users
+ *   nbindings * cache_binding
+ *   command string pool
+ */
+struct cache_header {
+	char magic[8];
+	u32 version;
+	u32 layout;
+	u32 size;
+	u32 nsources;
+	u32 nstates;
+	u32 nlisteners;
+	u32 ninsns;
+	u32 nusers;
+	u32 nbindings;
+	u32 strings;
+};
+
+struct cache_source {
+	u64 mtime;
+	u64 size;
+	u64 hash;
+	/* zero for inline configuration */
+	u32 pathlen;
+	u32 reserved;
+};
+
+struct cache_binding {
+	u32 root;
+	u32 command;
+};
+
+#define ALIGN8(x) (((x) + 7) & ~(size_t)7)
+
+static u64 cache_hash(const char *data, size_t len)
+{
+	u64 h = 14695981039346656037ull;
+
+	for (size_t i = 0; i < len; ++i) {
+		h ^= (unsigned char)data[i];
+		h *= 1099511628211ull;
+	}
+
+	return h;
+}
+
+static int cache_hash_file(const char *path, u64 *hash, struct stat *st)
+{
+	char *mem;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return -1;
+
+	if (fstat(fd, st) == -1) {
+		close(fd);
+		return -1;
+	}
+
+	if (st->st_size == 0) {
+		*hash = cache_hash(NULL, 0);
+		close(fd);
+		return 0;
+	}
+
+	mem = mmap(0, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mem == MAP_FAILED)
+		return -1;
+
+	*hash = cache_hash(mem, st->st_size);
+	munmap(mem, st->st_size);
+
+	return 0;
+}
+
+static u64 cache_mtime(const struct stat *st)
+{
+	return (u64)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+}
+
+static unsigned int cache_nsources(char **paths, const char *text)
+{
+	unsigned int n = text != NULL;
+
+	for (unsigned int i = 0; paths && paths[i]; ++i)
+		++n;
+
+	return n;
+}
+
+/* returns the offset past the source records, or 0 if they are stale */
+static size_t cache_check_sources(const char *mem, size_t size,
+		char **paths, const char *text)
+{
+	const struct cache_header *hdr = (const void *)mem;
+	size_t off = ALIGN8(sizeof(*hdr));
+	unsigned int i = 0;
+
+	if (hdr->nsources != cache_nsources(paths, text))
+		return 0;
+
+	for (unsigned int n = 0; n < hdr->nsources; ++n) {
+		const struct cache_source *src;
+		const char *path;
+		struct stat st;
+		u64 hash;
+
+		if (size < off + sizeof(*src))
+			return 0;
+		src = (const void *)(mem + off);
+		off += sizeof(*src);
+
+		if (size < off + src->pathlen)
+			return 0;
+		path = mem + off;
+		off = ALIGN8(off + src->pathlen);
+
+		if (src->pathlen == 0) {
+			if (text == NULL || src->size != strlen(text) ||
+					src->hash != cache_hash(text, src->size))
+				return 0;
+			continue;
+		}
+
+		if (paths[i] == NULL || strlen(paths[i]) != src->pathlen ||
+				memcmp(paths[i], path, src->pathlen))
+			return 0;
+
+		if (stat(paths[i], &st) == -1 || st.st_size != src->size)
+			return 0;
+
+		/* a touched but otherwise unchanged file is still valid */
+		if (cache_mtime(&st) != src->mtime) {
+			if (cache_hash_file(paths[i], &hash, &st) ||
+					hash != src->hash)
+				return 0;
+		}
+
+		++i;
+	}
+
+	return off;
+}
+
+int cache_load(const char *path, char **paths, const char *text,
+		struct context *ctx, struct arena *arena, unsigned int flags)
+{
+	const struct cache_binding *cb;
+	const struct cache_header *hdr;
+	struct binding *bindings = NULL;
+	struct binding **pb = &bindings;
+	struct ctx_image img;
+	const char *strings;
+	struct binding *b;
+	struct stat st;
+	size_t size;
+	size_t off;
+	char *mem;
+	int rc = -1;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return -1;
+
+	if (fstat(fd, &st) == -1 || st.st_size < sizeof(*hdr)) {
+		close(fd);
+		return -1;
+	}
+	size = st.st_size;
+
+	mem = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mem == MAP_FAILED)
+		return -1;
+
+	hdr = (const void *)mem;
+	if (memcmp(hdr->magic, CACHE_MAGIC, sizeof(hdr->magic)) ||
+			hdr->version != CACHE_VERSION ||
+			hdr->layout != CACHE_LAYOUT || hdr->size != size)
+		goto out;
+
+	off = cache_check_sources(mem, size, paths, text);
+	if (off == 0)
+		goto out;
+
+#define SECTION(dst, n) do { \
+		if ((size - off) / sizeof(*(dst)) < (n)) \
+			goto out; \
+		(dst) = (const void *)(mem + off); \
+		off = ALIGN8(off + (n) * sizeof(*(dst))); \
+		if (off > size) \
+			goto out; \
+	} while (0)
+
+	SECTION(img.states, hdr->nstates);
+	SECTION(img.listeners, hdr->nlisteners);
+	SECTION(img.insns, hdr->ninsns);
+	SECTION(img.users, hdr->nusers);
+	SECTION(cb, hdr->nbindings);
+	SECTION(strings, hdr->strings);
+
+#undef SECTION
+
+	if (hdr->strings == 0 || strings[hdr->strings - 1] != '\0')
+		goto out;
+
+	img.nstates = hdr->nstates;
+	img.nlisteners = hdr->nlisteners;
+	img.ninsns = hdr->ninsns;
+	img.nusers = hdr->nusers;
+	img.nbindings = hdr->nbindings;
+
+	for (unsigned int i = 0; i < hdr->nbindings; ++i) {
+		if (cb[i].command >= hdr->strings)
+			goto out;
+	}
+
+	for (unsigned int i = 0; i < hdr->nbindings; ++i) {
+		const char *command = strings + cb[i].command;
+
+		b = arena_alloc(arena, sizeof(*b) + strlen(command) + 1);
+		if (b == NULL)
+			goto out;
+
+		b->root = cb[i].root;
+		strcpy(b->command, command);
+
+		*pb = b;
+		pb = &b->next;
+	}
+
+	rc = ctx_load(ctx, &img, bindings, flags);
+
+out:
+	munmap(mem, st.st_size);
+	return rc;
+}
+
+static int cache_pad(FILE *fp, size_t len)
+{
+	static const char pad[8];
+
+	if (ALIGN8(len) != len &&
+			fwrite(pad, ALIGN8(len) - len, 1, fp) != 1)
+		return -1;
+
+	return 0;
+}
+
+static int cache_write(FILE *fp, const void *data, size_t len)
+{
+	if (len && fwrite(data, len, 1, fp) != 1)
+		return -1;
+
+	return cache_pad(fp, len);
+}
+
+int cache_save(const char *path, char **paths, const char *text,
+		struct context *ctx)
+{
+	struct cache_header hdr = { CACHE_MAGIC, };
+	struct cache_binding *cb;
+	size_t strings = 0;
+	char tmp[4096];
+	size_t size;
+	FILE *fp;
+	int rc = -1;
+	int fd;
+
+	cb = calloc(ctx->nbindings + 1, sizeof(*cb));
+	if (cb == NULL)
+		return -1;
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i) {
+		cb[i].root = ctx->bindv[i]->root;
+		cb[i].command = strings;
+		strings += strlen(ctx->bindv[i]->command) + 1;
+	}
+
+	hdr.version = CACHE_VERSION;
+	hdr.layout = CACHE_LAYOUT;
+	hdr.nsources = cache_nsources(paths, text);
+	hdr.nstates = ctx->nstates;
+	hdr.nlisteners = ctx->nlisteners;
+	hdr.ninsns = ctx->ninsns;
+	hdr.nusers = ctx->nusers;
+	hdr.nbindings = ctx->nbindings;
+	hdr.strings = strings;
+
+	/* a name of our own, so that instances sharing path don't collide */
+	if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path) >= sizeof(tmp))
+		goto out;
+	fd = mkstemp(tmp);
+	if (fd == -1)
+		goto out;
+	fp = fdopen(fd, "w");
+	if (fp == NULL) {
+		close(fd);
+		goto unlink;
+	}
+
+	if (cache_write(fp, &hdr, sizeof(hdr)))
+		goto err;
+
+	for (unsigned int i = 0; i < hdr.nsources; ++i) {
+		struct cache_source src = {0,};
+		const char *name = "";
+		struct stat st;
+
+		if (text && i == 0) {
+			src.size = strlen(text);
+			src.hash = cache_hash(text, src.size);
+		} else {
+			name = paths[i - (text != NULL)];
+			if (cache_hash_file(name, &src.hash, &st))
+				goto err;
+			src.mtime = cache_mtime(&st);
+			src.size = st.st_size;
+			src.pathlen = strlen(name);
+		}
+
+		if (cache_write(fp, &src, sizeof(src)) ||
+				cache_write(fp, name, src.pathlen))
+			goto err;
+	}
+
+	if (cache_write(fp, ctx->states, ctx->nstates * sizeof(*ctx->states)) ||
+			cache_write(fp, ctx->listeners,
+				ctx->nlisteners * sizeof(*ctx->listeners)) ||
+			cache_write(fp, ctx->insns,
+				ctx->ninsns * sizeof(*ctx->insns)) ||
+			cache_write(fp, ctx->users,
+				ctx->nusers * sizeof(*ctx->users)) ||
+			cache_write(fp, cb, ctx->nbindings * sizeof(*cb)))
+		goto err;
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i) {
+		const char *command = ctx->bindv[i]->command;
+
+		if (fwrite(command, strlen(command) + 1, 1, fp) != 1)
+			goto err;
+	}
+	if (cache_pad(fp, strings))
+		goto err;
+
+	size = ftell(fp);
+	hdr.size = size;
+	if (fseek(fp, 0, SEEK_SET) || cache_write(fp, &hdr, sizeof(hdr)))
+		goto err;
+
+	if (fclose(fp))
+		goto unlink;
+	fp = NULL;
+
+	rc = rename(tmp, path);
+
+err:
+	if (fp)
+		fclose(fp);
+unlink:
+	if (rc)
+		unlink(tmp);
+out:
+	free(cb);
+	return rc;
+}
@@ -0,0 +1,12 @@
+#ifndef __CACHE_H_
+#define __CACHE_H_
+
+struct arena;
+struct context;
+
+int cache_load(const char *path, char **paths, const char *text,
+		struct context *ctx, struct arena *arena, unsigned int flags);
+int cache_save(const char *path, char **paths, const char *text,
+		struct context *ctx);
+
+#endif
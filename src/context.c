@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <linux/input.h>
+
 #include "context.h"
 #include "expr.h"
 
@@ -15,256 +17,2049 @@ static int ctx_state_cmp(const void *a, const void *b)
 	return sa->typecode - sb->typecode;
 }
 
-static void ctx_init_expr_pass2(struct context *ctx, struct expr *e)
+static int ctx_state_insert(struct context *ctx, unsigned int typecode)
 {
-	switch (e->type) {
-	case EXPR_OR:
-	case EXPR_XOR:
-	case EXPR_AND:
-		ctx_init_expr_pass2(ctx, e->binop.left);
-		ctx_init_expr_pass2(ctx, e->binop.right);
-		break;
-	case EXPR_NOT:
-		ctx_init_expr_pass2(ctx, e->not);
-		break;
-	case EXPR_DUR:
-		ctx_init_expr_pass2(ctx, e->dur.expr);
-		break;
-	case EXPR_PRIMARY: {
-		struct expr_match m;
-		unsigned int index;
+	unsigned int mask = ctx->nhash - 1;
+	unsigned int h;
 
-		m = e->primary;
+	/* keep the index at most half full */
+	if (ctx->nstates * 2 >= ctx->nhash) {
+		unsigned int nhash = ctx->nhash ? ctx->nhash * 2 : 64;
+		struct evstate *states;
+		unsigned int *hash;
 
-		e->type = EXPR_CINFO;
-		e->cinfo.value = m.value;
-		e->cinfo.cmp = m.cmp;
+		hash = malloc(nhash * sizeof(*hash));
+		states = realloc(ctx->states, nhash / 2 * sizeof(*states));
+		if (hash == NULL || states == NULL) {
+			free(hash);
+			if (states)
+				ctx->states = states;
+			return -1;
+		}
+		memset(hash, 0xff, nhash * sizeof(*hash));
 
-		index = ctx->nstates;
+		free(ctx->hash);
+		ctx->hash = hash;
+		ctx->nhash = nhash;
+		ctx->states = states;
+		mask = nhash - 1;
 
 		for (unsigned int i = 0; i < ctx->nstates; ++i) {
-			if (ctx->states[i].typecode == m.lookup) {
-				index = i;
-				break;
-			}
+			h = (ctx->states[i].typecode * 2654435761u) & mask;
+			while (ctx->hash[h] != -1)
+				h = (h + 1) & mask;
+			ctx->hash[h] = i;
 		}
-		e->cinfo.lookup = index;
+	}
 
-		} break;
-	case EXPR_CINFO:
-		break;
+	h = (typecode * 2654435761u) & mask;
+	while (ctx->hash[h] != -1) {
+		if (ctx->states[ctx->hash[h]].typecode == typecode)
+			return 0;
+		h = (h + 1) & mask;
 	}
+
+	ctx->hash[h] = ctx->nstates;
+	memset(&ctx->states[ctx->nstates], 0, sizeof(*ctx->states));
+	ctx->states[ctx->nstates++].typecode = typecode;
+
+	return 0;
 }
 
-static void ctx_init_expr_pass1(struct context *ctx,
-		struct binding *binding, struct expr *e)
+static int ctx_init_expr_pass1(struct context *ctx, struct expr *e)
 {
+	++ctx->ninsns;
+
 	switch (e->type) {
 	case EXPR_OR:
 	case EXPR_XOR:
 	case EXPR_AND:
-		ctx_init_expr_pass1(ctx, binding, e->binop.left);
-		ctx_init_expr_pass1(ctx, binding, e->binop.right);
-		break;
+		if (ctx_init_expr_pass1(ctx, e->binop.left))
+			return -1;
+		return ctx_init_expr_pass1(ctx, e->binop.right);
 	case EXPR_NOT:
-		ctx_init_expr_pass1(ctx, binding, e->not);
-		break;
+		return ctx_init_expr_pass1(ctx, e->not);
 	case EXPR_DUR:
-		++ctx->ndurations;
-		ctx_init_expr_pass1(ctx, binding, e->dur.expr);
+		return ctx_init_expr_pass1(ctx, e->dur.expr);
+	case EXPR_PRIMARY:
+		return ctx_state_insert(ctx, e->primary.lookup);
+	case EXPR_CINFO:
 		break;
-	case EXPR_PRIMARY: {
-		struct evstate *evs;
-		unsigned int index;
+	}
 
-		index = ctx->nstates;
+	return 0;
+}
 
-		for (unsigned int i = 0; i < ctx->nstates; ++i) {
-			if (ctx->states[i].typecode == e->primary.lookup) {
-				index = i;
-				break;
-			}
-		}
-		if (index == ctx->nstates) {
-			ctx->states = realloc(ctx->states,
-					sizeof(*ctx->states) * ++ctx->nstates);
-			memset(&ctx->states[ctx->nstates - 1], 0,
-					sizeof(*ctx->states));
-			ctx->states[ctx->nstates - 1].typecode = e->primary.lookup;
-		}
+/* returns the index of the state tracking typecode, or -1 */
+int ctx_state_lookup(struct context *ctx, unsigned int typecode)
+{
+	unsigned int type = typecode >> 16;
+	unsigned int code = typecode & 0xffff;
+	unsigned int idx;
 
-		evs = &ctx->states[index];
-		evs->listeners = realloc(evs->listeners,
-				sizeof(binding) * ++evs->nlisteners);
-		evs->listeners[evs->nlisteners - 1] = binding;
-		} break;
-	case EXPR_CINFO:
+	if (type >= CTX_LOOKUPS || code >= ctx->nlookup[type])
+		return -1;
+
+	idx = ctx->lookup[type][code];
+
+	return idx == 0xffff ? -1 : idx;
+}
+
+static unsigned int ctx_insn_states(struct context *ctx, unsigned int i,
+		unsigned int *states, unsigned int n, unsigned int max)
+{
+	const struct insn *in = &ctx->insns[i];
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		n = ctx_insn_states(ctx, in->binop.left, states, n, max);
+		if (in->binop.right == in->binop.left)
+			return n;
+		return ctx_insn_states(ctx, in->binop.right, states, n, max);
+	case INSN_NOT:
+		return ctx_insn_states(ctx, in->not, states, n, max);
+	case INSN_DUR:
+		return ctx_insn_states(ctx, in->dur.expr, states, n, max);
+	case INSN_CMP:
+		for (unsigned int j = 0; j < n; ++j) {
+			if (states[j] == in->cmp.lookup)
+				return n;
+		}
+		if (n < max)
+			states[n++] = in->cmp.lookup;
 		break;
 	}
+
+	return n;
 }
 
-int ctx_init(struct context *ctx, struct binding *bindings)
+/*
+ * Collect the states b depends on, each once, in the order the expression
+ * mentions them.  Returns how many were stored, at most max.
+ */
+unsigned int ctx_binding_states(struct context *ctx, struct binding *b,
+		unsigned int *states, unsigned int max)
 {
-	ctx->durations = NULL;
-	ctx->states = NULL;
-	ctx->ndurations = 0;
-	ctx->bindings = bindings;
-	ctx->nstates = 0;
+	return ctx_insn_states(ctx, b->root, states, 0, max);
+}
+
+static int ctx_insn_local(struct context *ctx, unsigned int i)
+{
+	const struct insn *in = &ctx->insns[i];
 
-	for (struct binding *b = bindings; b; b = b->next)
-		ctx_init_expr_pass1(ctx, b, b->expr);
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		return ctx_insn_local(ctx, in->binop.left) &&
+			ctx_insn_local(ctx, in->binop.right);
+	case INSN_NOT:
+		return ctx_insn_local(ctx, in->not);
+	case INSN_DUR:
+		return ctx_insn_local(ctx, in->dur.expr);
+	case INSN_CMP:
+		return !expr_device(ctx->states[in->cmp.lookup].typecode);
+	}
 
-	qsort(ctx->states, ctx->nstates, sizeof(*ctx->states), ctx_state_cmp);
+	return 1;
+}
 
-	for (struct binding *b = bindings; b; b = b->next)
-		ctx_init_expr_pass2(ctx, b->expr);
+/* whether b only depends on events no device qualifies, see expr_qualify() */
+int ctx_binding_local(struct context *ctx, struct binding *b)
+{
+	return ctx_insn_local(ctx, b->root);
+}
 
-	ctx->durations = calloc(ctx->ndurations, sizeof(*ctx->durations));
-	if (ctx == NULL) {
-		free(ctx->states);
-		return -1;
+static int ctx_insn_reads(struct context *ctx, unsigned int i,
+		const unsigned char *states)
+{
+	const struct insn *in = &ctx->insns[i];
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		return ctx_insn_reads(ctx, in->binop.left, states) ||
+			ctx_insn_reads(ctx, in->binop.right, states);
+	case INSN_NOT:
+		return ctx_insn_reads(ctx, in->not, states);
+	case INSN_DUR:
+		return ctx_insn_reads(ctx, in->dur.expr, states);
+	case INSN_CMP:
+		return states[in->cmp.lookup];
 	}
-	ctx->ndurations = 0;
 
 	return 0;
 }
 
-static int ctx_value(struct context *ctx, unsigned int idx)
+/* whether b depends on any of the states set in states, indexed as ctx's */
+int ctx_binding_reads(struct context *ctx, struct binding *b,
+		const unsigned char *states)
 {
-	return ctx->states[idx].value;
+	return ctx_insn_reads(ctx, b->root, states);
 }
 
-static void ctx_dur_remove(struct context *ctx, struct expr *e)
+static unsigned int ctx_insn_hash(const struct insn *in)
 {
-	for (unsigned int i = 0; i < ctx->ndurations; ++i) {
-		if (ctx->durations[i] == e) {
-			ctx->durations[i] = NULL;
-			break;
-		}
+	u32 h = 2166136261u;
+	u32 k[4] = { in->op, };
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		k[1] = in->binop.left;
+		k[2] = in->binop.right;
+		break;
+	case INSN_NOT:
+		k[1] = in->not;
+		break;
+	case INSN_DUR:
+		k[1] = in->dur.expr;
+		k[2] = in->dur.duration;
+		break;
+	case INSN_CMP:
+		k[1] = in->cmp.lookup;
+		k[2] = in->cmp.cmp;
+		k[3] = in->cmp.value;
+		break;
 	}
 
-	while (ctx->ndurations > 0 &&
-			ctx->durations[ctx->ndurations - 1] == NULL)
-		--ctx->ndurations;
+	for (unsigned int i = 0; i < ARRAY_SIZE(k); ++i) {
+		h ^= k[i];
+		h *= 16777619u;
+		h ^= h >> 15;
+	}
+
+	return h;
+}
+
+static int ctx_insn_equal(const struct insn *a, const struct insn *b)
+{
+	if (a->op != b->op)
+		return 0;
+
+	switch (a->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		return a->binop.left == b->binop.left &&
+			a->binop.right == b->binop.right;
+	case INSN_NOT:
+		return a->not == b->not;
+	case INSN_DUR:
+		return a->dur.expr == b->dur.expr &&
+			a->dur.duration == b->dur.duration;
+	case INSN_CMP:
+		return a->cmp.lookup == b->cmp.lookup &&
+			a->cmp.cmp == b->cmp.cmp &&
+			a->cmp.value == b->cmp.value;
+	}
+
+	return 0;
+}
+
+/*
+ * Emit an instruction, or return the index of a structurally identical
+ * one emitted earlier, so that shared subexpressions are evaluated once.
+ */
+static unsigned int ctx_emit(struct context *ctx, struct insn *insn)
+{
+	unsigned int mask = ctx->nhash - 1;
+	unsigned int h = ctx_insn_hash(insn) & mask;
+
+	while (ctx->hash[h] != -1) {
+		if (ctx_insn_equal(&ctx->insns[ctx->hash[h]], insn))
+			return ctx->hash[h];
+		h = (h + 1) & mask;
+	}
+
+	if (insn->op == INSN_CMP) {
+		++ctx->states[insn->cmp.lookup].nlisteners;
+	}
+
+	ctx->hash[h] = ctx->ninsns;
+	ctx->insns[ctx->ninsns] = *insn;
+
+	return ctx->ninsns++;
 }
 
-static int ctx_expr_eval(struct context *ctx, struct expr *e, u64 now)
+static unsigned int ctx_state_add(struct context *ctx, unsigned int typecode);
+static unsigned int ctx_link(struct context *ctx, struct insn *insn, u64 now);
+
+/*
+ * Compile e into instructions.  With now set, e is added to a live
+ * context, see ctx_bind(); otherwise the arrays are sized by ctx_init().
+ * Returns the index of the root instruction, or -1.
+ */
+static unsigned int ctx_compile(struct context *ctx, struct expr *e,
+		const u64 *now)
 {
-	int rc;
+	struct insn insn = {0,};
 
 	switch (e->type) {
 	case EXPR_OR:
-		return ctx_expr_eval(ctx, e->or.left, now) |
-			ctx_expr_eval(ctx, e->or.right, now);
 	case EXPR_XOR:
-		return ctx_expr_eval(ctx, e->xor.left, now) ^
-			ctx_expr_eval(ctx, e->xor.right, now);
-	case EXPR_AND:
-		return ctx_expr_eval(ctx, e->and.left, now) &
-			ctx_expr_eval(ctx, e->and.right, now);
+	case EXPR_AND: {
+		unsigned int l, r;
+
+		if (e->type == EXPR_OR)
+			insn.op = INSN_OR;
+		else if (e->type == EXPR_XOR)
+			insn.op = INSN_XOR;
+		else
+			insn.op = INSN_AND;
+
+		/* all binary operators commute; canonicalize operand order */
+		l = ctx_compile(ctx, e->binop.left, now);
+		r = ctx_compile(ctx, e->binop.right, now);
+		if (l == -1 || r == -1)
+			return -1;
+		insn.binop.left = l < r ? l : r;
+		insn.binop.right = l < r ? r : l;
+		} break;
 	case EXPR_NOT:
-		return !ctx_expr_eval(ctx, e->not, now);
+		insn.op = INSN_NOT;
+		insn.not = ctx_compile(ctx, e->not, now);
+		if (insn.not == -1)
+			return -1;
+		break;
 	case EXPR_DUR:
-		rc = ctx_expr_eval(ctx, e->dur.expr, now);
-		if (rc) {
-			if (e->dur.end == 0) {
-				e->dur.end = now + e->dur.duration;
-				ctx->durations[ctx->ndurations++] = e;
-			} else if (now >= e->dur.end) {
-				ctx_dur_remove(ctx, e);
-				return 1;
-			}
-		} else if (e->dur.end != 0) {
-			ctx_dur_remove(ctx, e);
-			e->dur.end = 0;
-		}
-		return 0;
+		insn.op = INSN_DUR;
+		insn.dur.expr = ctx_compile(ctx, e->dur.expr, now);
+		if (insn.dur.expr == -1)
+			return -1;
+		insn.dur.duration = e->dur.duration;
+		insn.dur.slot = -1;
+		insn.dur.end = 0;
+		break;
 	case EXPR_PRIMARY:
+		/* every referenced typecode is in the lookup tables by now */
+		insn.op = INSN_CMP;
+		insn.cmp = e->primary;
+		if (now)
+			insn.cmp.lookup = ctx_state_add(ctx, e->primary.lookup);
+		else
+			insn.cmp.lookup = ctx_state_lookup(ctx,
+					e->primary.lookup);
+		if (insn.cmp.lookup == -1)
+			return -1;
+		break;
 	case EXPR_CINFO:
-		return expr_cmp(&e->cinfo, ctx_value(ctx, e->cinfo.lookup));
+		insn.op = INSN_CMP;
+		insn.cmp = e->cinfo;
+		break;
 	}
 
+	if (now)
+		return ctx_link(ctx, &insn, *now);
+
+	return ctx_emit(ctx, &insn);
+}
+
+static void ctx_insn_user(struct context *ctx, unsigned int i,
+		unsigned int user)
+{
+	struct insn *in = &ctx->insns[i];
+
+	if (ctx->users)
+		ctx->users[in->users + in->nusers] = user;
+	++in->nusers;
+}
+
+static void ctx_insn_operands(struct context *ctx, unsigned int i)
+{
+	struct insn *in = &ctx->insns[i];
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		ctx_insn_user(ctx, in->binop.left, i);
+		ctx_insn_user(ctx, in->binop.right, i);
+		break;
+	case INSN_NOT:
+		ctx_insn_user(ctx, in->not, i);
+		break;
+	case INSN_DUR:
+		ctx_insn_user(ctx, in->dur.expr, i);
+		break;
+	case INSN_CMP:
+		break;
+	}
+}
+
+static int ctx_init_users(struct context *ctx)
+{
+	unsigned int nusers = 0;
+
+	/* count, lay out, then fill */
+	for (unsigned int i = 0; i < ctx->ninsns; ++i)
+		ctx_insn_operands(ctx, i);
+	for (unsigned int i = 0; i < ctx->nbindings; ++i)
+		ctx_insn_user(ctx, ctx->bindv[i]->root, INSN_USER_BINDING | i);
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		ctx->insns[i].users = nusers;
+		nusers += ctx->insns[i].nusers;
+		ctx->insns[i].nusers = 0;
+	}
+
+	ctx->users = calloc(nusers + 1, sizeof(*ctx->users));
+	if (ctx->users == NULL)
+		return -1;
+	ctx->nusers = nusers;
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i)
+		ctx_insn_operands(ctx, i);
+	for (unsigned int i = 0; i < ctx->nbindings; ++i)
+		ctx_insn_user(ctx, ctx->bindv[i]->root, INSN_USER_BINDING | i);
+
 	return 0;
 }
 
-static int ctx_pollwait(struct context *ctx, u64 now)
+static int ctx_init_listeners(struct context *ctx)
 {
-	unsigned int wait = -1;
+	unsigned int nlisteners = 0;
+
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		ctx->states[i].listeners = nlisteners;
+		nlisteners += ctx->states[i].nlisteners;
+		ctx->states[i].nlisteners = 0;
+	}
+
+	ctx->listeners = calloc(nlisteners + 1, sizeof(*ctx->listeners));
+	if (ctx->listeners == NULL)
+		return -1;
+	ctx->nlisteners = nlisteners;
 
-	for (unsigned int i = 0; i < ctx->ndurations; ++i) {
-		struct expr *e = ctx->durations[i];
-		unsigned int left;
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		struct evstate *evs;
 
-		if (e == NULL)
+		if (ctx->insns[i].op != INSN_CMP)
 			continue;
 
-		if (e->dur.end <= now)
-			return 0;
+		evs = &ctx->states[ctx->insns[i].cmp.lookup];
+		ctx->listeners[evs->listeners + evs->nlisteners++] = i;
+	}
 
-		left = e->dur.end - now;
-		if (left < wait)
-			wait = left;
+	return 0;
+}
+
+static int ctx_init_lookup(struct context *ctx)
+{
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		unsigned int type = ctx->states[i].typecode >> 16;
+		unsigned int code = ctx->states[i].typecode & 0xffff;
+
+		if (type < CTX_LOOKUPS && code >= ctx->nlookup[type])
+			ctx->nlookup[type] = code + 1;
+	}
+
+	for (unsigned int type = 0; type < CTX_LOOKUPS; ++type) {
+		unsigned int n = ctx->nlookup[type];
+
+		if (n == 0)
+			continue;
+
+		ctx->lookup[type] = malloc(n * sizeof(*ctx->lookup[type]));
+		if (ctx->lookup[type] == NULL)
+			return -1;
+		memset(ctx->lookup[type], 0xff, n * sizeof(*ctx->lookup[type]));
+	}
+
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		unsigned int type = ctx->states[i].typecode >> 16;
+		unsigned int code = ctx->states[i].typecode & 0xffff;
+
+		if (type >= CTX_LOOKUPS)
+			continue;
+
+		/* unique, though unsorted once ctx_bind() adds states */
+		if (ctx->lookup[type][code] != 0xffff)
+			return -1;
+		ctx->lookup[type][code] = i;
 	}
 
-	return wait;
+	return 0;
 }
 
-static void ctx_binding_eval(struct context *ctx, struct binding *b,
-		int (*run)(const char *command), u64 now)
+static int ctx_init_runtime(struct context *ctx)
 {
-	int rc;
+	unsigned int ndurations = 0;
 
-	rc = ctx_expr_eval(ctx, b->expr, now);
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		if (ctx->insns[i].op == INSN_DUR)
+			++ndurations;
+	}
 
-	if (rc == b->state)
-		return;
+	ctx->values = calloc(ctx->nstates + 1, sizeof(*ctx->values));
+	ctx->results = calloc(ctx->ninsns + 1, sizeof(*ctx->results));
+	ctx->queued = calloc(ctx->ninsns + 1, sizeof(*ctx->queued));
+	ctx->dirty = calloc(ctx->ninsns + 1, sizeof(*ctx->dirty));
+	ctx->durations = calloc(ndurations + 1, sizeof(*ctx->durations));
+	if (ctx->values == NULL || ctx->results == NULL || ctx->queued == NULL ||
+			ctx->dirty == NULL || ctx->durations == NULL)
+		return -1;
 
-	if (rc)
-		run(b->command);
-	b->state = rc;
+	return 0;
 }
 
-int ctx_timeout(struct context *ctx, int (*run)(const char *command), u64 now)
+int ctx_init(struct context *ctx, struct binding *bindings,
+		unsigned int flags)
 {
-	for (struct binding *b = ctx->bindings; b; b = b->next)
-		ctx_binding_eval(ctx, b, run, now);
+	struct insn *insns;
 
-	return ctx_pollwait(ctx, now);
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->flags = flags;
+	ctx->bindings = bindings;
+
+	for (struct binding *b = bindings; b; b = b->next) {
+		if (ctx_init_expr_pass1(ctx, b->expr))
+			goto err;
+		++ctx->nbindings;
+	}
+
+	free(ctx->hash);
+	ctx->hash = NULL;
+
+	qsort(ctx->states, ctx->nstates, sizeof(*ctx->states), ctx_state_cmp);
+
+	if (ctx_init_lookup(ctx))
+		goto err;
+
+	/* ninsns is an upper bound until identical nodes are merged */
+	for (ctx->nhash = 1; ctx->nhash < ctx->ninsns * 2; ctx->nhash <<= 1)
+		;
+	ctx->hash = malloc(ctx->nhash * sizeof(*ctx->hash));
+	ctx->bindv = calloc(ctx->nbindings + 1, sizeof(*ctx->bindv));
+	ctx->insns = calloc(ctx->ninsns + 1, sizeof(*ctx->insns));
+	if (ctx->hash == NULL || ctx->bindv == NULL || ctx->insns == NULL)
+		goto err;
+	memset(ctx->hash, 0xff, ctx->nhash * sizeof(*ctx->hash));
+	ctx->ninsns = 0;
+	ctx->nbindings = 0;
+
+	for (struct binding *b = bindings; b; b = b->next) {
+		b->root = ctx_compile(ctx, b->expr, NULL);
+		if (b->root == -1)
+			goto err;
+		ctx->bindv[ctx->nbindings++] = b;
+	}
+
+	free(ctx->hash);
+	ctx->hash = NULL;
+
+	/* only shrinking, so the larger array will do if this fails */
+	insns = realloc(ctx->insns, (ctx->ninsns + 1) * sizeof(*ctx->insns));
+	if (insns)
+		ctx->insns = insns;
+
+	if (ctx_init_users(ctx))
+		goto err;
+
+	if (ctx_init_listeners(ctx))
+		goto err;
+
+	if (ctx_init_runtime(ctx))
+		goto err;
+
+	return 0;
+
+err:
+	ctx_free(ctx);
+	return -1;
 }
 
-int ctx_input_event(struct context *ctx,
-		int (*run)(const char *command),
-		unsigned int typecode, int value, u64 now)
+static int ctx_image_check(const struct ctx_image *img)
 {
-	unsigned int h = ctx->nstates;
-	unsigned int l = 0;
-	struct evstate *e;
+	for (unsigned int i = 0; i < img->nstates; ++i) {
+		const struct evstate *evs = &img->states[i];
 
-	while (l < h) {
-		unsigned int m = l + ((h - l) >> 1);
-		int c;
+		if ((evs->typecode >> 16) >= CTX_LOOKUPS ||
+				evs->listeners > img->nlisteners ||
+				evs->nlisteners > img->nlisteners - evs->listeners)
+			return -1;
+	}
+
+	for (unsigned int i = 0; i < img->nlisteners; ++i) {
+		if (img->listeners[i] >= img->ninsns)
+			return -1;
+	}
 
-		e = &ctx->states[m];
-		c = typecode - e->typecode;
+	for (unsigned int i = 0; i < img->ninsns; ++i) {
+		const struct insn *in = &img->insns[i];
 
-		if (c < 0)
-			h = m;
-		else if (c > 0)
-			l = m + 1;
-		else
+		if (in->users > img->nusers ||
+				in->nusers > img->nusers - in->users)
+			return -1;
+
+		switch (in->op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			if (in->binop.left >= i || in->binop.right >= i)
+				return -1;
+			break;
+		case INSN_NOT:
+			if (in->not >= i)
+				return -1;
+			break;
+		case INSN_DUR:
+			if (in->dur.expr >= i)
+				return -1;
+			break;
+		case INSN_CMP:
+			if (in->cmp.lookup >= img->nstates)
+				return -1;
 			break;
+		default:
+			return -1;
+		}
 	}
 
+	for (unsigned int i = 0; i < img->nusers; ++i) {
+		unsigned int user = img->users[i];
 
-	if (l >= h || e->value == value)
-		return ctx_pollwait(ctx, now);
+		if (user & INSN_USER_BINDING) {
+			if ((user & ~INSN_USER_BINDING) >= img->nbindings)
+				return -1;
+		} else if (user >= img->ninsns) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void *ctx_dup(const void *p, size_t n, size_t size)
+{
+	void *d;
+
+	d = malloc(n * size + 1);
+	if (d)
+		memcpy(d, p, n * size);
+
+	return d;
+}
 
-	e->value = value;
-	for (unsigned int i = 0; i < e->nlisteners; ++i) {
-		struct binding *b = e->listeners[i];
+int ctx_load(struct context *ctx, const struct ctx_image *img,
+		struct binding *bindings, unsigned int flags)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->flags = flags;
+	ctx->bindings = bindings;
+
+	if (ctx_image_check(img))
+		return -1;
+
+	ctx->nstates = img->nstates;
+	ctx->nlisteners = img->nlisteners;
+	ctx->ninsns = img->ninsns;
+	ctx->nusers = img->nusers;
+
+	ctx->states = ctx_dup(img->states, img->nstates, sizeof(*img->states));
+	ctx->listeners = ctx_dup(img->listeners, img->nlisteners,
+			sizeof(*img->listeners));
+	ctx->insns = ctx_dup(img->insns, img->ninsns, sizeof(*img->insns));
+	ctx->users = ctx_dup(img->users, img->nusers, sizeof(*img->users));
+	ctx->bindv = calloc(img->nbindings + 1, sizeof(*ctx->bindv));
+	if (ctx->states == NULL || ctx->listeners == NULL ||
+			ctx->insns == NULL || ctx->users == NULL ||
+			ctx->bindv == NULL)
+		goto err;
+
+	for (struct binding *b = bindings; b; b = b->next) {
+		if (ctx->nbindings == img->nbindings || b->root >= img->ninsns)
+			goto err;
+		ctx->bindv[ctx->nbindings++] = b;
+	}
+	if (ctx->nbindings != img->nbindings)
+		goto err;
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		if (ctx->insns[i].op == INSN_DUR) {
+			ctx->insns[i].dur.slot = -1;
+			ctx->insns[i].dur.end = 0;
+		}
+	}
+
+	if (ctx_init_lookup(ctx))
+		goto err;
+
+	if (ctx_init_runtime(ctx))
+		goto err;
+
+	return 0;
+
+err:
+	ctx_free(ctx);
+	return -1;
+}
+
+/*
+ * The evaluation generated for src, for the bindings keep is set for, as
+ * renumbered in bmap: one allocation, with the lists cut down to them.
+ */
+static int ctx_subset_gen(struct context *ctx, struct context *src,
+		const unsigned int *bmap)
+{
+	const struct ctx_gen *sgen = src->gen;
+	unsigned int nkeys = src->nstates + src->ninsns;
+	unsigned int nb = ctx->nbindings;
+	int (**eval)(struct context *ctx, u64 now);
+	unsigned int *offsets;
+	unsigned int *lists;
+	struct ctx_gen *gen;
+	unsigned int nlists = 0;
+	char *p;
+
+	for (unsigned int key = 0; key < nkeys; ++key) {
+		unsigned int off = key < src->nstates ? sgen->states[key] :
+			sgen->durations[key - src->nstates];
+
+		for (const unsigned int *b = &sgen->lists[off]; *b != -1; ++b)
+			nlists += bmap[*b] != -1;
+		++nlists;
+	}
+
+	p = malloc(sizeof(*gen) + (nb + 1) * sizeof(*eval) +
+			(nlists + nkeys + nb + 3) * sizeof(*lists) + nb + 1);
+	if (p == NULL)
+		return -1;
+
+	gen = (struct ctx_gen *)p;
+	eval = (void *)(gen + 1);
+	lists = (unsigned int *)(eval + nb + 1);
+	offsets = lists + nlists + 1;
+	memset(gen, 0, sizeof(*gen));
+	gen->pending = offsets + nkeys + 1;
+	gen->marked = (unsigned char *)(gen->pending + nb + 1);
+	memset(gen->marked, 0, nb + 1);
+
+	for (unsigned int b = 0; b < src->nbindings; ++b) {
+		if (bmap[b] != -1)
+			eval[bmap[b]] = sgen->eval[b];
+	}
+
+	nlists = 0;
+	for (unsigned int key = 0; key < nkeys; ++key) {
+		unsigned int off = key < src->nstates ? sgen->states[key] :
+			sgen->durations[key - src->nstates];
+
+		offsets[key] = nlists;
+		for (const unsigned int *b = &sgen->lists[off]; *b != -1; ++b) {
+			if (bmap[*b] != -1)
+				lists[nlists++] = bmap[*b];
+		}
+		lists[nlists++] = -1;
+	}
+
+	gen->eval = eval;
+	gen->lists = lists;
+	gen->states = offsets;
+	gen->durations = offsets + src->nstates;
+	ctx->gen = gen;
 
-		ctx_binding_eval(ctx, b, run, now);
+	return 0;
+}
+
+/*
+ * Set ctx up with the bindings of src keep is set for, as indexed in
+ * src->bindv, or with all of them if keep is NULL, and only what they
+ * need of src.  A binding holds the state of its context, so ctx gets
+ * copies of its own, see CTX_COPIES.  Nothing is evaluated yet, as after
+ * ctx_init(), and the evaluation generated for src, if any, is kept.
+ */
+int ctx_subset(struct context *ctx, struct context *src,
+		const unsigned char *keep)
+{
+	struct binding **pb = &ctx->bindings;
+	unsigned int *bmap;
+	unsigned int *imap;
+	unsigned int *smap;
+	int rc = -1;
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->flags = src->flags | CTX_COPIES;
+
+	bmap = malloc((src->nbindings + 1) * sizeof(*bmap));
+	imap = calloc(src->ninsns + 1, sizeof(*imap));
+	smap = calloc(src->nstates + 1, sizeof(*smap));
+	ctx->bindv = calloc(src->nbindings + 1, sizeof(*ctx->bindv));
+	if (bmap == NULL || imap == NULL || smap == NULL || ctx->bindv == NULL)
+		goto out;
+
+	/* generated code indexes everything as in src */
+	for (unsigned int i = 0; src->gen && i < src->ninsns; ++i)
+		imap[i] = 1;
+	for (unsigned int i = 0; src->gen && i < src->nstates; ++i)
+		smap[i] = 1;
+
+	for (unsigned int b = 0; b < src->nbindings; ++b) {
+		if (keep == NULL || keep[b])
+			imap[src->bindv[b]->root] = 1;
+	}
+
+	/* users follow their operands, so one pass down finds them all */
+	for (unsigned int i = src->ninsns; i-- > 0; ) {
+		const struct insn *in = &src->insns[i];
+
+		if (!imap[i])
+			continue;
+
+		switch (in->op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			imap[in->binop.left] = 1;
+			imap[in->binop.right] = 1;
+			break;
+		case INSN_NOT:
+			imap[in->not] = 1;
+			break;
+		case INSN_DUR:
+			imap[in->dur.expr] = 1;
+			break;
+		case INSN_CMP:
+			smap[in->cmp.lookup] = 1;
+			break;
+		}
+	}
+
+	for (unsigned int i = 0; i < src->ninsns; ++i)
+		imap[i] = imap[i] ? ctx->ninsns++ : -1;
+	for (unsigned int i = 0; i < src->nstates; ++i)
+		smap[i] = smap[i] ? ctx->nstates++ : -1;
+
+	ctx->states = calloc(ctx->nstates + 1, sizeof(*ctx->states));
+	ctx->insns = calloc(ctx->ninsns + 1, sizeof(*ctx->insns));
+	if (ctx->states == NULL || ctx->insns == NULL)
+		goto out;
+
+	for (unsigned int i = 0; i < src->nstates; ++i) {
+		if (smap[i] != -1)
+			ctx->states[smap[i]].typecode = src->states[i].typecode;
 	}
 
+	for (unsigned int i = 0; i < src->ninsns; ++i) {
+		struct insn *in;
+
+		if (imap[i] == -1)
+			continue;
+
+		in = &ctx->insns[imap[i]];
+		*in = src->insns[i];
+		in->users = 0;
+		in->nusers = 0;
+
+		switch (in->op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			in->binop.left = imap[in->binop.left];
+			in->binop.right = imap[in->binop.right];
+			break;
+		case INSN_NOT:
+			in->not = imap[in->not];
+			break;
+		case INSN_DUR:
+			in->dur.expr = imap[in->dur.expr];
+			in->dur.slot = -1;
+			in->dur.end = 0;
+			break;
+		case INSN_CMP:
+			in->cmp.lookup = smap[in->cmp.lookup];
+			++ctx->states[in->cmp.lookup].nlisteners;
+			break;
+		}
+	}
+
+	for (unsigned int b = 0; b < src->nbindings; ++b) {
+		const struct binding *sb = src->bindv[b];
+		size_t len = strlen(sb->command);
+		struct binding *copy;
+
+		bmap[b] = -1;
+		if (keep && !keep[b])
+			continue;
+
+		copy = calloc(1, sizeof(*copy) + len + 1);
+		if (copy == NULL)
+			goto out;
+		memcpy(copy->command, sb->command, len);
+		copy->root = imap[sb->root];
+		copy->origin = sb;
+
+		*pb = copy;
+		pb = &copy->next;
+		bmap[b] = ctx->nbindings;
+		ctx->bindv[ctx->nbindings++] = copy;
+	}
+
+	if (ctx_init_lookup(ctx) || ctx_init_users(ctx) ||
+			ctx_init_listeners(ctx) || ctx_init_runtime(ctx))
+		goto out;
+
+	if (src->gen && ctx_subset_gen(ctx, src, bmap))
+		goto out;
+
+	rc = 0;
+
+out:
+	if (rc)
+		ctx_free(ctx);
+	free(smap);
+	free(imap);
+	free(bmap);
+	return rc;
+}
+
+void ctx_free(struct context *ctx)
+{
+	for (unsigned int i = 0; (ctx->flags & CTX_COPIES) &&
+			i < ctx->nbindings; ++i)
+		free(ctx->bindv[i]);
+	free(ctx->durations);
+	free(ctx->users);
+	free(ctx->dirty);
+	free(ctx->queued);
+	free(ctx->results);
+	free(ctx->insns);
+	free(ctx->bindv);
+	free(ctx->hash);
+	for (unsigned int type = 0; type < CTX_LOOKUPS; ++type)
+		free(ctx->lookup[type]);
+	for (unsigned int i = 0; i < ctx->nframes; ++i) {
+		free(ctx->frames[i].values);
+		free(ctx->frames[i].states);
+	}
+	free(ctx->frames);
+	/* that of gen_static() itself is static */
+	if (ctx->flags & CTX_COPIES)
+		free(ctx->gen);
+	free(ctx->values);
+	free(ctx->listeners);
+	free(ctx->states);
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+static u64 ctx_dur_end(struct context *ctx, unsigned int slot)
+{
+	return ctx->insns[ctx->durations[slot]].dur.end;
+}
+
+static void ctx_dur_set(struct context *ctx, unsigned int slot,
+		unsigned int idx)
+{
+	ctx->durations[slot] = idx;
+	ctx->insns[idx].dur.slot = slot;
+}
+
+static void ctx_dur_sift(struct context *ctx, unsigned int slot)
+{
+	unsigned int idx = ctx->durations[slot];
+	u64 end = ctx->insns[idx].dur.end;
+
+	while (slot > 0) {
+		unsigned int parent = (slot - 1) / 2;
+
+		if (ctx_dur_end(ctx, parent) <= end)
+			break;
+
+		ctx_dur_set(ctx, slot, ctx->durations[parent]);
+		slot = parent;
+	}
+
+	for (;;) {
+		unsigned int child = slot * 2 + 1;
+
+		if (child >= ctx->ndurations)
+			break;
+
+		if (child + 1 < ctx->ndurations &&
+				ctx_dur_end(ctx, child + 1) < ctx_dur_end(ctx, child))
+			++child;
+
+		if (ctx_dur_end(ctx, child) >= end)
+			break;
+
+		ctx_dur_set(ctx, slot, ctx->durations[child]);
+		slot = child;
+	}
+
+	ctx_dur_set(ctx, slot, idx);
+}
+
+static void ctx_dur_add(struct context *ctx, unsigned int idx)
+{
+	ctx_dur_set(ctx, ctx->ndurations++, idx);
+	ctx_dur_sift(ctx, ctx->ndurations - 1);
+}
+
+static void ctx_dur_remove(struct context *ctx, unsigned int idx)
+{
+	unsigned int slot = ctx->insns[idx].dur.slot;
+
+	if (slot == -1)
+		return;
+
+	ctx->insns[idx].dur.slot = -1;
+
+	if (slot != --ctx->ndurations) {
+		ctx_dur_set(ctx, slot, ctx->durations[ctx->ndurations]);
+		ctx_dur_sift(ctx, slot);
+	}
+}
+
+static void ctx_dirty_push(struct context *ctx, unsigned int idx)
+{
+	unsigned int slot;
+
+	if (ctx->queued[idx])
+		return;
+	ctx->queued[idx] = 1;
+
+	for (slot = ctx->ndirty++; slot > 0; slot = (slot - 1) / 2) {
+		unsigned int parent = (slot - 1) / 2;
+
+		if (ctx->dirty[parent] < idx)
+			break;
+		ctx->dirty[slot] = ctx->dirty[parent];
+	}
+	ctx->dirty[slot] = idx;
+}
+
+static unsigned int ctx_dirty_pop(struct context *ctx)
+{
+	unsigned int idx = ctx->dirty[0];
+	unsigned int last = ctx->dirty[--ctx->ndirty];
+	unsigned int slot = 0;
+
+	for (;;) {
+		unsigned int child = slot * 2 + 1;
+
+		if (child >= ctx->ndirty)
+			break;
+		if (child + 1 < ctx->ndirty &&
+				ctx->dirty[child + 1] < ctx->dirty[child])
+			++child;
+		if (ctx->dirty[child] >= last)
+			break;
+
+		ctx->dirty[slot] = ctx->dirty[child];
+		slot = child;
+	}
+	ctx->dirty[slot] = last;
+
+	ctx->queued[idx] = 0;
+
+	return idx;
+}
+
+/*
+ * INSN_DUR i, arming or disarming its timer as its operand comes and
+ * goes; evaluating it again with nothing changed does no harm.
+ */
+int ctx_dur_eval(struct context *ctx, unsigned int i, u64 now)
+{
+	struct insn *in = &ctx->insns[i];
+
+	if (!ctx->results[in->dur.expr]) {
+		ctx_dur_remove(ctx, i);
+		in->dur.end = 0;
+		return 0;
+	}
+	if (in->dur.end == 0) {
+		in->dur.end = now + in->dur.duration;
+		ctx_dur_add(ctx, i);
+	} else if (now >= in->dur.end) {
+		ctx_dur_remove(ctx, i);
+		return 1;
+	}
+	return 0;
+}
+
+static int ctx_insn_eval(struct context *ctx, unsigned int i, u64 now)
+{
+	struct insn *in = &ctx->insns[i];
+	unsigned char *r = ctx->results;
+
+	switch (in->op) {
+	case INSN_OR:
+		return r[in->binop.left] | r[in->binop.right];
+	case INSN_XOR:
+		return r[in->binop.left] ^ r[in->binop.right];
+	case INSN_AND:
+		return r[in->binop.left] & r[in->binop.right];
+	case INSN_NOT:
+		return !r[in->not];
+	case INSN_DUR:
+		return ctx_dur_eval(ctx, i, now);
+	case INSN_CMP:
+		return expr_cmp(&in->cmp, ctx->values[in->cmp.lookup]);
+	}
+
+	return 0;
+}
+
+static void ctx_binding_update(struct context *ctx, struct binding *b,
+		int rc, int (*run)(struct context *ctx, struct binding *b))
+{
+	if (rc == b->state)
+		return;
+
+	if (rc)
+		run(ctx, b);
+	b->state = rc;
+}
+
+static void ctx_insn_changed(struct context *ctx, unsigned int i,
+		int (*run)(struct context *ctx, struct binding *b))
+{
+	struct insn *in = &ctx->insns[i];
+
+	for (unsigned int u = 0; u < in->nusers; ++u) {
+		unsigned int user = ctx->users[in->users + u];
+
+		if (user & INSN_USER_BINDING) {
+			ctx_binding_update(ctx,
+					ctx->bindv[user & ~INSN_USER_BINDING],
+					ctx->results[i], run);
+		} else {
+			ctx_dirty_push(ctx, user);
+		}
+	}
+}
+
+static void ctx_gen_mark(struct context *ctx, unsigned int list)
+{
+	struct ctx_gen *gen = ctx->gen;
+
+	for (const unsigned int *b = &gen->lists[list]; *b != -1; ++b) {
+		if (gen->marked[*b])
+			continue;
+		gen->marked[*b] = 1;
+		gen->pending[gen->npending++] = *b;
+	}
+}
+
+/*
+ * Re-evaluate queued instructions in index (and thus dependency) order,
+ * only queueing users of those whose value actually changed.  Generated
+ * contexts instead evaluate each marked binding straight through.
+ */
+static void ctx_propagate(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b), u64 now)
+{
+	struct ctx_gen *gen = ctx->gen;
+
+	if (gen) {
+		for (unsigned int i = 0; i < gen->npending; ++i) {
+			unsigned int b = gen->pending[i];
+
+			gen->marked[b] = 0;
+			ctx_binding_update(ctx, ctx->bindv[b],
+					gen->eval[b](ctx, now), run);
+		}
+		gen->npending = 0;
+		return;
+	}
+
+	while (ctx->ndirty > 0) {
+		unsigned int i = ctx_dirty_pop(ctx);
+		int rc;
+
+		rc = ctx_insn_eval(ctx, i, now);
+		if (rc == ctx->results[i])
+			continue;
+
+		ctx->results[i] = rc;
+		ctx_insn_changed(ctx, i, run);
+	}
+}
+
+static void ctx_state_changed(struct context *ctx, unsigned int idx)
+{
+	struct evstate *e = &ctx->states[idx];
+
+	if (ctx->gen) {
+		ctx_gen_mark(ctx, ctx->gen->states[idx]);
+		return;
+	}
+
+	for (unsigned int i = 0; i < e->nlisteners; ++i)
+		ctx_dirty_push(ctx, ctx->listeners[e->listeners + i]);
+}
+
+static void ctx_dur_expire(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b), u64 now)
+{
+	while (ctx->ndurations > 0 && ctx_dur_end(ctx, 0) <= now) {
+		unsigned int i = ctx->durations[0];
+
+		ctx_dur_remove(ctx, i);
+		if (ctx->gen)
+			ctx_gen_mark(ctx, ctx->gen->durations[i]);
+		else
+			ctx_dirty_push(ctx, i);
+	}
+
+	ctx_propagate(ctx, run, now);
+}
+
+static int ctx_pollwait(struct context *ctx, u64 now)
+{
+	u64 end;
+
+	if (ctx->ndurations == 0)
+		return -1;
+
+	end = ctx_dur_end(ctx, 0);
+	if (end <= now)
+		return 0;
+
+	return end - now;
+}
+
+int ctx_eval(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b), u64 now)
+{
+	if (ctx->gen) {
+		for (unsigned int i = 0; i < ctx->nbindings; ++i)
+			ctx_binding_update(ctx, ctx->bindv[i],
+					ctx->gen->eval[i](ctx, now), run);
+		return ctx_pollwait(ctx, now);
+	}
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i)
+		ctx->results[i] = ctx_insn_eval(ctx, i, now);
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i) {
+		struct binding *b = ctx->bindv[i];
+
+		ctx_binding_update(ctx, b, ctx->results[b->root], run);
+	}
+
+	return ctx_pollwait(ctx, now);
+}
+
+/* find the instruction of old matching insn, or -1 */
+static unsigned int ctx_adopt_find(struct context *old, struct insn *insn,
+		const unsigned int *hash, unsigned int mask)
+{
+	unsigned int h = ctx_insn_hash(insn) & mask;
+
+	while (hash[h] != -1) {
+		if (ctx_insn_equal(&old->insns[hash[h]], insn))
+			return hash[h];
+		h = (h + 1) & mask;
+	}
+
+	return -1;
+}
+
+/*
+ * Take over the runtime state of old, a context compiled from an earlier
+ * configuration: values of common states, and the results and running
+ * timers of instructions present in both.  Everything else is evaluated
+ * afresh.  Bindings are latched to their current result, so the switch
+ * itself runs no commands.
+ */
+int ctx_adopt(struct context *ctx, struct context *old, u64 now)
+{
+	unsigned int *smap;
+	unsigned int *imap;
+	unsigned int *hash;
+	unsigned int nhash;
+	int rc = -1;
+
+	for (nhash = 1; nhash < old->ninsns * 2; nhash <<= 1)
+		;
+
+	smap = malloc((ctx->nstates + 1) * sizeof(*smap));
+	imap = malloc((ctx->ninsns + 1) * sizeof(*imap));
+	hash = malloc(nhash * sizeof(*hash));
+	if (smap == NULL || imap == NULL || hash == NULL)
+		goto out;
+	memset(hash, 0xff, nhash * sizeof(*hash));
+
+	for (unsigned int i = 0; i < old->ninsns; ++i) {
+		unsigned int h = ctx_insn_hash(&old->insns[i]) & (nhash - 1);
+
+		if (old->insns[i].users == INSN_DEAD)
+			continue;
+		while (hash[h] != -1)
+			h = (h + 1) & (nhash - 1);
+		hash[h] = i;
+	}
+
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		unsigned int o = ctx_state_lookup(old, ctx->states[i].typecode);
+
+		smap[i] = o;
+		if (o == -1)
+			continue;
+
+		ctx->values[i] = old->values[o];
+	}
+
+	/* frames still in progress carry over, for states still tracked */
+	for (unsigned int s = 0; s < old->nframes; ++s) {
+		struct ctx_frame *f = &old->frames[s];
+
+		for (unsigned int j = 0; j < f->nstates; ++j) {
+			unsigned int i = ctx_state_lookup(ctx,
+					old->states[f->states[j]].typecode);
+
+			if (i != -1 &&
+					ctx_frame_add(ctx, s, i, f->values[j]))
+				goto out;
+		}
+	}
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		struct insn *in = &ctx->insns[i];
+		struct insn t = *in;
+		unsigned int o = -1;
+
+		if (in->users == INSN_DEAD) {
+			imap[i] = -1;
+			continue;
+		}
+
+		/* rewrite operands in terms of old, if it has them all */
+		switch (t.op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND: {
+			unsigned int l = imap[in->binop.left];
+			unsigned int r = imap[in->binop.right];
+
+			if (l == -1 || r == -1)
+				break;
+			t.binop.left = l < r ? l : r;
+			t.binop.right = l < r ? r : l;
+			o = ctx_adopt_find(old, &t, hash, nhash - 1);
+			} break;
+		case INSN_NOT:
+			t.not = imap[in->not];
+			if (t.not != -1)
+				o = ctx_adopt_find(old, &t, hash, nhash - 1);
+			break;
+		case INSN_DUR:
+			t.dur.expr = imap[in->dur.expr];
+			if (t.dur.expr != -1)
+				o = ctx_adopt_find(old, &t, hash, nhash - 1);
+			break;
+		case INSN_CMP:
+			t.cmp.lookup = smap[in->cmp.lookup];
+			if (t.cmp.lookup != -1)
+				o = ctx_adopt_find(old, &t, hash, nhash - 1);
+			break;
+		}
+
+		imap[i] = o;
+		if (o == -1) {
+			ctx->results[i] = ctx_insn_eval(ctx, i, now);
+			continue;
+		}
+
+		ctx->results[i] = old->results[o];
+		if (in->op == INSN_DUR) {
+			/* ctx_bind() may have armed it already */
+			ctx_dur_remove(ctx, i);
+			in->dur.end = old->insns[o].dur.end;
+			if (old->insns[o].dur.slot != -1)
+				ctx_dur_add(ctx, i);
+		}
+	}
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i) {
+		struct binding *b = ctx->bindv[i];
+
+		b->state = ctx->results[b->root];
+	}
+
+	rc = 0;
+
+out:
+	free(hash);
+	free(imap);
+	free(smap);
+	return rc;
+}
+
+/*
+ * Adding and removing bindings in a live context.  The arrays are grown
+ * geometrically; users and listeners segments that cannot grow in place
+ * are moved to the end of their array, and instructions nothing uses any
+ * more are marked INSN_DEAD, to be revived if an identical one is needed
+ * again.  ctx_compact() squeezes the garbage out once it adds up.
+ */
+static int ctx_realloc(void *pp, unsigned int n, unsigned int max,
+		size_t size)
+{
+	void **p = pp;
+	void *np;
+
+	np = realloc(*p, (size_t)max * size + 1);
+	if (np == NULL)
+		return -1;
+	memset((char *)np + (size_t)n * size, 0, (size_t)(max - n) * size);
+	*p = np;
+
+	return 0;
+}
+
+static unsigned int ctx_grow_size(unsigned int n, unsigned int max)
+{
+	/* arrays of contexts from ctx_init() or ctx_load() are exact fits */
+	if (max < n)
+		max = n;
+	if (n < max)
+		return 0;
+
+	return max < 8 ? 16 : max * 2;
+}
+
+static int ctx_grow_insns(struct context *ctx)
+{
+	unsigned int max = ctx_grow_size(ctx->ninsns, ctx->maxinsns);
+	unsigned int n = ctx->ninsns;
+
+	if (max == 0)
+		return 0;
+
+	/* every instruction may end up queued, or an armed timer */
+	if (ctx_realloc(&ctx->insns, n, max, sizeof(*ctx->insns)) ||
+			ctx_realloc(&ctx->results, n, max,
+				sizeof(*ctx->results)) ||
+			ctx_realloc(&ctx->queued, n, max,
+				sizeof(*ctx->queued)) ||
+			ctx_realloc(&ctx->dirty, ctx->ndirty, max,
+				sizeof(*ctx->dirty)) ||
+			ctx_realloc(&ctx->durations, ctx->ndurations, max,
+				sizeof(*ctx->durations)))
+		return -1;
+	ctx->maxinsns = max;
+
+	return 0;
+}
+
+static int ctx_grow_states(struct context *ctx)
+{
+	unsigned int max = ctx_grow_size(ctx->nstates, ctx->maxstates);
+	unsigned int n = ctx->nstates;
+
+	if (max == 0)
+		return 0;
+
+	if (ctx_realloc(&ctx->states, n, max, sizeof(*ctx->states)) ||
+			ctx_realloc(&ctx->values, n, max,
+				sizeof(*ctx->values)))
+		return -1;
+	ctx->maxstates = max;
+
+	return 0;
+}
+
+static int ctx_grow_lookup(struct context *ctx, unsigned int type,
+		unsigned int code)
+{
+	unsigned short *lookup;
+	unsigned int n = ctx->nlookup[type];
+
+	if (code < n)
+		return 0;
+
+	lookup = realloc(ctx->lookup[type], (code + 1) * sizeof(*lookup));
+	if (lookup == NULL)
+		return -1;
+	memset(&lookup[n], 0xff, (code + 1 - n) * sizeof(*lookup));
+	ctx->lookup[type] = lookup;
+	ctx->nlookup[type] = code + 1;
+
+	return 0;
+}
+
+/* returns the index of the state tracking typecode, added if need be */
+static unsigned int ctx_state_add(struct context *ctx, unsigned int typecode)
+{
+	unsigned int type = typecode >> 16;
+	unsigned int code = typecode & 0xffff;
+	unsigned int idx;
+
+	idx = ctx_state_lookup(ctx, typecode);
+	if (idx != -1)
+		return idx;
+
+	if (type >= CTX_LOOKUPS || ctx->nstates >= 0xfffe ||
+			ctx_grow_lookup(ctx, type, code) ||
+			ctx_grow_states(ctx))
+		return -1;
+
+	idx = ctx->nstates++;
+	memset(&ctx->states[idx], 0, sizeof(ctx->states[idx]));
+	ctx->states[idx].typecode = typecode;
+	ctx->states[idx].listeners = ctx->nlisteners;
+	ctx->values[idx] = 0;
+	ctx->lookup[type][code] = idx;
+
+	return idx;
+}
+
+/*
+ * Make sure every state e reads is tracked, so that their values can be
+ * queried from the devices before ctx_bind() first evaluates e.
+ */
+int ctx_add_states(struct context *ctx, struct expr *e)
+{
+	switch (e->type) {
+	case EXPR_OR:
+	case EXPR_XOR:
+	case EXPR_AND:
+		if (ctx_add_states(ctx, e->binop.left))
+			return -1;
+		return ctx_add_states(ctx, e->binop.right);
+	case EXPR_NOT:
+		return ctx_add_states(ctx, e->not);
+	case EXPR_DUR:
+		return ctx_add_states(ctx, e->dur.expr);
+	case EXPR_PRIMARY:
+		return ctx_state_add(ctx, e->primary.lookup) == -1 ? -1 : 0;
+	case EXPR_CINFO:
+		break;
+	}
+
+	return 0;
+}
+
+/*
+ * Append v to the segment [*off, *off + *n) of the array *arr, moving
+ * the segment to the end of the array unless it already is there.
+ */
+static int ctx_list_add(struct context *ctx, unsigned int **arr,
+		unsigned int *len, unsigned int *max,
+		unsigned int *off, unsigned int *n, unsigned int v)
+{
+	unsigned int need = *len + 1;
+
+	if (*off + *n != *len)
+		need += *n;
+
+	if (need > *max || *max == 0) {
+		unsigned int nmax = *max > *len ? *max : *len;
+
+		while (nmax < need)
+			nmax = nmax < 8 ? 16 : nmax * 2;
+		if (ctx_realloc(arr, *len, nmax, sizeof(**arr)))
+			return -1;
+		*max = nmax;
+	}
+
+	if (*off + *n != *len) {
+		memmove(&(*arr)[*len], &(*arr)[*off], *n * sizeof(**arr));
+		ctx->nwaste += *n;
+		*off = *len;
+		*len += *n;
+	}
+
+	(*arr)[(*len)++] = v;
+	++*n;
+
+	return 0;
+}
+
+static void ctx_list_remove(struct context *ctx, unsigned int *arr,
+		unsigned int off, unsigned int *n, unsigned int v)
+{
+	for (unsigned int i = 0; i < *n; ++i) {
+		if (arr[off + i] != v)
+			continue;
+
+		arr[off + i] = arr[off + --*n];
+		++ctx->nwaste;
+		return;
+	}
+}
+
+static int ctx_user_add(struct context *ctx, unsigned int i,
+		unsigned int user)
+{
+	struct insn *in = &ctx->insns[i];
+
+	return ctx_list_add(ctx, &ctx->users, &ctx->nusers, &ctx->maxusers,
+			&in->users, &in->nusers, user);
+}
+
+static void ctx_user_remove(struct context *ctx, unsigned int i,
+		unsigned int user)
+{
+	struct insn *in = &ctx->insns[i];
+
+	ctx_list_remove(ctx, ctx->users, in->users, &in->nusers, user);
+}
+
+static int ctx_listener_add(struct context *ctx, unsigned int i)
+{
+	struct evstate *evs = &ctx->states[ctx->insns[i].cmp.lookup];
+
+	return ctx_list_add(ctx, &ctx->listeners, &ctx->nlisteners,
+			&ctx->maxlisteners, &evs->listeners,
+			&evs->nlisteners, i);
+}
+
+static void ctx_listener_remove(struct context *ctx, unsigned int i)
+{
+	struct evstate *evs = &ctx->states[ctx->insns[i].cmp.lookup];
+
+	ctx_list_remove(ctx, ctx->listeners, evs->listeners,
+			&evs->nlisteners, i);
+}
+
+/* (re)build the instruction hash, dead instructions included */
+static int ctx_rehash(struct context *ctx, unsigned int ninsns)
+{
+	unsigned int nhash;
+	unsigned int *hash;
+
+	for (nhash = 64; nhash < ninsns * 2; nhash <<= 1)
+		;
+
+	hash = malloc(nhash * sizeof(*hash));
+	if (hash == NULL)
+		return -1;
+	memset(hash, 0xff, nhash * sizeof(*hash));
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		unsigned int h = ctx_insn_hash(&ctx->insns[i]) & (nhash - 1);
+
+		while (hash[h] != -1)
+			h = (h + 1) & (nhash - 1);
+		hash[h] = i;
+	}
+
+	free(ctx->hash);
+	ctx->hash = hash;
+	ctx->nhash = nhash;
+
+	return 0;
+}
+
+static int ctx_insn_link_operands(struct context *ctx, unsigned int i)
+{
+	struct insn *in = &ctx->insns[i];
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		if (ctx_user_add(ctx, in->binop.left, i))
+			return -1;
+		return ctx_user_add(ctx, in->binop.right, i);
+	case INSN_NOT:
+		return ctx_user_add(ctx, in->not, i);
+	case INSN_DUR:
+		return ctx_user_add(ctx, in->dur.expr, i);
+	case INSN_CMP:
+		return ctx_listener_add(ctx, i);
+	}
+
+	return 0;
+}
+
+/*
+ * The live counterpart of ctx_emit(): returns a matching instruction,
+ * reviving or appending one if need be, with its result evaluated.
+ */
+static unsigned int ctx_link(struct context *ctx, struct insn *insn, u64 now)
+{
+	unsigned int mask;
+	unsigned int h;
+	unsigned int i;
+
+	if ((ctx->hash == NULL || (ctx->ninsns + 1) * 2 > ctx->nhash) &&
+			ctx_rehash(ctx, ctx->ninsns + 1))
+		return -1;
+
+	mask = ctx->nhash - 1;
+	h = ctx_insn_hash(insn) & mask;
+	while (ctx->hash[h] != -1) {
+		i = ctx->hash[h];
+		if (ctx_insn_equal(&ctx->insns[i], insn)) {
+			if (ctx->insns[i].users != INSN_DEAD)
+				return i;
+			--ctx->ndead;
+			goto link;
+		}
+		h = (h + 1) & mask;
+	}
+
+	if (ctx_grow_insns(ctx))
+		return -1;
+
+	i = ctx->ninsns++;
+	ctx->insns[i] = *insn;
+	ctx->hash[h] = i;
+
+link:
+	ctx->insns[i].users = ctx->nusers;
+	ctx->insns[i].nusers = 0;
+
+	/* left unused on failure, for ctx_bind() to release */
+	if (ctx_insn_link_operands(ctx, i))
+		return -1;
+
+	ctx->results[i] = ctx_insn_eval(ctx, i, now);
+
+	return i;
+}
+
+/* mark i dead once nothing uses it, releasing its operands in turn */
+static void ctx_release(struct context *ctx, unsigned int i)
+{
+	struct insn *in = &ctx->insns[i];
+
+	if (in->users == INSN_DEAD || in->nusers != 0)
+		return;
+
+	in->users = INSN_DEAD;
+	++ctx->ndead;
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		ctx_user_remove(ctx, in->binop.left, i);
+		ctx_user_remove(ctx, in->binop.right, i);
+		ctx_release(ctx, in->binop.left);
+		ctx_release(ctx, in->binop.right);
+		break;
+	case INSN_NOT:
+		ctx_user_remove(ctx, in->not, i);
+		ctx_release(ctx, in->not);
+		break;
+	case INSN_DUR:
+		ctx_dur_remove(ctx, i);
+		in->dur.end = 0;
+		ctx_user_remove(ctx, in->dur.expr, i);
+		ctx_release(ctx, in->dur.expr);
+		break;
+	case INSN_CMP:
+		ctx_listener_remove(ctx, i);
+		break;
+	}
+}
+
+/* drop the garbage left by ctx_bind() and ctx_unbind() */
+static void ctx_compact(struct context *ctx)
+{
+	unsigned int *listeners;
+	unsigned int *users;
+	unsigned int *map;
+	unsigned int nlisteners = 0;
+	unsigned int nusers = 0;
+	unsigned int n = 0;
+
+	map = malloc((ctx->ninsns + 1) * sizeof(*map));
+	users = malloc((ctx->nusers + 1) * sizeof(*users));
+	listeners = malloc((ctx->nlisteners + 1) * sizeof(*listeners));
+	if (map == NULL || users == NULL || listeners == NULL)
+		goto out;
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i)
+		map[i] = ctx->insns[i].users == INSN_DEAD ? -1 : n++;
+
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		struct evstate *evs = &ctx->states[i];
+
+		for (unsigned int l = 0; l < evs->nlisteners; ++l)
+			listeners[nlisteners + l] =
+				map[ctx->listeners[evs->listeners + l]];
+		evs->listeners = nlisteners;
+		nlisteners += evs->nlisteners;
+	}
+
+	/* operands precede users, so moving down never overwrites */
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		struct insn in = ctx->insns[i];
+
+		if (map[i] == -1)
+			continue;
+
+		for (unsigned int u = 0; u < in.nusers; ++u) {
+			unsigned int user = ctx->users[in.users + u];
+
+			if ((user & INSN_USER_BINDING) == 0)
+				user = map[user];
+			users[nusers + u] = user;
+		}
+		in.users = nusers;
+		nusers += in.nusers;
+
+		switch (in.op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			in.binop.left = map[in.binop.left];
+			in.binop.right = map[in.binop.right];
+			break;
+		case INSN_NOT:
+			in.not = map[in.not];
+			break;
+		case INSN_DUR:
+			in.dur.expr = map[in.dur.expr];
+			break;
+		case INSN_CMP:
+			break;
+		}
+
+		ctx->insns[map[i]] = in;
+		ctx->results[map[i]] = ctx->results[i];
+	}
+
+	for (unsigned int i = 0; i < ctx->ndurations; ++i)
+		ctx->durations[i] = map[ctx->durations[i]];
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i)
+		ctx->bindv[i]->root = map[ctx->bindv[i]->root];
+
+	free(ctx->users);
+	free(ctx->listeners);
+	ctx->users = users;
+	ctx->nusers = nusers;
+	ctx->maxusers = nusers;
+	ctx->listeners = listeners;
+	ctx->nlisteners = nlisteners;
+	ctx->maxlisteners = nlisteners;
+	ctx->ninsns = n;
+	ctx->ndead = 0;
+	ctx->nwaste = 0;
+	users = NULL;
+	listeners = NULL;
+
+	free(ctx->hash);
+	ctx->hash = NULL;
+
+out:
+	free(listeners);
+	free(users);
+	free(map);
+}
+
+static void ctx_collect(struct context *ctx)
+{
+	unsigned int live = ctx->ninsns - ctx->ndead;
+
+	if (ctx->ndead > live + 64 || ctx->nwaste > ctx->nusers / 2 + 64)
+		ctx_compact(ctx);
+}
+
+/*
+ * Add b to a live context.  Like ctx_adopt(), b is latched to its current
+ * result, so binding it runs no command.  b is not linked into the
+ * bindings list, and b->expr may be freed afterwards.  With CTX_COPIES,
+ * ctx takes b, which must then come from malloc().
+ */
+int ctx_bind(struct context *ctx, struct binding *b, u64 now)
+{
+	unsigned int root;
+
+	if (ctx->nbindings + 1 > ctx->maxbindings) {
+		unsigned int max = ctx->nbindings < 8 ? 16 : ctx->nbindings * 2;
+
+		if (ctx_realloc(&ctx->bindv, ctx->nbindings, max,
+				sizeof(*ctx->bindv)))
+			return -1;
+		ctx->maxbindings = max;
+	}
+
+	root = ctx_compile(ctx, b->expr, &now);
+	if (root == -1 || ctx_user_add(ctx, root,
+				INSN_USER_BINDING | ctx->nbindings)) {
+		/* whatever got linked is now unused */
+		for (unsigned int i = ctx->ninsns; i-- > 0;)
+			ctx_release(ctx, i);
+		return -1;
+	}
+
+	b->root = root;
+	b->state = ctx->results[root];
+	ctx->bindv[ctx->nbindings++] = b;
+
+	ctx_collect(ctx);
+
+	return 0;
+}
+
+/* remove b, added by ctx_bind(), from a live context, freeing it if ctx's */
+int ctx_unbind(struct context *ctx, struct binding *b)
+{
+	unsigned int last = ctx->nbindings - 1;
+	unsigned int idx;
+
+	for (idx = 0; idx < ctx->nbindings; ++idx) {
+		if (ctx->bindv[idx] == b)
+			break;
+	}
+	if (idx == ctx->nbindings)
+		return -1;
+
+	ctx_user_remove(ctx, b->root, INSN_USER_BINDING | idx);
+	if (idx != last) {
+		struct binding *lb = ctx->bindv[last];
+		struct insn *in = &ctx->insns[lb->root];
+		unsigned int *users = &ctx->users[in->users];
+
+		/* the last binding takes the freed slot */
+		for (unsigned int u = 0; u < in->nusers; ++u) {
+			if (users[u] == (INSN_USER_BINDING | last))
+				users[u] = INSN_USER_BINDING | idx;
+		}
+		ctx->bindv[idx] = lb;
+	}
+	ctx->nbindings = last;
+
+	ctx_release(ctx, b->root);
+	ctx_collect(ctx);
+
+	if (ctx->flags & CTX_COPIES)
+		free(b);
+
+	return 0;
+}
+
+int ctx_timeout(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b), u64 now)
+{
+	ctx_dur_expire(ctx, run, now);
+
+	return ctx_pollwait(ctx, now);
+}
+
+/*
+ * Hold back value of state idx until source completes its frame.  Frames
+ * are kept per source, so that one device's SYN_REPORT doesn't cut short
+ * the frame another one is in the middle of.
+ */
+int ctx_frame_add(struct context *ctx, unsigned int source,
+		unsigned int idx, int value)
+{
+	struct ctx_frame *f;
+
+	if (source >= ctx->nframes) {
+		unsigned int n = source + 16;
+
+		if (ctx_realloc(&ctx->frames, ctx->nframes, n,
+				sizeof(*ctx->frames)))
+			return -1;
+		ctx->nframes = n;
+	}
+
+	f = &ctx->frames[source];
+	for (unsigned int i = 0; i < f->nstates; ++i) {
+		if (f->states[i] == idx) {
+			f->values[i] = value;
+			return 0;
+		}
+	}
+
+	if (f->nstates == f->max) {
+		unsigned int max = f->max < 8 ? 16 : f->max * 2;
+
+		if (ctx_realloc(&f->states, f->nstates, max,
+				sizeof(*f->states)) ||
+				ctx_realloc(&f->values, f->nstates, max,
+					sizeof(*f->values)))
+			return -1;
+		f->max = max;
+	}
+	f->states[f->nstates] = idx;
+	f->values[f->nstates++] = value;
+
+	return 0;
+}
+
+/* take in the new value of state typecode; returns 1 if it changed */
+static int ctx_input_state(struct context *ctx, unsigned int source,
+		unsigned int typecode, int value)
+{
+	unsigned int type = typecode >> 16;
+	unsigned int code = typecode & 0xffff;
+	unsigned int idx;
+
+	if (type >= CTX_LOOKUPS || code >= ctx->nlookup[type])
+		return 0;
+
+	idx = ctx->lookup[type][code];
+	if (idx == 0xffff)
+		return 0;
+
+	/* held back until SYN_REPORT, unless it can't be */
+	if ((ctx->flags & CTX_FRAMED) &&
+			ctx_frame_add(ctx, source, idx, value) == 0)
+		return 0;
+
+	if (ctx->values[idx] == value)
+		return 0;
+
+	ctx->values[idx] = value;
+	ctx_state_changed(ctx, idx);
+
+	return 1;
+}
+
+/*
+ * Handle an event of source, a device matching device, as in "ABS_X@2",
+ * or of one that qualifies as none with 0.  It sets the unqualified state
+ * too, and that of any device, "ABS_X@*".  With CTX_FRAMED, the
+ * bindings see the changes of a source all at once when its own
+ * SYN_REPORT comes in; sources are told apart, so that several devices
+ * may be in the middle of a frame at the same time.
+ */
+int ctx_input_event(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b),
+		unsigned int source, unsigned int device,
+		unsigned int typecode, int value, u64 now)
+{
+	int changed;
+
+	ctx_dur_expire(ctx, run, now);
+
+	if ((ctx->flags & CTX_FRAMED) &&
+			typecode == expr_typecode(EV_SYN, SYN_REPORT)) {
+		struct ctx_frame *f;
+
+		if (source >= ctx->nframes)
+			return ctx_pollwait(ctx, now);
+
+		f = &ctx->frames[source];
+		for (unsigned int i = 0; i < f->nstates; ++i) {
+			unsigned int idx = f->states[i];
+
+			if (ctx->values[idx] == f->values[i])
+				continue;
+			ctx->values[idx] = f->values[i];
+			ctx_state_changed(ctx, idx);
+		}
+		f->nstates = 0;
+
+		ctx_propagate(ctx, run, now);
+		return ctx_pollwait(ctx, now);
+	}
+
+	changed = ctx_input_state(ctx, source, typecode, value);
+	changed |= ctx_input_state(ctx, source,
+			expr_qualify(typecode, EXPR_ANY), value);
+	if (device != 0 && device < EXPR_ANY)
+		changed |= ctx_input_state(ctx, source,
+				expr_qualify(typecode, device), value);
+
+	if (changed && (ctx->flags & CTX_FRAMED) == 0)
+		ctx_propagate(ctx, run, now);
+
 	return ctx_pollwait(ctx, now);
 }
@@ -1,39 +1,219 @@
 #ifndef __CONTEXT_H_
 #define __CONTEXT_H_
 
+#include <linux/input.h>
+
 #include "types.h"
+#include "expr.h"
+
+struct binding;
+
+enum insn_op {
+	INSN_OR,
+	INSN_XOR,
+	INSN_AND,
+	INSN_NOT,
+	INSN_DUR,
+	INSN_CMP,
+};
+
+/*
+ * Compiled expression node.  Operands always precede their users, so
+ * ascending index order is a valid evaluation order.  Users (consuming
+ * instructions, and bindings tagged with INSN_USER_BINDING) are listed
+ * in ctx->users[users .. users + nusers).
+ */
+struct insn {
+	enum insn_op op;
+	unsigned int users;
+	unsigned int nusers;
+	union {
+		struct {
+			unsigned int left;
+			unsigned int right;
+		} binop;
+
+		unsigned int not;
+
+		struct {
+			unsigned int expr;
+			unsigned int duration;
+			unsigned int slot;
+			u64 end;
+		} dur;
+
+		struct expr_match cmp;
+	};
+};
+
+#define INSN_USER_BINDING (1u << 31)
+
+/* insn.users of an instruction nothing uses any more, see ctx_unbind() */
+#define INSN_DEAD (~0u)
 
-struct expr;
 struct binding {
 	struct expr *expr;
+	unsigned int root;
 	int state;
 	struct binding *next;
-	char command[0];
+
+	/* what a binding of CTX_COPIES was copied from */
+	const struct binding *origin;
+
+	char command[];
 };
 
 struct evstate {
 	unsigned int typecode;
-	int value;
 
-	struct binding **listeners;
+	/* INSN_CMP instructions reading this state, see ctx->listeners */
+	unsigned int listeners;
 	unsigned int nlisteners;
 };
 
+enum {
+	CTX_FRAMED	= (1 << 0),
+	/* the bindings are the context's own, freed along with it */
+	CTX_COPIES	= (1 << 1),
+};
+
+/* new values a source sent since its last SYN_REPORT, see CTX_FRAMED */
+struct ctx_frame {
+	unsigned int *states;
+	int *values;
+	unsigned int nstates;
+	unsigned int max;
+};
+
+#define CTX_LOOKUPS (EV_CNT * EXPR_DEVICES)
+
+struct context;
+
+/*
+ * Evaluation of a context generated by gen_static(), compiled rather than
+ * interpreted: eval[b] computes the expression of bindv[b] straight
+ * through, and lists[] holds the bindings to evaluate once a state
+ * changes, or an INSN_DUR instruction runs out, at the offsets given by
+ * states[] and durations[], each list ending with -1.
+ */
+struct ctx_gen {
+	int (*const *eval)(struct context *ctx, u64 now);
+	const unsigned int *states;
+	const unsigned int *durations;
+	const unsigned int *lists;
+
+	/* bindings marked for evaluation */
+	unsigned char *marked;
+	unsigned int *pending;
+	unsigned int npending;
+};
+
 struct context {
+	unsigned int flags;
+
+	/* values[i] is the current value of states[i] */
 	struct evstate *states;
+	int *values;
 	unsigned int nstates;
+	unsigned int *listeners;
+	unsigned int nlisteners;
 	struct binding *bindings;
+	struct binding **bindv;
+	unsigned int nbindings;
+
+	/*
+	 * code to state index maps per typecode >> 16, that is per type and
+	 * device qualifier, 0xffff if not referenced
+	 */
+	unsigned short *lookup[CTX_LOOKUPS];
+	unsigned int nlookup[CTX_LOOKUPS];
+
+	/* pending frames, indexed by the source of the events */
+	struct ctx_frame *frames;
+	unsigned int nframes;
+
+	/* set for contexts generated by gen_static() */
+	struct ctx_gen *gen;
+
+	/* results[i] caches the last value of insns[i] */
+	struct insn *insns;
+	unsigned char *results;
+	unsigned char *queued;
+	unsigned int ninsns;
+	unsigned int *users;
+	unsigned int nusers;
+
+	/* typecode, then instruction, hash index used by ctx_init/ctx_bind */
+	unsigned int *hash;
+	unsigned int nhash;
 
-	struct expr **durations;
+	/* min-heap of instructions awaiting re-evaluation */
+	unsigned int *dirty;
+	unsigned int ndirty;
+
+	/* min-heap of armed INSN_DUR instructions, keyed by dur.end */
+	unsigned int *durations;
 	unsigned int ndurations;
+
+	/* allocated sizes of the arrays ctx_bind() grows, 0 if unknown */
+	unsigned int maxstates;
+	unsigned int maxinsns;
+	unsigned int maxusers;
+	unsigned int maxlisteners;
+	unsigned int maxbindings;
+
+	/* dead instructions and stale users/listeners entries */
+	unsigned int ndead;
+	unsigned int nwaste;
+};
+
+/* immutable part of a context, as stored in a config cache */
+struct ctx_image {
+	const struct evstate *states;
+	unsigned int nstates;
+	const unsigned int *listeners;
+	unsigned int nlisteners;
+	const struct insn *insns;
+	unsigned int ninsns;
+	const unsigned int *users;
+	unsigned int nusers;
+	unsigned int nbindings;
 };
 
-int ctx_init(struct context *ctx, struct binding *bindings);
+int ctx_init(struct context *ctx, struct binding *bindings,
+		unsigned int flags);
+int ctx_load(struct context *ctx, const struct ctx_image *img,
+		struct binding *bindings, unsigned int flags);
+int ctx_subset(struct context *ctx, struct context *src,
+		const unsigned char *keep);
+void ctx_free(struct context *ctx);
+
+int ctx_state_lookup(struct context *ctx, unsigned int typecode);
+unsigned int ctx_binding_states(struct context *ctx, struct binding *b,
+		unsigned int *states, unsigned int max);
+int ctx_binding_local(struct context *ctx, struct binding *b);
+int ctx_binding_reads(struct context *ctx, struct binding *b,
+		const unsigned char *states);
+int ctx_adopt(struct context *ctx, struct context *old, u64 now);
+int ctx_frame_add(struct context *ctx, unsigned int source,
+		unsigned int idx, int value);
+
+int ctx_add_states(struct context *ctx, struct expr *e);
+int ctx_bind(struct context *ctx, struct binding *b, u64 now);
+int ctx_unbind(struct context *ctx, struct binding *b);
+
+/* provided by the generated configuration of evev-static */
+void ctx_static(struct context *ctx, unsigned int flags);
+int ctx_dur_eval(struct context *ctx, unsigned int i, u64 now);
 
 int ctx_input_event(struct context *ctx,
-		int (*run)(const char *command),
+		int (*run)(struct context *ctx, struct binding *b),
+		unsigned int source, unsigned int device,
 		unsigned int typecode, int value, u64 now);
 
-int ctx_timeout(struct context *ctx, int (*run)(const char *command), u64 now);
+int ctx_eval(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b), u64 now);
+int ctx_timeout(struct context *ctx,
+		int (*run)(struct context *ctx, struct binding *b), u64 now);
 
 #endif
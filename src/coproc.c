@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "coproc.h"
+#include "types.h"
+
+/* lines queued while the coprocess is slow to read; further ones are lost */
+#ifndef COPROC_BUF_SIZE
+#define COPROC_BUF_SIZE 65536
+#endif
+
+/* a coprocess exiting sooner than this after starting isn't restarted yet */
+#define COPROC_RESTART_MS 1000
+
+extern char **environ;
+
+/*
+ * The coprocess: a long-running command, started through sh, reading
+ * lines on its stdin from a pipe whose write end is non-blocking.
+ */
+static char *coproc_command;
+static int coproc_wfd = -1;
+static u64 coproc_started;
+static unsigned int coproc_nstarts;
+static int coproc_partial;
+
+static char coproc_buf[COPROC_BUF_SIZE];
+static size_t coproc_len;
+
+static u64 coproc_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int coproc_start(void)
+{
+	char *const argv[] = {
+		"/bin/sh", "-c", coproc_command, NULL
+	};
+	posix_spawn_file_actions_t fa;
+	posix_spawnattr_t attr;
+	sigset_t mask;
+	pid_t pid;
+	int p[2];
+	int rc;
+
+	if (pipe2(p, O_CLOEXEC) == -1)
+		return -1;
+
+	if (fcntl(p[1], F_SETFL, O_NONBLOCK) == -1)
+		goto err;
+
+	posix_spawn_file_actions_init(&fa);
+	posix_spawn_file_actions_adddup2(&fa, p[0], 0);
+
+	/* don't pass on what evev blocks or ignores */
+	sigemptyset(&mask);
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setsigmask(&attr, &mask);
+	sigaddset(&mask, SIGCHLD);
+	sigaddset(&mask, SIGPIPE);
+	posix_spawnattr_setsigdefault(&attr, &mask);
+	posix_spawnattr_setflags(&attr,
+			POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+	rc = posix_spawn(&pid, argv[0], &fa, &attr, argv, environ);
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&fa);
+	if (rc) {
+		errno = rc;
+		goto err;
+	}
+
+	close(p[0]);
+	coproc_wfd = p[1];
+	coproc_started = coproc_now();
+	++coproc_nstarts;
+
+	return 0;
+
+err:
+	close(p[0]);
+	close(p[1]);
+	return -1;
+}
+
+/* start command as the coprocess */
+int coproc_init(const char *command)
+{
+	coproc_command = strdup(command);
+	if (coproc_command == NULL)
+		return -1;
+
+	return coproc_start();
+}
+
+/* the descriptor to wait on for room to write, or -1 */
+int coproc_fd(void)
+{
+	return coproc_wfd;
+}
+
+/* how many coprocesses have been started, telling restarts apart */
+unsigned int coproc_starts(void)
+{
+	return coproc_nstarts;
+}
+
+/* number of bytes queued for the coprocess */
+int coproc_pending(void)
+{
+	return coproc_len;
+}
+
+/*
+ * Milliseconds until a coprocess that exited may be restarted, as long
+ * as there is something to write to it; -1 otherwise.
+ */
+int coproc_timeout(void)
+{
+	u64 now;
+
+	if (coproc_command == NULL || coproc_wfd != -1 || coproc_len == 0)
+		return -1;
+
+	now = coproc_now();
+	if (now - coproc_started >= COPROC_RESTART_MS)
+		return 0;
+
+	return COPROC_RESTART_MS - (now - coproc_started);
+}
+
+/*
+ * Replace a coprocess that has exited, unless it was only just started;
+ * coproc_timeout() says when to try again.  Queued lines are kept, less
+ * the remainder of one the previous coprocess got partway through.
+ */
+static int coproc_restart(void)
+{
+	size_t skip;
+	char *nl;
+
+	if (coproc_wfd != -1) {
+		close(coproc_wfd);
+		coproc_wfd = -1;
+	}
+
+	if (coproc_partial) {
+		nl = memchr(coproc_buf, '\n', coproc_len);
+		skip = nl ? (size_t)(nl + 1 - coproc_buf) : coproc_len;
+		memmove(coproc_buf, coproc_buf + skip, coproc_len - skip);
+		coproc_len -= skip;
+		coproc_partial = 0;
+	}
+
+	if (coproc_command == NULL ||
+			coproc_now() - coproc_started < COPROC_RESTART_MS)
+		return -1;
+
+	return coproc_start();
+}
+
+/* restart the coprocess if it has exited, as seen by its pipe */
+int coproc_check(void)
+{
+	struct pollfd pfd = { coproc_wfd, POLLOUT, 0 };
+
+	if (coproc_wfd == -1 || poll(&pfd, 1, 0) <= 0 ||
+			(pfd.revents & (POLLERR | POLLHUP)) == 0)
+		return 0;
+
+	return coproc_restart();
+}
+
+/* write out as much of the queue as the pipe takes */
+int coproc_flush(void)
+{
+	size_t off = 0;
+	ssize_t n;
+
+	if (coproc_wfd == -1 && coproc_restart())
+		return coproc_command ? 0 : -1;
+
+	while (off < coproc_len) {
+		n = write(coproc_wfd, coproc_buf + off, coproc_len - off);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN)
+				break;
+
+			/* most likely EPIPE, the coprocess exited */
+			memmove(coproc_buf, coproc_buf + off, coproc_len - off);
+			coproc_len -= off;
+			off = 0;
+			if (coproc_restart())
+				return 0;
+			continue;
+		}
+
+		off += n;
+		coproc_partial = coproc_buf[off - 1] != '\n';
+	}
+
+	memmove(coproc_buf, coproc_buf + off, coproc_len - off);
+	coproc_len -= off;
+
+	return 0;
+}
+
+/*
+ * Queue the len bytes of line, which should end in a newline, and write
+ * out what the pipe takes.  Lines which don't fit in the queue are
+ * dropped, failing with ENOBUFS.
+ */
+int coproc_write(const char *line, size_t len)
+{
+	if (coproc_command == NULL) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	if (len > sizeof(coproc_buf) - coproc_len) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	memcpy(coproc_buf + coproc_len, line, len);
+	coproc_len += len;
+
+	return coproc_flush();
+}
@@ -0,0 +1,15 @@
+#ifndef __COPROC_H_
+#define __COPROC_H_
+
+#include <stddef.h>
+
+int coproc_init(const char *command);
+int coproc_fd(void);
+unsigned int coproc_starts(void);
+int coproc_pending(void);
+int coproc_timeout(void);
+int coproc_write(const char *line, size_t len);
+int coproc_flush(void);
+int coproc_check(void);
+
+#endif
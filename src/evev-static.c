@@ -0,0 +1,2 @@
+#define EVEV_STATIC
+#include "evev.c"
@@ -1,7 +1,10 @@
 // SPDX-License-Identifier: BSD-2-Clause
 // Copyright (c) 2017 Courtney Cavin
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <signal.h>
@@ -9,9 +12,11 @@
 #include <string.h>
 #include <fnmatch.h>
 #include <errno.h>
-#include <spawn.h>
 #include <glob.h>
+#include <limits.h>
+#include <stdarg.h>
 #include <err.h>
+#include <ctype.h>
 
 #include <sys/epoll.h>
 #include <sys/inotify.h>
@@ -19,307 +24,2366 @@
 #include <sys/time.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <linux/input.h>
 
-#include "context.h"
-#include "parser.h"
-#include "tables.h"
-#include "types.h"
-#include "expr.h"
+#include "arena.h"
+#include "context.h"
+#include "parser.h"
+#include "cache.h"
+#include "state.h"
+#include "reader.h"
+#include "ring.h"
+#include "shard.h"
+#include "spawner.h"
+#include "coproc.h"
+#include "gen.h"
+#include "tables.h"
+#include "uinput.h"
+#include "types.h"
+#include "expr.h"
+
+#define DEV_INPUT "/dev/input"
+#define DEF_CFG PREFIX_ETC "/evev"
+
+/* "<state memfd> <epoll fd> <device fd>...", see upgrade() */
+#define EVEV_RESUME "EVEV_RESUME"
+
+/* epoll events handled per wakeup */
+#ifndef MAX_READY
+#define MAX_READY 64
+#endif
+
+/* input events read per syscall */
+#ifndef MAX_BATCH
+#define MAX_BATCH 64
+#endif
+
+/* events queued by the reader thread, and commands for the launcher, -t */
+#ifndef READ_QUEUE
+#define READ_QUEUE 4096
+#endif
+#ifndef LAUNCH_QUEUE
+#define LAUNCH_QUEUE 256
+#endif
+
+/* threads evaluating the rules of single devices, at most, and their queues */
+#ifndef EVAL_WORKERS
+#define EVAL_WORKERS 8
+#endif
+#ifndef EVAL_QUEUE
+#define EVAL_QUEUE 4096
+#endif
+
+/* longest line written to the coprocess */
+#ifndef COPROC_LINE
+#define COPROC_LINE 4096
+#endif
+
+enum {
+	FLAG_INFO	= (1 << 0),
+	FLAG_MONITOR	= (1 << 1),
+	FLAG_LOGGING	= (1 << 2),
+	FLAG_QUIET	= (1 << 3),
+	FLAG_FRAMED	= (1 << 4),
+	FLAG_GENERATE	= (1 << 5),
+	FLAG_CONTROL	= (1 << 6),
+	FLAG_GRAB	= (1 << 7),
+	FLAG_PIPELINE	= (1 << 8),
+	FLAG_SHARDED	= (1 << 9),
+};
+
+static u64 time_ms(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (u64)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+/*
+ * the event being handled, for the templates of the commands it runs, and
+ * the context of the rules across devices, for the values a shard lacks
+ */
+static struct {
+	u64 time;
+	const char *device;
+	struct context *coord;
+} trigger;
+
+static int trigger_value(void *data, unsigned int typecode, int *value)
+{
+	struct context *ctx = data;
+	int idx;
+
+	idx = ctx_state_lookup(ctx, typecode);
+	if (idx == -1 && trigger.coord && ctx != trigger.coord) {
+		ctx = trigger.coord;
+		idx = ctx_state_lookup(ctx, typecode);
+	}
+	if (idx == -1)
+		return -1;
+
+	*value = ctx->values[idx];
+	return 0;
+}
+
+/*
+ * "|text" writes a line of text to the coprocess, and "|+text" does so
+ * with the values of the states the rule depends on appended, as in
+ * "text ABS_VOLUME=42".
+ */
+static int execute_coproc(struct context *ctx, struct binding *b)
+{
+	const char *text = b->command + 1;
+	unsigned int states[32];
+	char line[COPROC_LINE];
+	unsigned int n = 0;
+	size_t len;
+
+	if (*text == '+') {
+		n = ctx_binding_states(ctx, b, states, ARRAY_SIZE(states));
+		++text;
+	}
+	while (*text == ' ' || *text == '\t')
+		++text;
+
+	len = snprintf(line, sizeof(line), "%s", text);
+	for (unsigned int i = 0; i < n && len < sizeof(line); ++i) {
+		unsigned int typecode = ctx->states[states[i]].typecode;
+		const char *name = code_name(expr_type(typecode),
+				typecode & 0xffff);
+		char device[16] = "";
+
+		if (expr_device(typecode) == EXPR_ANY)
+			strcpy(device, "@*");
+		else if (expr_device(typecode))
+			sprintf(device, "@%u", expr_device(typecode));
+
+		len += snprintf(line + len, sizeof(line) - len, " %s%s=%d",
+				name ? name : "?", device,
+				ctx->values[states[i]]);
+	}
+
+	if (len >= sizeof(line) - 1) {
+		warnx("%s: line too long", b->command);
+		return -1;
+	}
+	line[len++] = '\n';
+
+	if (coproc_write(line, len)) {
+		warn("%s", b->command);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int execute(struct context *ctx, struct binding *b)
+{
+	struct spawn_vars vars = {
+		trigger.device ? trigger.time : time_ms(), trigger.device,
+		trigger_value, ctx,
+	};
+	int rc;
+
+	if (b->command[0] == '|')
+		return execute_coproc(ctx, b);
+
+	/* running into the -j limit is left quiet, as it may go on and on */
+	rc = spawn_run(b->command, &vars);
+	if (rc && rc != EAGAIN)
+		warnx("%s: %s", b->command, strerror(rc));
+
+	return rc;
+}
+
+/* run a binding of a shard a worker found to fire, see shard_drain() */
+static void execute_fired(const struct shard_fire *f)
+{
+	/* one of its timers ran out if there is no event to go by */
+	trigger.time = f->time;
+	trigger.device = f->time ? f->shard->device : NULL;
+	execute(&f->shard->ctx, f->b);
+	trigger.device = NULL;
+}
+
+/* work out how to run the commands of ctx ahead of their first trigger */
+static void prepare_commands(struct context *ctx)
+{
+	const char *command;
+
+	spawn_reset();
+	for (unsigned int i = 0; i < ctx->nbindings; ++i) {
+		command = ctx->bindv[i]->command;
+		if (spawn_prepare(command) && errno == EINVAL)
+			warnx("%s: invalid @option or builtin", command);
+	}
+	spawn_sweep();
+}
+
+/* describe a wait status in buf, big enough for "signal " and an int */
+static const char *exit_status(int status, char *buf)
+{
+	if (status == -1)
+		return "-";
+
+	if (WIFSIGNALED(status))
+		sprintf(buf, "signal %d", WTERMSIG(status));
+	else
+		sprintf(buf, "exit %d", WEXITSTATUS(status));
+
+	return buf;
+}
+
+static void log_command(const char *command, int status, unsigned int ms)
+{
+	char buf[20];
+
+	printf("%s: %s after %u ms\n", command, exit_status(status, buf), ms);
+}
+
+static void mon_input_event(struct input_event *ev)
+{
+	const char *codep;
+	const char *typep;
+	char code[14];
+	char type[14];
+
+	typep = code_type_name(ev->type);
+	if (typep == NULL) {
+		sprintf(type, "%d", ev->type);
+		typep = type;
+	}
+
+	codep = code_name(ev->type, ev->code);
+	if (codep == NULL) {
+		sprintf(code, "%d", ev->code);
+		codep = code;
+	}
+
+	printf("%s %s %d\n", typep, codep, ev->value);
+}
+
+#define MAX_EV_CNT ((KEY_CNT + 31) / 32)
+
+static int bitstate(u32 *buf, int bit)
+{
+	return (buf[bit / 32] & (1 << (bit % 32))) != 0;
+}
+
+/*
+ * Read the current value of every state in ctx from index from on that
+ * the device supports, skipping those already tracked by old, and those
+ * qualified by a pattern other than the device's, marking them in has if
+ * given.  Returns 1 if any are supported, 0 if none are, or -1 if the
+ * device could not be queried.
+ */
+static int query_evdev(int fd, unsigned int pattern, struct context *ctx,
+		struct context *old, unsigned int from, unsigned char *has)
+{
+	u32 states[MAX_EV_CNT];
+	u32 buf[MAX_EV_CNT];
+	int match = 0;
+	int type = -1;
+	int rc;
+
+	for (unsigned int i = from; i < ctx->nstates; ++i) {
+		struct evstate *evs = &ctx->states[i];
+
+		int ctype = expr_type(evs->typecode);
+		int ccode = evs->typecode & 0xffff;
+
+		if (expr_device(evs->typecode) &&
+				expr_device(evs->typecode) != EXPR_ANY &&
+				expr_device(evs->typecode) != pattern)
+			continue;
+
+		if (old && ctx_state_lookup(old, evs->typecode) != -1)
+			continue;
+
+		if (ctype != type) {
+			unsigned int len = MAX_EV_CNT * sizeof(states[0]);
+			unsigned long ioc;
+
+			memset(buf, 0, sizeof(buf));
+			rc = ioctl(fd, EVIOCGBIT(ctype, len), buf);
+			if (rc < 1)
+				return -1;
+
+			type = ctype;
+			switch (type) {
+			case EV_SW:  ioc = EVIOCGSW(len); break;
+			case EV_KEY: ioc = EVIOCGKEY(len); break;
+			case EV_SND: ioc = EVIOCGSND(len); break;
+			case EV_LED: ioc = EVIOCGLED(len); break;
+			default: ioc = 0; break;
+			}
+
+			if (ioc != 0) {
+				memset(states, 0, sizeof(states));
+				rc = ioctl(fd, ioc, states);
+				if (rc < 1)
+					return -1;
+			}
+		}
+
+		if (!bitstate(buf, ccode))
+			continue;
+
+		if (has)
+			has[i] = 1;
+		match = 1;
+		switch (type) {
+		case EV_SW:
+		case EV_KEY:
+		case EV_SND:
+		case EV_LED:
+			ctx->values[i] = bitstate(states, ccode);
+			break;
+		case EV_ABS: {
+			struct input_absinfo ainfo;
+			rc = ioctl(fd, EVIOCGABS(ccode), &ainfo);
+			if (rc < 0)
+				return -1;
+			ctx->values[i] = ainfo.value;
+			} break;
+		default:
+			break;
+		}
+	}
+
+	return match;
+}
+
+/*
+ * Which of names the device evdev, open as fd, matches: the number of the
+ * first, counting from 1, or 0 if there are no names.  Returns -1 if it
+ * matches none, or isn't one to read at all.
+ */
+static int match_evdev(int fd, const char *evdev, char **names, int nnames,
+		int flags)
+{
+	char dphys[128];
+	char dname[128];
+	int match = nnames == 0 ? 0 : -1;
+	int rc;
+
+	rc = ioctl(fd, EVIOCGPHYS(sizeof(dphys) - 1), dphys);
+	if (rc < 1)
+		return -1;
+
+	rc = ioctl(fd, EVIOCGNAME(sizeof(dname) - 1), dname);
+	if (rc < 1)
+		return -1;
+
+	/* what evev emits itself isn't to be fed back in */
+	if (uinput_is_own(dphys))
+		return -1;
+
+	for (unsigned int i = 0; i < nnames; ++i) {
+		const char *pattern;
+		const char *text;
+		int pflags = 0;
+
+		if (!strncmp(names[i], "phys=", 5)) {
+			pattern = names[i] + 5;
+			text = dphys;
+			pflags = FNM_PATHNAME;
+		} else if (!strncmp(names[i], "name=", 5)) {
+			pattern = names[i] + 5;
+			text = dname;
+		} else if (!strncmp(names[i], "dev=", 4)) {
+			pattern = names[i] + 4;
+			text = evdev;
+			pflags = FNM_PATHNAME;
+		} else {
+			pattern = names[i];
+			text = evdev;
+			pflags = FNM_PATHNAME;
+		}
+
+		if (!fnmatch(pattern, text, pflags)) {
+			match = i + 1;
+			break;
+		}
+	}
+
+	if (flags & FLAG_INFO) {
+		fprintf(stderr, "%s: phys=\"%s\" name=\"%s\" match=%s\n",
+				evdev, dphys, dname, match != -1 ? "yes" : "no");
+	}
+
+	return match;
+}
+
+/* only the first patterns can qualify events, see expr_qualify() */
+static unsigned int evdev_pattern(int match)
+{
+	return match > 0 && match < EXPR_ANY ? match : 0;
+}
+
+static int open_evdev(const char *evdev, char **names, int nnames,
+		int flags, struct context *ctx, unsigned int *pattern)
+{
+	int match;
+	int fd;
+
+	fd = open(evdev, O_RDONLY | O_NONBLOCK);
+	if (fd == -1) {
+		if ((flags & FLAG_QUIET) == 0)
+			warn(evdev);
+		return -1;
+	}
+
+	match = match_evdev(fd, evdev, names, nnames, flags);
+	if (match == -1) {
+		close(fd);
+		return -1;
+	}
+	*pattern = evdev_pattern(match);
+
+	if ((flags & FLAG_MONITOR) == 0 && ctx) {
+		match = query_evdev(fd, *pattern, ctx, NULL, 0, NULL);
+		if (match == -1)
+			err(1, "%s", evdev);
+
+		/* rules added later on may well need it */
+		if (flags & FLAG_CONTROL)
+			match = 1;
+
+		if (!match && nnames != 0)
+			warnx("%s: no relevant events", evdev);
+
+		if (!match) {
+			close(fd);
+			return -1;
+		}
+	}
+
+	/* keep its events to evev, say for a macro pad */
+	if ((flags & FLAG_GRAB) && ioctl(fd, EVIOCGRAB, 1) == -1 &&
+			(flags & FLAG_QUIET) == 0)
+		warn("%s: grab", evdev);
+
+	return fd;
+}
+
+static void epoll_add(int efd, int fd)
+{
+	struct epoll_event ev = {0,};
+	int rc;
+
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	rc = epoll_ctl(efd, EPOLL_CTL_ADD, fd, &ev);
+	if (rc == -1)
+		err(1, "epoll_ctl");
+}
+
+/*
+ * paths of the open event devices, indexed by fd, along with the patterns
+ * they matched, see evdev_pattern(), their shards, and whether they are
+ * read by the reader thread rather than in the event loop.  Their events
+ * go to coord, and with sharded set, to the shard of the device as well,
+ * holding a copy of those rules in tmpl it has events for; see
+ * evdevs_split().
+ */
+struct evdevs {
+	char **paths;
+	unsigned char *patterns;
+	struct shard **shards;
+	unsigned int npaths;
+	int threaded;
+	int sharded;
+
+	struct context coord;
+	struct context tmpl;
+};
+
+/*
+ * ev of device fd, matching the pattern devs->patterns[fd], and evaluated
+ * on its own in the shard devs->shards[fd], if it has one
+ */
+static void input_event(struct evdevs *devs, struct input_event *ev,
+		int fd, int flags)
+{
+	struct shard *s = devs->shards[fd];
+	unsigned int typecode;
+	u64 now;
+
+	if (ev->type == EV_KEY && ev->value == 2) {
+		/* ignore key repeat */
+		return;
+	}
+
+	if (flags & FLAG_MONITOR) {
+		mon_input_event(ev);
+		return;
+	}
+
+	if (flags & FLAG_LOGGING)
+		mon_input_event(ev);
+
+	now = (u64)ev->time.tv_sec * 1000 + ev->time.tv_usec / 1000;
+	typecode = expr_typecode(ev->type, ev->code);
+
+	trigger.time = now;
+	trigger.device = devs->paths[fd];
+	ctx_input_event(&devs->coord, execute, fd, devs->patterns[fd],
+			typecode, ev->value, now);
+
+	/* queueing it to a worker may run what the workers fired already */
+	if (s && s->ctx.nbindings)
+		shard_input(s, execute, typecode, ev->value, now);
+	trigger.device = NULL;
+}
+
+/* returns -1 when the device is gone and should be dropped */
+static int read_evdev(struct evdevs *devs, int fd, int flags)
+{
+	struct input_event evs[MAX_BATCH];
+	ssize_t rc;
+
+	for (;;) {
+		rc = read(fd, evs, sizeof(evs));
+		if (rc == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN)
+				break;
+			if (errno == ENODEV)
+				return -1;
+			err(1, "read");
+		}
+
+		if (rc == 0)
+			return -1;
+
+		if (rc % sizeof(evs[0]))
+			errx(1, "short read");
+
+		for (unsigned int i = 0; i < rc / sizeof(evs[0]); ++i)
+			input_event(devs, &evs[i], fd, flags);
+
+		/* a partial buffer means the queue has been drained */
+		if (rc < sizeof(evs))
+			break;
+	}
+
+	shard_kick();
+	return 0;
+}
+
+/* a configuration source, whose bindings live until it changes */
+struct cfg_file {
+	/* NULL for inline configuration */
+	char *path;
+	struct stat st;
+	struct arena arena;
+	struct binding *bindings;
+	struct binding *last;
+};
+
+/* a rule added through the control socket, see ctl_command() */
+struct rule {
+	char *name;
+	char *text;
+	struct binding *binding;
+
+	/* its copy in devs->coord or devs->tmpl, see evdevs_split() */
+	struct binding *copy;
+};
+
+struct config {
+	const char *pattern;
+	const char *text;
+	const char *cache;
+	const char *socket;
+	const char *coproc;
+	unsigned int jobs;
+	unsigned int cflags;
+
+	struct rule *rules;
+	unsigned int nrules;
+
+	struct cfg_file *files;
+	unsigned int nfiles;
+
+	/* set while the bindings in use were restored from the cache */
+	struct arena cached;
+	int restored;
+};
+
+#ifdef EVEV_STATIC
+static void load_config(struct config *cfg, struct context *ctx, int flags)
+{
+	ctx_static(ctx, cfg->cflags);
+}
+#else
+static int parse_file(struct cfg_file *f)
+{
+	char *mem = NULL;
+	int fd;
+	int rc;
+
+	fd = open(f->path, O_RDONLY);
+	if (fd == -1) {
+		warn("%s", f->path);
+		return -1;
+	}
+
+	if (fstat(fd, &f->st) == -1) {
+		warn("%s", f->path);
+		close(fd);
+		return -1;
+	}
+
+	if (f->st.st_size) {
+		mem = mmap(0, f->st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mem == MAP_FAILED) {
+			warn("%s", f->path);
+			close(fd);
+			return -1;
+		}
+	}
+
+	rc = psr_parse(mem, f->st.st_size, &f->arena, &f->bindings);
+	if (rc)
+		warnx("%s: failed parsing", f->path);
+
+	if (mem)
+		munmap(mem, f->st.st_size);
+	close(fd);
+
+	return rc;
+}
+
+static int parse_source(struct config *cfg, struct cfg_file *f)
+{
+	struct binding *b;
+
+	if (f->path) {
+		if (parse_file(f))
+			return -1;
+	} else if (psr_parse(cfg->text, strlen(cfg->text), &f->arena,
+				&f->bindings)) {
+		warnx("<cmdline>: failed parsing");
+		return -1;
+	}
+
+	for (b = f->bindings; b && b->next; b = b->next)
+		;
+	f->last = b;
+
+	return 0;
+}
+
+static char **config_glob(struct config *cfg, glob_t *gr)
+{
+	static char *nopaths[] = { NULL };
+	int rc = GLOB_NOMATCH;
+
+	memset(gr, 0, sizeof(*gr));
+
+	if (cfg->pattern)
+		rc = glob(cfg->pattern, 0, NULL, gr);
+	else if (cfg->text == NULL)
+		rc = glob(DEF_CFG "/*.cfg", 0, NULL, gr);
+
+	if (rc == GLOB_NOSPACE) {
+		warnx("glob: out of memory");
+		return NULL;
+	}
+	if (rc == GLOB_ABORTED) {
+		warnx("glob: read error");
+		return NULL;
+	}
+
+	return rc == 0 ? gr->gl_pathv : nopaths;
+}
+
+static int config_same(const struct cfg_file *f, const char *path,
+		const struct stat *st)
+{
+	if (f->path == NULL || path == NULL)
+		return f->path == path;
+
+	return !strcmp(f->path, path) &&
+		f->st.st_dev == st->st_dev && f->st.st_ino == st->st_ino &&
+		f->st.st_size == st->st_size &&
+		f->st.st_mtim.tv_sec == st->st_mtim.tv_sec &&
+		f->st.st_mtim.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+static void config_free_files(struct cfg_file *files, unsigned int nfiles)
+{
+	for (unsigned int i = 0; i < nfiles; ++i) {
+		free(files[i].path);
+		arena_free(&files[i].arena);
+	}
+	free(files);
+}
+
+/* chain the bindings of files together, returning the first */
+static struct binding *config_link(struct cfg_file *files,
+		unsigned int nfiles)
+{
+	struct binding *bindings = NULL;
+	struct binding **pb = &bindings;
+
+	for (unsigned int i = 0; i < nfiles; ++i) {
+		if (files[i].bindings == NULL)
+			continue;
+		*pb = files[i].bindings;
+		pb = &files[i].last->next;
+	}
+	*pb = NULL;
+
+	return bindings;
+}
+
+/* set up a record, with path and stat, for each source in paths */
+static struct cfg_file *config_scan(struct config *cfg, char **paths,
+		unsigned int *nfiles)
+{
+	struct cfg_file *files;
+	unsigned int n = cfg->text != NULL;
+
+	for (unsigned int i = 0; paths[i]; ++i)
+		++n;
+
+	files = calloc(n + 1, sizeof(*files));
+	if (files == NULL) {
+		warn("calloc");
+		return NULL;
+	}
+
+	for (unsigned int i = cfg->text != NULL; i < n; ++i) {
+		struct cfg_file *f = &files[i];
+
+		f->path = strdup(paths[i - (cfg->text != NULL)]);
+		if (f->path == NULL) {
+			warn("strdup");
+			goto err;
+		}
+
+		if (stat(f->path, &f->st) == -1) {
+			warn("%s", f->path);
+			goto err;
+		}
+	}
+
+	*nfiles = n;
+
+	return files;
+
+err:
+	config_free_files(files, n);
+	return NULL;
+}
+
+/*
+ * Bring the configuration in line with what is on disk, parsing only
+ * sources which are new or have changed since the last call.  Returns 1
+ * with ctx initialized from the result, 0 if nothing changed, or -1 if
+ * the configuration is unusable, in which case the current one is kept.
+ */
+static int config_update(struct config *cfg, struct context *ctx, int flags)
+{
+	struct binding *bindings;
+	struct cfg_file *files = NULL;
+	unsigned int *reuse = NULL;
+	unsigned int nfiles = 0;
+	int changed;
+	char **paths;
+	glob_t gr;
+	int rc = -1;
+
+	paths = config_glob(cfg, &gr);
+	if (paths == NULL)
+		goto out;
+
+	files = config_scan(cfg, paths, &nfiles);
+	if (files == NULL)
+		goto out;
+
+	reuse = calloc(nfiles + 1, sizeof(*reuse));
+	if (reuse == NULL) {
+		warn("calloc");
+		goto out;
+	}
+
+	changed = cfg->files == NULL || nfiles != cfg->nfiles;
+
+	for (unsigned int i = 0; i < nfiles; ++i) {
+		reuse[i] = -1;
+		for (unsigned int j = 0; j < cfg->nfiles; ++j) {
+			if (config_same(&cfg->files[j], files[i].path,
+						&files[i].st)) {
+				reuse[i] = j;
+				break;
+			}
+		}
+
+		if (reuse[i] == -1)
+			changed = 1;
+	}
+
+	if (!changed) {
+		rc = 0;
+		goto out;
+	}
+
+	for (unsigned int i = 0; i < nfiles; ++i) {
+		/* sources restored from the cache were never parsed */
+		if (cfg->restored)
+			reuse[i] = -1;
+
+		if (reuse[i] == -1) {
+			if (parse_source(cfg, &files[i]))
+				goto out;
+		} else {
+			files[i].bindings = cfg->files[reuse[i]].bindings;
+			files[i].last = cfg->files[reuse[i]].last;
+		}
+	}
+
+	bindings = config_link(files, nfiles);
+
+	/* with a control socket, rules may well all be added through it */
+	if (bindings == NULL && cfg->socket == NULL) {
+		warnx("no configs loaded");
+		goto out;
+	}
+
+	if (ctx_init(ctx, bindings, cfg->cflags)) {
+		warnx("failed to initialize context");
+		goto out;
+	}
+
+	/* reused sources hand their arenas over */
+	for (unsigned int i = 0; i < nfiles; ++i) {
+		if (reuse[i] == -1)
+			continue;
+		files[i].arena = cfg->files[reuse[i]].arena;
+		memset(&cfg->files[reuse[i]].arena, 0,
+				sizeof(files[i].arena));
+	}
+
+	config_free_files(cfg->files, cfg->nfiles);
+	cfg->files = files;
+	cfg->nfiles = nfiles;
+	files = NULL;
+
+	arena_free(&cfg->cached);
+	cfg->restored = 0;
+
+	if (cfg->cache && cache_save(cfg->cache, paths, cfg->text, ctx) &&
+			(flags & FLAG_QUIET) == 0)
+		warn("%s", cfg->cache);
+
+	rc = 1;
+
+out:
+	/* the sources kept were chained to the new ones, which go away */
+	if (rc == -1 && cfg->files)
+		config_link(cfg->files, cfg->nfiles);
+	if (files)
+		config_free_files(files, nfiles);
+	free(reuse);
+	globfree(&gr);
+	return rc;
+}
+
+static void load_config(struct config *cfg, struct context *ctx, int flags)
+{
+	char **paths;
+	glob_t gr;
+	int rc = -1;
+
+	if (cfg->cache) {
+		paths = config_glob(cfg, &gr);
+		if (paths == NULL)
+			exit(1);
+
+		rc = cache_load(cfg->cache, paths, cfg->text, ctx,
+				&cfg->cached, cfg->cflags);
+		if (rc == 0) {
+			cfg->files = config_scan(cfg, paths, &cfg->nfiles);
+			cfg->restored = 1;
+		}
+		globfree(&gr);
+	}
+
+	if (rc && config_update(cfg, ctx, flags) != 1)
+		exit(1);
+}
+
+static void config_watch_dir(const char *path, int ifd, int flags)
+{
+	const unsigned int mask = IN_CLOSE_WRITE | IN_MOVED_TO |
+		IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR;
+	char dir[PATH_MAX];
+	char *p;
+
+	snprintf(dir, sizeof(dir), "%s", path);
+	p = strrchr(dir, '/');
+	if (p == NULL)
+		strcpy(dir, ".");
+	else if (p == dir)
+		dir[1] = '\0';
+	else
+		*p = '\0';
+
+	if (strpbrk(dir, "*?[") != NULL)
+		return;
+
+	if (inotify_add_watch(ifd, dir, mask) == -1 &&
+			(flags & FLAG_QUIET) == 0)
+		warn("%s", dir);
+}
+
+/* watch the directories the configuration is read from */
+static void config_watch(struct config *cfg, int ifd, int flags)
+{
+	char **paths;
+	glob_t gr;
+
+	if (cfg->pattern)
+		config_watch_dir(cfg->pattern, ifd, flags);
+	else if (cfg->text == NULL)
+		config_watch_dir(DEF_CFG "/*.cfg", ifd, flags);
+
+	paths = config_glob(cfg, &gr);
+	if (paths == NULL)
+		return;
+
+	for (unsigned int i = 0; paths[i]; ++i)
+		config_watch_dir(paths[i], ifd, flags);
+
+	globfree(&gr);
+}
+#endif
+
+static void evdev_track(struct evdevs *devs, int fd, const char *path,
+		unsigned int pattern)
+{
+	if (fd >= devs->npaths) {
+		unsigned int n = fd + 16;
+		unsigned char *patterns;
+		struct shard **shards;
+		char **paths;
+
+		paths = realloc(devs->paths, n * sizeof(*paths));
+		if (paths == NULL)
+			err(1, "realloc");
+		devs->paths = paths;
+		patterns = realloc(devs->patterns, n);
+		if (patterns == NULL)
+			err(1, "realloc");
+		devs->patterns = patterns;
+		shards = realloc(devs->shards, n * sizeof(*shards));
+		if (shards == NULL)
+			err(1, "realloc");
+		devs->shards = shards;
+
+		memset(paths + devs->npaths, 0,
+				(n - devs->npaths) * sizeof(*paths));
+		memset(patterns + devs->npaths, 0, n - devs->npaths);
+		memset(shards + devs->npaths, 0,
+				(n - devs->npaths) * sizeof(*shards));
+		devs->npaths = n;
+	}
+
+	devs->paths[fd] = strdup(path);
+	if (devs->paths[fd] == NULL)
+		err(1, "strdup");
+	devs->patterns[fd] = pattern;
+}
+
+/* which states of devs->tmpl device fd has, or NULL if it can't be queried */
+static unsigned char *evdev_caps(struct evdevs *devs, int fd)
+{
+	unsigned char *has;
+
+	has = calloc(devs->tmpl.nstates + 1, sizeof(*has));
+	if (has == NULL)
+		err(1, "calloc");
+
+	if (query_evdev(fd, devs->patterns[fd], &devs->tmpl, NULL, 0,
+				has) == -1) {
+		free(has);
+		return NULL;
+	}
+
+	return has;
+}
+
+/*
+ * A shard of fd's own, with the rules of devs->tmpl it has events for,
+ * not evaluated yet, see evdevs_eval().  Returns -1 if fd can't be
+ * queried.
+ */
+static int evdev_shard(struct evdevs *devs, int fd)
+{
+	unsigned char *keep;
+	unsigned char *has;
+
+	has = evdev_caps(devs, fd);
+	if (has == NULL)
+		return -1;
+
+	keep = malloc(devs->tmpl.nbindings + 1);
+	if (keep == NULL)
+		err(1, "malloc");
+	for (unsigned int i = 0; i < devs->tmpl.nbindings; ++i)
+		keep[i] = ctx_binding_reads(&devs->tmpl,
+				devs->tmpl.bindv[i], has);
+
+	devs->shards[fd] = shard_new(&devs->tmpl, keep, fd, devs->paths[fd]);
+	if (devs->shards[fd] == NULL)
+		err(1, "%s", devs->paths[fd]);
+
+	free(keep);
+	free(has);
+	return 0;
+}
+
+/* start reading fd; returns -1, having closed it, if it went away already */
+static int evdev_add(struct evdevs *devs, int efd, int fd, const char *path,
+		unsigned int pattern)
+{
+	evdev_track(devs, fd, path, pattern);
+	if (devs->sharded && evdev_shard(devs, fd)) {
+		close(fd);
+		free(devs->paths[fd]);
+		devs->paths[fd] = NULL;
+		return -1;
+	}
+
+	if (!devs->threaded)
+		epoll_add(efd, fd);
+	else if (reader_add(fd))
+		err(1, "reader_add");
+
+	return 0;
+}
+
+static void evdev_remove(struct evdevs *devs, int efd, int fd)
+{
+	if (devs->threaded)
+		reader_remove(fd);
+	else
+		epoll_ctl(efd, EPOLL_CTL_DEL, fd, NULL);
+	close(fd);
+	free(devs->paths[fd]);
+	devs->paths[fd] = NULL;
+
+	if (devs->shards[fd]) {
+		shard_pause();
+		shard_free(devs->shards[fd]);
+		shard_resume();
+		devs->shards[fd] = NULL;
+	}
+}
+
+/* hand the devices to the reader thread, or take them back into efd */
+static void evdev_thread(struct evdevs *devs, int efd, int threaded)
+{
+	devs->threaded = threaded;
+
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		if (devs->paths[fd] == NULL)
+			continue;
+
+		if (threaded) {
+			epoll_ctl(efd, EPOLL_CTL_DEL, fd, NULL);
+			if (reader_add(fd))
+				err(1, "reader_add");
+		} else {
+			reader_remove(fd);
+			epoll_add(efd, fd);
+		}
+	}
+}
+
+/* whether b, a binding of ctx, is evaluated per device, see evdevs_split() */
+static int evdevs_local(struct evdevs *devs, struct context *ctx,
+		struct binding *b)
+{
+	return devs->sharded && ctx_binding_local(ctx, b);
+}
+
+/*
+ * Split the rules of ctx between devs->coord, seeing the events of every
+ * device, and with devs->sharded, devs->tmpl for those not telling devices
+ * apart, see ctx_binding_local(), which each device gets a shard of: its
+ * events only change state of its own there.
+ */
+static void evdevs_split(struct evdevs *devs, struct context *ctx)
+{
+	unsigned char *keep;
+
+	keep = malloc(ctx->nbindings + 1);
+	if (keep == NULL)
+		err(1, "malloc");
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i)
+		keep[i] = !evdevs_local(devs, ctx, ctx->bindv[i]);
+	if (ctx_subset(&devs->coord, ctx, keep))
+		errx(1, "failed to split context");
+
+	for (unsigned int i = 0; i < ctx->nbindings; ++i)
+		keep[i] = !keep[i];
+	if (ctx_subset(&devs->tmpl, ctx, keep))
+		errx(1, "failed to split context");
+
+	free(keep);
+}
+
+static int evdevs_latch(struct context *ctx, struct binding *b)
+{
+	return 0;
+}
+
+/*
+ * Query the devices for the states of devs, and evaluate them.  Without
+ * ocoord, this is the first time, and whatever holds runs.  Otherwise
+ * the state of ocoord, and of olds[fd] for the shard of fd, is taken
+ * over, with the rest latched to its current result by ctx_adopt().
+ */
+static void evdevs_eval(struct evdevs *devs, int efd, struct context *ocoord,
+		struct context **olds, unsigned int nolds)
+{
+	u64 now = time_ms();
+
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		struct context *old = fd < nolds ? olds[fd] : NULL;
+
+		if (devs->paths[fd] == NULL)
+			continue;
+
+		if (query_evdev(fd, devs->patterns[fd], &devs->coord,
+					ocoord, 0, NULL) == -1 ||
+				(devs->shards[fd] &&
+				 query_evdev(fd, devs->patterns[fd],
+					&devs->shards[fd]->ctx, old, 0,
+					NULL) == -1))
+			evdev_remove(devs, efd, fd);
+	}
+
+	if (ocoord == NULL) {
+		ctx_eval(&devs->coord, execute, now);
+		for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+			if (devs->shards[fd])
+				ctx_eval(&devs->shards[fd]->ctx, execute, now);
+		}
+		return;
+	}
+
+	if (ctx_adopt(&devs->coord, ocoord, now))
+		errx(1, "failed to take over state");
+
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		struct context *old = fd < nolds ? olds[fd] : NULL;
+		struct shard *s = devs->shards[fd];
+
+		if (s == NULL)
+			continue;
+
+		if (old == NULL)
+			ctx_eval(&s->ctx, evdevs_latch, now);
+		else if (ctx_adopt(&s->ctx, old, now))
+			errx(1, "failed to take over state");
+	}
+}
+
+/* hand the shards evaluated here so far to the workers, if there are any */
+static void evdevs_start(struct evdevs *devs)
+{
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		if (devs->shards[fd] && devs->shards[fd]->worker == -1)
+			shard_add(devs->shards[fd]);
+	}
+}
+
+/*
+ * Run what is due of the contexts evaluated here, rather than by the
+ * workers, returning the time until the next timer as ctx_timeout() does.
+ */
+static int evdevs_timeout(struct evdevs *devs, u64 now)
+{
+	int timeout;
+	int rc;
+
+	timeout = ctx_timeout(&devs->coord, execute, now);
+
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		struct shard *s = devs->shards[fd];
+
+		if (s == NULL || s->worker != -1)
+			continue;
+
+		rc = ctx_timeout(&s->ctx, execute, now);
+		if (rc != -1 && (timeout == -1 || rc < timeout))
+			timeout = rc;
+	}
+
+	return timeout;
+}
+
+/* handle the events the reader thread queued */
+static void read_queue(struct evdevs *devs, int efd, int flags)
+{
+	struct reader_event rev;
+
+	while (reader_pop(&rev) == 0) {
+		if (rev.fd >= devs->npaths || devs->paths[rev.fd] == NULL)
+			continue;
+
+		if (rev.gone)
+			evdev_remove(devs, efd, rev.fd);
+		else
+			input_event(devs, &rev.ev, rev.fd, flags);
+	}
+
+	shard_kick();
+}
+
+static int evdev_is_open(struct evdevs *devs, const char *path)
+{
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		if (devs->paths[fd] && !strcmp(devs->paths[fd], path))
+			return 1;
+	}
+
+	return 0;
+}
+
+/* open every matching device not already open */
+static void scan_evdevs(struct evdevs *devs, int efd, char **names,
+		int nnames, int flags, struct context *ctx)
+{
+	unsigned int pattern;
+	glob_t gr;
+	int rc;
+	int fd;
+
+	rc = glob(DEV_INPUT "/event*", 0, NULL, &gr);
+	if (rc == GLOB_NOSPACE)
+		errx(1, "glob: out of memory");
+	if (rc == GLOB_ABORTED)
+		errx(1, "glob: read error");
+	if (rc == GLOB_NOMATCH)
+		return;
+
+	for (unsigned int i = 0; gr.gl_pathv[i]; ++i) {
+		if (evdev_is_open(devs, gr.gl_pathv[i]))
+			continue;
+
+		fd = open_evdev(gr.gl_pathv[i], names, nnames, flags, ctx,
+				&pattern);
+		if (fd == -1)
+			continue;
+
+		evdev_add(devs, efd, fd, gr.gl_pathv[i], pattern);
+	}
+
+	globfree(&gr);
+}
+
+/*
+ * Bring the shard of fd, a device plugged in meanwhile, in line with what
+ * it is at, latching rather than running its rules, and hand it over to
+ * a worker.  The rules across devices only go by its events.
+ */
+static void evdev_join(struct evdevs *devs, int efd, int fd)
+{
+	struct shard *s = devs->shards[fd];
+
+	if (s == NULL)
+		return;
+
+	if (query_evdev(fd, devs->patterns[fd], &s->ctx, NULL, 0,
+				NULL) == -1) {
+		evdev_remove(devs, efd, fd);
+		return;
+	}
+
+	ctx_eval(&s->ctx, evdevs_latch, time_ms());
+	shard_add(s);
+}
+
+/*
+ * Open hotplugged devices.  Returns 1 if anything other than DEV_INPUT,
+ * that is a configuration directory, changed.
+ */
+static int read_inotify(int ifd, int wfd, struct evdevs *devs, int efd,
+		char **names, int nnames, int flags)
+{
+	char buf[4096]
+		__attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *ev;
+	char path[PATH_MAX];
+	unsigned int pattern;
+	int changed = 0;
+	ssize_t rc;
+	int fd;
+
+	for (;;) {
+		rc = read(ifd, buf, sizeof(buf));
+		if (rc == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN)
+				return changed;
+			err(1, "read");
+		}
+
+		for (char *p = buf; p < buf + rc; p += sizeof(*ev) + ev->len) {
+			ev = (const struct inotify_event *)p;
+
+			if (ev->wd != wfd) {
+				changed = 1;
+				continue;
+			}
+
+			if (!ev->len)
+				continue;
+
+			snprintf(path, sizeof(path), "%s/%s",
+					DEV_INPUT, ev->name);
+			fd = open_evdev(path, names, nnames, flags, NULL,
+					&pattern);
+			if (fd == -1)
+				continue;
+
+			if (evdev_add(devs, efd, fd, path, pattern) == 0)
+				evdev_join(devs, efd, fd);
+		}
+	}
+}
+
+#ifndef EVEV_STATIC
+/* a copy of b, expression and all, to be bound on its own */
+static struct binding *binding_copy(const struct binding *b)
+{
+	size_t len = strlen(b->command);
+	struct binding *copy;
+
+	copy = calloc(1, sizeof(*copy) + len + 1);
+	if (copy == NULL)
+		return NULL;
+	memcpy(copy->command, b->command, len);
+	copy->expr = b->expr;
+	copy->origin = b;
+
+	return copy;
+}
+
+/* the binding of ctx copied from origin, if any */
+static struct binding *binding_find(struct context *ctx,
+		const struct binding *origin)
+{
+	for (unsigned int i = 0; i < ctx->nbindings; ++i) {
+		if (ctx->bindv[i]->origin == origin)
+			return ctx->bindv[i];
+	}
+
+	return NULL;
+}
+
+/* take the copies of r, as bound in devs->tmpl, out of the shards */
+static void rule_unshard(struct rule *r, struct evdevs *devs)
+{
+	shard_pause();
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		struct shard *s = devs->shards[fd];
+		struct binding *b;
+
+		b = s ? binding_find(&s->ctx, r->copy) : NULL;
+		if (b)
+			ctx_unbind(&s->ctx, b);
+	}
+	shard_resume();
+}
+
+/*
+ * Bind a copy of b, the binding of r in ctx, into the context of devs it
+ * belongs in, see evdevs_split(): into devs->coord, or into devs->tmpl
+ * and the shards of the devices having events for it.  Devices are
+ * queried for the states it adds.
+ */
+static int rule_live(struct rule *r, struct context *ctx, struct binding *b,
+		struct evdevs *devs, int efd)
+{
+	int local = evdevs_local(devs, ctx, b);
+	struct context *dst = local ? &devs->tmpl : &devs->coord;
+	unsigned int nstates = dst->nstates;
+	struct binding *copy;
+	u64 now = time_ms();
+
+	copy = binding_copy(b);
+	if (copy == NULL)
+		return -1;
+
+	if (ctx_add_states(dst, b->expr)) {
+		free(copy);
+		return -1;
+	}
+
+	for (unsigned int fd = 0; !local && fd < devs->npaths; ++fd) {
+		if (devs->paths[fd] &&
+				query_evdev(fd, devs->patterns[fd], dst, NULL,
+					nstates, NULL) == -1)
+			evdev_remove(devs, efd, fd);
+	}
+
+	if (ctx_bind(dst, copy, now)) {
+		free(copy);
+		return -1;
+	}
+	r->copy = copy;
+
+	if (!local)
+		return 0;
+
+	shard_pause();
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		struct shard *s = devs->shards[fd];
+		unsigned char *has;
+		int reads;
+
+		if (s == NULL)
+			continue;
+
+		has = evdev_caps(devs, fd);
+		if (has == NULL) {
+			evdev_remove(devs, efd, fd);
+			continue;
+		}
+		reads = ctx_binding_reads(&devs->tmpl, r->copy, has);
+		free(has);
+		if (!reads)
+			continue;
+
+		nstates = s->ctx.nstates;
+		if (ctx_add_states(&s->ctx, b->expr))
+			goto err;
+
+		if (query_evdev(fd, devs->patterns[fd], &s->ctx, NULL,
+					nstates, NULL) == -1) {
+			evdev_remove(devs, efd, fd);
+			continue;
+		}
+
+		copy = binding_copy(r->copy);
+		if (copy == NULL || ctx_bind(&s->ctx, copy, now)) {
+			free(copy);
+			goto err;
+		}
+	}
+	shard_resume();
+
+	return 0;
+
+err:
+	/* leave none of it behind in the shards it did make it into */
+	rule_unshard(r, devs);
+	shard_resume();
+	ctx_unbind(&devs->tmpl, r->copy);
+	r->copy = NULL;
+	return -1;
+}
+
+/* take r out of ctx, and out of devs if it went live there */
+static void rule_unbind(struct rule *r, struct context *ctx,
+		struct evdevs *devs)
+{
+	ctx_unbind(ctx, r->binding);
+
+	/* not live, or only in devs->coord */
+	if (r->copy == NULL || ctx_unbind(&devs->coord, r->copy) == 0)
+		goto out;
+
+	rule_unshard(r, devs);
+	ctx_unbind(&devs->tmpl, r->copy);
+
+out:
+	r->copy = NULL;
+}
+
+/*
+ * Parse the text of a rule into a binding of ctx.  With devs, it goes
+ * live as well, see rule_live().
+ */
+static int rule_bind(struct rule *r, struct context *ctx,
+		struct evdevs *devs, int efd)
+{
+	struct arena arena = { NULL, };
+	struct binding *parsed;
+	struct binding *b;
+	int rc = -1;
+
+	if (psr_parse(r->text, strlen(r->text), &arena, &parsed) ||
+			parsed == NULL || parsed->next != NULL)
+		goto out;
+
+	if (spawn_prepare(parsed->command) && errno == EINVAL)
+		goto out;
+
+	/* the parsed expression only has to last until it is compiled */
+	b = binding_copy(parsed);
+	if (b == NULL)
+		goto out;
+
+	if (ctx_add_states(ctx, b->expr) || ctx_bind(ctx, b, time_ms())) {
+		free(b);
+		goto out;
+	}
+
+	if (devs && rule_live(r, ctx, b, devs, efd)) {
+		ctx_unbind(ctx, b);
+		free(b);
+		goto out;
+	}
+
+	b->expr = NULL;
+	r->binding = b;
+	rc = 0;
+
+out:
+	arena_free(&arena);
+	return rc;
+}
+
+/* point the rules at their copies, after ctx was split into devs */
+static void rule_relink(struct config *cfg, struct evdevs *devs)
+{
+	for (unsigned int i = 0; i < cfg->nrules; ++i) {
+		struct rule *r = &cfg->rules[i];
+
+		r->copy = binding_find(&devs->coord, r->binding);
+		if (r->copy == NULL)
+			r->copy = binding_find(&devs->tmpl, r->binding);
+	}
+}
+
+static int rule_add(struct config *cfg, const char *name, const char *text)
+{
+	struct rule *rules;
+	struct rule *r;
+
+	rules = realloc(cfg->rules, (cfg->nrules + 1) * sizeof(*rules));
+	if (rules == NULL)
+		return -1;
+	cfg->rules = rules;
+
+	r = &cfg->rules[cfg->nrules];
+	r->name = strdup(name);
+	r->text = strdup(text);
+	r->binding = NULL;
+	r->copy = NULL;
+	if (r->name == NULL || r->text == NULL) {
+		free(r->name);
+		free(r->text);
+		return -1;
+	}
+	++cfg->nrules;
+
+	return 0;
+}
+
+static void rule_remove(struct config *cfg, unsigned int i)
+{
+	struct rule *r = &cfg->rules[i];
+
+	free(r->name);
+	free(r->text);
+	free(r->binding);
+	memmove(r, r + 1, (--cfg->nrules - i) * sizeof(*r));
+}
+
+static struct rule *rule_find(struct config *cfg, const char *name)
+{
+	for (unsigned int i = 0; i < cfg->nrules; ++i) {
+		if (!strcmp(cfg->rules[i].name, name))
+			return &cfg->rules[i];
+	}
+
+	return NULL;
+}
+
+/* bind the rules into ctx, a context about to replace the current one */
+static struct binding **rule_rebind(struct config *cfg, struct context *ctx)
+{
+	struct binding **old;
+
+	old = calloc(cfg->nrules + 1, sizeof(*old));
+	if (old == NULL)
+		err(1, "calloc");
+
+	for (unsigned int i = 0; i < cfg->nrules; ++i) {
+		struct rule *r = &cfg->rules[i];
+
+		old[i] = r->binding;
+		if (rule_bind(r, ctx, NULL, -1))
+			errx(1, "%s: failed to bind rule", r->name);
+	}
+
+	return old;
+}
+
+static void rule_free_bindings(struct binding **bindings, unsigned int n)
+{
+	for (unsigned int i = 0; i < n; ++i)
+		free(bindings[i]);
+	free(bindings);
+}
+
+/* take over the rules upgrade() wrote after the state, binding them */
+static void rule_restore(struct config *cfg, struct context *ctx, int mfd)
+{
+	struct stat st;
+	char *buf;
+	char *end;
+	char *p;
+	off_t off;
+
+	off = lseek(mfd, 0, SEEK_CUR);
+	if (off == -1 || fstat(mfd, &st) == -1 || st.st_size <= off)
+		return;
+
+	buf = malloc(st.st_size - off + 1);
+	if (buf == NULL)
+		err(1, "malloc");
+
+	end = buf + (st.st_size - off);
+	if (read(mfd, buf, end - buf) != end - buf) {
+		warn("reading rules");
+		free(buf);
+		return;
+	}
+	*end = '\0';
+
+	/* name and text pairs, each NUL terminated */
+	for (p = buf; p < end; p += strlen(p) + 1) {
+		const char *name = p;
+
+		p += strlen(p) + 1;
+		if (p >= end)
+			break;
+
+		if (rule_add(cfg, name, p))
+			err(1, "rule_add");
+		if (rule_bind(&cfg->rules[cfg->nrules - 1], ctx, NULL, -1)) {
+			warnx("%s: failed to bind rule", name);
+			rule_remove(cfg, cfg->nrules - 1);
+		}
+	}
+
+	free(buf);
+}
+
+#define CTL_LINE 4096
+
+struct ctl_client {
+	size_t len;
+	char buf[CTL_LINE];
+};
+
+/* the control socket, and its connections indexed by fd */
+struct ctl {
+	int fd;
+	struct ctl_client **clients;
+	unsigned int nclients;
+};
+
+static void ctl_open(struct ctl *ctl, const char *path, int efd)
+{
+	struct sockaddr_un addr = { AF_UNIX, };
+	struct stat st;
+	mode_t mask;
+	int rc;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+		errx(1, "%s: path too long", path);
+	strcpy(addr.sun_path, path);
+
+	ctl->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+			0);
+	if (ctl->fd == -1)
+		err(1, "socket");
+
+	/* a stale socket of an earlier run may go, anything else stays */
+	if (lstat(path, &st) == 0) {
+		if (!S_ISSOCK(st.st_mode))
+			errx(1, "%s: exists and is not a socket", path);
+		if (unlink(path) == -1)
+			err(1, "%s", path);
+	}
+
+	/* whoever can connect can run commands as us */
+	mask = umask(077);
+	rc = bind(ctl->fd, (struct sockaddr *)&addr, sizeof(addr));
+	umask(mask);
+	if (rc == -1)
+		err(1, "%s", path);
+
+	if (listen(ctl->fd, 8) == -1)
+		err(1, "listen");
+
+	epoll_add(efd, ctl->fd);
+}
+
+static int ctl_is_client(struct ctl *ctl, int fd)
+{
+	return fd < ctl->nclients && ctl->clients[fd] != NULL;
+}
+
+static void ctl_accept(struct ctl *ctl, int efd)
+{
+	int fd;
+
+	for (;;) {
+		fd = accept4(ctl->fd, NULL, NULL,
+				SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd == -1) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			if (errno != EAGAIN)
+				warn("accept");
+			return;
+		}
+
+		if (fd >= ctl->nclients) {
+			unsigned int n = fd + 16;
+			struct ctl_client **clients;
+
+			clients = realloc(ctl->clients, n * sizeof(*clients));
+			if (clients == NULL)
+				err(1, "realloc");
+			memset(clients + ctl->nclients, 0,
+					(n - ctl->nclients) * sizeof(*clients));
+			ctl->clients = clients;
+			ctl->nclients = n;
+		}
+
+		ctl->clients[fd] = calloc(1, sizeof(*ctl->clients[fd]));
+		if (ctl->clients[fd] == NULL)
+			err(1, "calloc");
+
+		epoll_add(efd, fd);
+	}
+}
+
+static void ctl_close(struct ctl *ctl, int fd, int efd)
+{
+	epoll_ctl(efd, EPOLL_CTL_DEL, fd, NULL);
+	close(fd);
+	free(ctl->clients[fd]);
+	ctl->clients[fd] = NULL;
+}
+
+static void ctl_reply(int fd, const char *fmt, ...)
+{
+	char buf[CTL_LINE + 64];
+	va_list ap;
+	int len;
 
-#define DEV_INPUT "/dev/input"
-#define DEF_CFG PREFIX_ETC "/evev"
+	va_start(ap, fmt);
+	len = vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
 
-extern char **environ;
+	if (len >= sizeof(buf))
+		len = sizeof(buf) - 1;
 
-enum {
-	FLAG_INFO	= (1 << 0),
-	FLAG_MONITOR	= (1 << 1),
-	FLAG_LOGGING	= (1 << 2),
-	FLAG_QUIET	= (1 << 3),
-};
+	/* a client not reading its replies only misses out on them */
+	send(fd, buf, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
 
-static int execute(const char *command)
+static const char *ctl_add(struct config *cfg, struct context *ctx,
+		struct evdevs *devs, int efd, const char *name, char *text)
 {
-	char *const args[] = {
-		"/bin/sh", "-c", (char *)command, NULL
-	};
-	pid_t pid;
+	struct rule nr = { (char *)name, text, };
+	struct rule *r;
+
+	/* bind the new rule first, so a bad one leaves the old in place */
+	if (rule_bind(&nr, ctx, devs, efd))
+		return "failed to add rule";
+
+	r = rule_find(cfg, name);
+	if (r == NULL) {
+		if (rule_add(cfg, name, text))
+			goto nomem;
+		r = &cfg->rules[cfg->nrules - 1];
+	} else {
+		text = strdup(text);
+		if (text == NULL)
+			goto nomem;
+		free(r->text);
+		r->text = text;
+
+		rule_unbind(r, ctx, devs);
+		free(r->binding);
+	}
+	r->binding = nr.binding;
+	r->copy = nr.copy;
 
-	return posix_spawn(&pid, args[0], NULL, NULL, args, environ);
+	return NULL;
+
+nomem:
+	rule_unbind(&nr, ctx, devs);
+	free(nr.binding);
+	return "out of memory";
 }
 
-static void mon_input_event(struct input_event *ev)
+static const char *ctl_del(struct config *cfg, struct context *ctx,
+		struct evdevs *devs, const char *name)
 {
-	const char *codep = NULL;
-	const char *typep = NULL;
-	char code[14];
-	char type[14];
+	struct rule *r;
 
-	if (ev->type < nametab_sz)
-		typep = nametab[ev->type].name;
+	r = rule_find(cfg, name);
+	if (r == NULL)
+		return "no such rule";
 
-	if (typep == NULL) {
-		sprintf(type, "%d", ev->code);
-		typep = type;
-	}
+	rule_unbind(r, ctx, devs);
+	rule_remove(cfg, r - cfg->rules);
 
-	if (nametab[ev->type].tab != NULL)
-		codep = nametab[ev->type].tab[ev->code];
+	return NULL;
+}
 
-	if (codep == NULL) {
-		sprintf(code, "%d", ev->code);
-		codep = code;
+static void ctl_stats(int fd)
+{
+	struct spawn_stats st;
+	unsigned int iter = 0;
+	char buf[20];
+
+	while (spawn_stats(&iter, &st) == 0) {
+		ctl_reply(fd, "%u %u %u %llu %s %s\n", st.running, st.runs,
+				st.failures, (unsigned long long)st.runtime,
+				exit_status(st.status, buf), st.command);
 	}
+}
 
-	printf("%s %s %d\n", typep, codep, ev->value);
+static void ctl_queue(int fd, const char *name, struct ring *r)
+{
+	if (r == NULL)
+		return;
+
+	ctl_reply(fd, "%s %u %u %u %u\n", name, ring_depth(r),
+			atomic_load(&r->peak), r->size, atomic_load(&r->full));
 }
 
-#define MAX_EV_CNT ((KEY_CNT + 31) / 32)
+/*
+ * Handle one line of the control protocol:
+ *   add <name> <rule>  add a rule, replacing any of the same name
+ *   del <name>         remove a rule
+ *   list               list the rules
+ *   stats              list commands, with their runs and failures
+ *   queues             list the queues of -t, with their depths
+ * Each is answered with "ok", or "error: <reason>".
+ */
+static void ctl_command(struct config *cfg, struct context *ctx,
+		struct evdevs *devs, int efd, int fd, char *line)
+{
+	const char *error;
+	char *name;
+	char *cmd;
+	char *p;
+
+	cmd = strtok_r(line, " \t", &p);
+	if (cmd == NULL) {
+		error = "empty command";
+	} else if (!strcmp(cmd, "list")) {
+		for (unsigned int i = 0; i < cfg->nrules; ++i)
+			ctl_reply(fd, "%s %s\n", cfg->rules[i].name,
+					cfg->rules[i].text);
+		error = NULL;
+	} else if (!strcmp(cmd, "stats")) {
+		ctl_stats(fd);
+		error = NULL;
+	} else if (!strcmp(cmd, "queues")) {
+		ctl_queue(fd, "read", reader_queue());
+		for (unsigned int i = 0; shard_queue(i); ++i) {
+			char queue[16];
+
+			sprintf(queue, "eval%u", i);
+			ctl_queue(fd, queue, shard_queue(i));
+		}
+		ctl_queue(fd, "launch", spawn_queue());
+		error = NULL;
+	} else if (strcmp(cmd, "add") && strcmp(cmd, "del")) {
+		error = "unknown command";
+	} else if ((name = strtok_r(NULL, " \t", &p)) == NULL) {
+		error = "missing name";
+	} else if (!strcmp(cmd, "add")) {
+		error = ctl_add(cfg, ctx, devs, efd, name,
+				p + strspn(p, " \t"));
+	} else {
+		error = ctl_del(cfg, ctx, devs, name);
+	}
 
-static int bitstate(u32 *buf, int bit)
+	if (error)
+		ctl_reply(fd, "error: %s\n", error);
+	else
+		ctl_reply(fd, "ok\n");
+}
+
+static void ctl_read(struct ctl *ctl, int fd, int efd, struct config *cfg,
+		struct context *ctx, struct evdevs *devs)
 {
-	return (buf[bit / 32] & (1 << (bit % 32))) != 0;
+	struct ctl_client *c = ctl->clients[fd];
+	char *nl;
+	ssize_t rc;
+
+	for (;;) {
+		rc = read(fd, c->buf + c->len, sizeof(c->buf) - c->len);
+		if (rc == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN)
+				ctl_close(ctl, fd, efd);
+			break;
+		}
+		if (rc == 0) {
+			ctl_close(ctl, fd, efd);
+			break;
+		}
+		c->len += rc;
+
+		while ((nl = memchr(c->buf, '\n', c->len)) != NULL) {
+			*nl = '\0';
+			ctl_command(cfg, ctx, devs, efd, fd, c->buf);
+			c->len -= nl + 1 - c->buf;
+			memmove(c->buf, nl + 1, c->len);
+		}
+
+		if (c->len == sizeof(c->buf)) {
+			ctl_reply(fd, "error: line too long\n");
+			ctl_close(ctl, fd, efd);
+			break;
+		}
+	}
 }
 
-static int open_evdev(const char *evdev, char **names, int nnames,
-		int flags, struct context *ctx)
+/*
+ * Switch to the configuration on disk if it changed.  Devices stay open
+ * and are only queried for states the current contexts do not track.
+ */
+static void reload_config(struct config *cfg, struct context *ctx,
+		struct evdevs *devs, int efd, int ifd,
+		char **names, int nnames, int flags)
 {
-	char dphys[128];
-	char dname[128];
-	int match = nnames == 0;
-	int fd;
-	int rc;
+	struct context **olds;
+	struct shard **shards;
+	struct binding **old;
+	struct context ocoord;
+	struct context otmpl;
+	struct context nctx;
+	unsigned int nolds;
+
+	/* fire anything due first, so the results carried over are current */
+	evdevs_timeout(devs, time_ms());
+
+	if (config_update(cfg, &nctx, flags) != 1)
+		return;
+
+	old = rule_rebind(cfg, &nctx);
+	ctx_free(ctx);
+	*ctx = nctx;
+
+	nolds = devs->npaths;
+	shards = calloc(nolds + 1, sizeof(*shards));
+	olds = calloc(nolds + 1, sizeof(*olds));
+	if (shards == NULL || olds == NULL)
+		err(1, "calloc");
+
+	shard_pause();
+
+	ocoord = devs->coord;
+	otmpl = devs->tmpl;
+	for (unsigned int fd = 0; fd < nolds; ++fd) {
+		shards[fd] = devs->shards[fd];
+		olds[fd] = shards[fd] ? &shards[fd]->ctx : NULL;
+		devs->shards[fd] = NULL;
+	}
 
-	fd = open(evdev, O_RDONLY);
-	if (fd == -1) {
-		if ((flags & FLAG_QUIET) == 0)
-			warn(evdev);
-		return -1;
+	evdevs_split(devs, ctx);
+	rule_relink(cfg, devs);
+	for (unsigned int fd = 0; devs->sharded && fd < devs->npaths; ++fd) {
+		if (devs->paths[fd] && evdev_shard(devs, fd))
+			evdev_remove(devs, efd, fd);
 	}
+	scan_evdevs(devs, efd, names, nnames, flags, ctx);
 
-	rc = ioctl(fd, EVIOCGPHYS(sizeof(dphys) - 1), dphys);
-	if (rc < 1) {
-		close(fd);
-		return -1;
+	evdevs_eval(devs, efd, &ocoord, olds, nolds);
+
+	for (unsigned int fd = 0; fd < nolds; ++fd) {
+		if (shards[fd])
+			shard_free(shards[fd]);
 	}
+	ctx_free(&ocoord);
+	ctx_free(&otmpl);
+	free(shards);
+	free(olds);
 
-	rc = ioctl(fd, EVIOCGNAME(sizeof(dname) - 1), dname);
-	if (rc < 1) {
-		close(fd);
-		return -1;
+	evdevs_start(devs);
+	shard_resume();
+
+	rule_free_bindings(old, cfg->nrules);
+	prepare_commands(ctx);
+
+	config_watch(cfg, ifd, flags);
+
+	if ((flags & FLAG_QUIET) == 0)
+		warnx("configuration reloaded");
+}
+#endif
+
+/*
+ * the runtime state upgrade() hands down, see state_load(): of coord, and
+ * of the shards, indexed by the fd of their device, the source it is
+ * saved with, or with HANDOVER_COORD for coord, which comes last
+ */
+struct handover {
+	struct context coord;
+	struct context **shards;
+	unsigned int nshards;
+};
+
+#define HANDOVER_COORD (~0u)
+
+static void handover_free(struct handover *h)
+{
+	for (unsigned int fd = 0; fd < h->nshards; ++fd) {
+		if (h->shards[fd])
+			ctx_free(h->shards[fd]);
+		free(h->shards[fd]);
 	}
+	free(h->shards);
+	ctx_free(&h->coord);
+}
 
-	for (unsigned int i = 0; i < nnames; ++i) {
-		const char *pattern;
-		const char *text;
-		int pflags = 0;
+static int handover_load(struct handover *h, int mfd)
+{
+	struct context **shards;
+	struct context old;
+	unsigned int source;
 
-		if (!strncmp(names[i], "phys=", 5)) {
-			pattern = names[i] + 5;
-			text = dphys;
-			pflags = FNM_PATHNAME;
-		} else if (!strncmp(names[i], "name=", 5)) {
-			pattern = names[i] + 5;
-			text = dname;
-		} else if (!strncmp(names[i], "dev=", 4)) {
-			pattern = names[i] + 4;
-			text = evdev;
-			pflags = FNM_PATHNAME;
-		} else {
-			pattern = names[i];
-			text = evdev;
-			pflags = FNM_PATHNAME;
+	memset(h, 0, sizeof(*h));
+
+	while (state_load(&old, &source, mfd) == 0) {
+		if (source == HANDOVER_COORD) {
+			h->coord = old;
+			return 0;
 		}
 
-		if (!fnmatch(pattern, text, pflags)) {
-			match = 1;
-			break;
+		if (source >= h->nshards) {
+			shards = realloc(h->shards,
+					(source + 1) * sizeof(*shards));
+			if (shards == NULL)
+				err(1, "realloc");
+			memset(shards + h->nshards, 0,
+					(source + 1 - h->nshards) *
+					sizeof(*shards));
+			h->shards = shards;
+			h->nshards = source + 1;
 		}
-	}
 
-	if (flags & FLAG_INFO) {
-		fprintf(stderr, "%s: phys=\"%s\" name=\"%s\" match=%s\n",
-				evdev, dphys, dname, match ? "yes" : "no");
+		h->shards[source] = malloc(sizeof(old));
+		if (h->shards[source] == NULL)
+			err(1, "malloc");
+		*h->shards[source] = old;
 	}
 
-	if ((flags & FLAG_MONITOR) == 0 && match && ctx) {
-		u32 states[MAX_EV_CNT];
-		u32 buf[MAX_EV_CNT];
-		int type = -1;
+	handover_free(h);
+	return -1;
+}
 
-		match = 0;
+/*
+ * Replace this process with a fresh start of argv, typically an upgraded
+ * binary.  The epoll instance and devices stay open across execve(), and
+ * the runtime state is passed in a memfd, so the new process carries on
+ * without querying the devices again.  Returns only if that failed.
+ */
+static void upgrade(char **argv, struct config *cfg, struct evdevs *devs,
+		int efd)
+{
+	char *env;
+	size_t len;
+	int mfd;
 
-		for (unsigned int i = 0; i < ctx->nstates; ++i) {
-			struct evstate *evs = &ctx->states[i];
+	/* run what is due now, rather than leaving it to the new process */
+	evdevs_timeout(devs, time_ms());
 
-			int ctype = evs->typecode >> 16;
-			int ccode = evs->typecode & 0xffff;
+	mfd = memfd_create("evev-state", 0);
+	if (mfd == -1) {
+		warn("memfd_create");
+		return;
+	}
 
-			if (ctype != type) {
-				unsigned int len = MAX_EV_CNT * sizeof(states[0]);
-				unsigned long ioc;
+	/* that of the shards, by device, and that of coord last */
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		if (devs->shards[fd] &&
+				state_save(&devs->shards[fd]->ctx, fd, mfd)) {
+			warn("saving state");
+			close(mfd);
+			return;
+		}
+	}
 
-				memset(buf, 0, sizeof(buf));
-				rc = ioctl(fd, EVIOCGBIT(ctype, len), buf);
-				if (rc < 1)
-					err(1, "EVIOCGBIT");
-
-				type = ctype;
-				switch (type) {
-				case EV_SW:  ioc = EVIOCGSW(len); break;
-				case EV_KEY: ioc = EVIOCGKEY(len); break;
-				case EV_SND: ioc = EVIOCGSND(len); break;
-				case EV_LED: ioc = EVIOCGLED(len); break;
-				default: ioc = 0; break;
-				}
+	if (state_save(&devs->coord, HANDOVER_COORD, mfd)) {
+		warn("saving state");
+		close(mfd);
+		return;
+	}
 
-				if (ioc != 0) {
-					memset(states, 0, sizeof(states));
-					rc = ioctl(fd, ioc, states);
-					if (rc < 1)
-						err(1, "EVIOCGstate");
-				}
-			}
+	/* followed by the rules added through the control socket */
+	for (unsigned int i = 0; i < cfg->nrules; ++i) {
+		if (dprintf(mfd, "%s%c%s%c", cfg->rules[i].name, '\0',
+					cfg->rules[i].text, '\0') < 0) {
+			warn("saving rules");
+			close(mfd);
+			return;
+		}
+	}
 
-			if (!bitstate(buf, ccode))
-				continue;
+	if (lseek(mfd, 0, SEEK_SET) == -1) {
+		warn("lseek");
+		close(mfd);
+		return;
+	}
 
-			match = 1;
-			switch (type) {
-			case EV_SW:
-			case EV_KEY:
-			case EV_SND:
-			case EV_LED:
-				evs->value = bitstate(states, ccode);
-				break;
-			case EV_ABS: {
-				struct input_absinfo ainfo;
-				rc = ioctl(fd, EVIOCGABS(ccode), &ainfo);
-				if (rc < 0)
-					err(1, "EVIOCGABS");
-				evs->value = ainfo.value;
-				} break;
-			default:
-				break;
-			}
-		}
+	len = 2 * 12 + devs->npaths * 12 + 1;
+	env = malloc(len);
+	if (env == NULL) {
+		warn("malloc");
+		close(mfd);
+		return;
+	}
 
-		if (!match && nnames != 0)
-			warnx("%s: no relevant events", evdev);
+	len = sprintf(env, "%d %d", mfd, efd);
+	for (unsigned int fd = 0; fd < devs->npaths; ++fd) {
+		if (devs->paths[fd])
+			len += sprintf(env + len, " %u", fd);
 	}
 
-	if (!match) {
-		close(fd);
-		return -1;
+	fflush(stdout);
+
+	if (setenv(EVEV_RESUME, env, 1) == 0)
+		execvp(argv[0], argv);
+	warn("%s", argv[0]);
+
+	unsetenv(EVEV_RESUME);
+	free(env);
+	close(mfd);
+}
+
+/*
+ * upgrade(), with the devices read in the event loop meanwhile: the next
+ * process has to find them in the epoll set, and what the reader thread
+ * already took from them would be lost otherwise.  The workers are
+ * through with what was queued to them, and hold still, meanwhile.
+ */
+static void restart(char **argv, struct config *cfg, struct evdevs *devs,
+		int efd, int flags)
+{
+	int threaded = devs->threaded;
+
+	if (threaded) {
+		evdev_thread(devs, efd, 0);
+		read_queue(devs, efd, flags);
 	}
 
-	return fd;
+	shard_pause();
+	upgrade(argv, cfg, devs, efd);
+	shard_resume();
+
+	if (threaded)
+		evdev_thread(devs, efd, 1);
 }
 
-static u64 time_ms(void)
+/*
+ * Take over what upgrade() handed down: returns the inherited epoll fd,
+ * with the devices registered in it tracked in devs, and their state in
+ * h, which is only valid if *have_old is set.
+ */
+static int resume(const char *env, struct config *cfg, struct context *ctx,
+		struct handover *h, int *have_old, struct evdevs *devs,
+		char **names, int nnames, int flags)
 {
-	struct timeval tv;
+	unsigned int pattern;
+	char link[64];
+	char path[PATH_MAX];
+	char *end;
+	ssize_t len;
+	long mfd;
+	long efd;
+	long fd;
+
+	mfd = strtol(env, &end, 10);
+	efd = strtol(end, &end, 10);
+	if (mfd < 0 || efd < 0 || end == env)
+		errx(1, "%s: malformed", EVEV_RESUME);
+
+	*have_old = handover_load(h, mfd) == 0;
+	if (!*have_old)
+		warnx("state from the previous instance is unusable; resyncing");
+#ifndef EVEV_STATIC
+	else if ((flags & FLAG_MONITOR) == 0)
+		rule_restore(cfg, ctx, mfd);
+#endif
+	close(mfd);
+
+	while (*end != '\0') {
+		fd = strtol(end, &end, 10);
+
+		snprintf(link, sizeof(link), "/proc/self/fd/%ld", fd);
+		len = readlink(link, path, sizeof(path) - 1);
+		if (len == -1)
+			len = 0;
+		path[len] = '\0';
+
+		pattern = evdev_pattern(match_evdev(fd, path, names, nnames,
+					flags & ~FLAG_INFO));
+		evdev_track(devs, fd, path, pattern);
+	}
 
-	gettimeofday(&tv, NULL);
-	return (u64)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+	return efd;
 }
 
-static void epoll_add(int efd, int fd)
+/*
+ * Keep the coprocess pipe in the epoll set, waiting for room to write
+ * only while something is queued; its exit shows up as EPOLLERR.  A
+ * restart closes the old pipe, taking it out of the set.
+ */
+static void coproc_watch(int efd, unsigned int *starts, u32 *events)
 {
-	struct epoll_event ev = {0,};
-	int rc;
+	struct epoll_event ev = { 0, };
+	int fd = coproc_fd();
+	int op = EPOLL_CTL_MOD;
 
-	ev.events = EPOLLIN;
+	if (fd == -1)
+		return;
+
+	ev.events = coproc_pending() ? EPOLLOUT : 0;
 	ev.data.fd = fd;
-	rc = epoll_ctl(efd, EPOLL_CTL_ADD, fd, &ev);
-	if (rc == -1)
+
+	if (coproc_starts() != *starts)
+		op = EPOLL_CTL_ADD;
+	else if (ev.events == *events)
+		return;
+
+	if (epoll_ctl(efd, op, fd, &ev) == -1)
 		err(1, "epoll_ctl");
+
+	*starts = coproc_starts();
+	*events = ev.events;
 }
 
-static void evev(char **names, int nnames, int flags,
-		const char *cfg, const char *cfgtext)
+static void evev(char **argv, char **names, int nnames, int flags,
+		struct config *cfg)
 {
-	struct epoll_event events[10];
-	struct binding **pbindings;
-	struct binding *bindings;
+	struct epoll_event events[MAX_READY];
+	struct evdevs devs = { NULL, };
+#ifndef EVEV_STATIC
+	struct ctl ctl = { -1, };
+#endif
+	struct handover old;
 	struct context ctx;
+	int have_old = 0;
+	unsigned int coproc_seen = 0;
+	u32 coproc_events = 0;
+	void (*done)(const char *, int, unsigned int) = NULL;
+	sigset_t sigmask;
+	char *env;
+	int reload = 0;
 	int polltime;
-	glob_t gr;
 	int wfd;
 	int ifd;
 	int efd;
+	int sfd;
 	int rc;
 	int fd;
 
-	bindings = NULL;
-	pbindings = &bindings;
-
-	if (nnames == 0 && (flags & FLAG_QUIET) == 0)
-		warnx("no input evdevs specified, resorting to all");
-
-	if (flags & FLAG_MONITOR) {
-		rc = GLOB_NOMATCH;
-	} else if (cfgtext) {
-		*pbindings = psr_parse(cfgtext);
-		if (*pbindings == NULL)
-			errx(1, "<cmdline>: failed parsing");
-		pbindings = &(*pbindings)->next;
-
-		rc = GLOB_NOMATCH;
-		if (cfg)
-			rc = glob(cfg, 0, NULL, &gr);
-	} else if (cfg) {
-		rc = glob(cfg, 0, NULL, &gr);
-	} else {
-		rc = glob(DEF_CFG "/*.cfg", 0, NULL, &gr);
+#ifndef EVEV_STATIC
+	if (flags & FLAG_GENERATE) {
+		load_config(cfg, &ctx, flags);
+		if (gen_static(&ctx, stdout) || fflush(stdout))
+			err(1, "stdout");
+		exit(0);
 	}
+#endif
 
-	if (rc == GLOB_NOSPACE)
-		errx(1, "glob: out of memory");
-	if (rc == GLOB_ABORTED)
-		errx(1, "glob: read error");
-	if (rc != GLOB_NOMATCH) {
-		for (unsigned int i = 0; gr.gl_pathv[i]; ++i) {
-			struct stat st;
-			char *mem;
+	env = getenv(EVEV_RESUME);
 
-			fd = open(gr.gl_pathv[i], O_RDONLY);
-			if (fd == -1)
-				err(1, gr.gl_pathv[i]);
+	if (flags & FLAG_LOGGING)
+		done = log_command;
 
-			rc = fstat(fd, &st);
-			if (rc == -1)
-				err(1, gr.gl_pathv[i]);
+	if (nnames == 0 && env == NULL && (flags & FLAG_QUIET) == 0)
+		warnx("no input evdevs specified, resorting to all");
 
-			mem = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-			if (mem == MAP_FAILED)
-				err(1, gr.gl_pathv[i]);
+	/* fork the shell helper while the image is still small */
+	if ((flags & FLAG_MONITOR) == 0 && spawn_init() &&
+			(flags & FLAG_QUIET) == 0)
+		warn("spawn helper");
+	spawn_limit(cfg->jobs);
 
-			*pbindings = psr_parse(mem);
-			if (*pbindings == NULL)
-				errx(1, "%s: failed parsing", gr.gl_pathv[i]);
+	if (cfg->coproc && coproc_init(cfg->coproc))
+		err(1, "%s", cfg->coproc);
 
-			pbindings = &(*pbindings)->next;
+	if (flags & FLAG_MONITOR) {
+		if (ctx_init(&ctx, NULL, 0))
+			errx(1, "failed to initialize context");
+	} else {
+		load_config(cfg, &ctx, flags);
+	}
 
-			munmap(mem, st.st_size);
+	if (env) {
+		env = strdup(env);
+		if (env == NULL)
+			err(1, "strdup");
+		unsetenv(EVEV_RESUME);
 
-			close(fd);
-		}
+		efd = resume(env, cfg, &ctx, &old, &have_old, &devs,
+				names, nnames, flags);
+		free(env);
+	} else {
+		efd = epoll_create1(0);
+		if (efd == -1)
+			err(1, "epoll_create1");
 	}
 
-	globfree(&gr);
+	devs.sharded = (flags & (FLAG_SHARDED | FLAG_MONITOR)) == FLAG_SHARDED;
+	evdevs_split(&devs, &ctx);
+	trigger.coord = &devs.coord;
+#ifndef EVEV_STATIC
+	rule_relink(cfg, &devs);
+#endif
+	for (unsigned int fd = 0; devs.sharded && fd < devs.npaths; ++fd) {
+		if (devs.paths[fd] && evdev_shard(&devs, fd))
+			evdev_remove(&devs, efd, fd);
+	}
 
-	if (bindings == NULL && (flags & FLAG_MONITOR) == 0)
-		errx(1, "no configs loaded; exiting");
+	sigemptyset(&sigmask);
+	sigaddset(&sigmask, SIGPIPE);
+	/* a coprocess exiting is noticed through EPIPE and EPOLLERR */
+	sigprocmask(SIG_BLOCK, &sigmask, NULL);
 
-	ctx_init(&ctx, bindings);
+	sigemptyset(&sigmask);
+	sigaddset(&sigmask, SIGCHLD);
+	sigaddset(&sigmask, SIGUSR2);
+	sigprocmask(SIG_BLOCK, &sigmask, NULL);
 
-	efd = epoll_create1(0);
-	if (efd == -1)
-		err(1, "epoll_create1");
+	sfd = signalfd(-1, &sigmask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (sfd == -1)
+		err(1, "signalfd");
 
-	ifd = inotify_init1(IN_NONBLOCK);
+	ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 	if (ifd == -1)
 		err(1, "inotify_init1");
 
@@ -327,112 +2391,147 @@ static void evev(char **names, int nnames, int flags,
 	if (wfd == -1)
 		err(1, DEV_INPUT);
 
+#ifndef EVEV_STATIC
+	if ((flags & FLAG_MONITOR) == 0)
+		config_watch(cfg, ifd, flags);
+
+	if (cfg->socket)
+		ctl_open(&ctl, cfg->socket, efd);
+#endif
+
 	epoll_add(efd, ifd);
+	epoll_add(efd, sfd);
+	if (spawn_fd() != -1)
+		epoll_add(efd, spawn_fd());
+
+	/* started with signals blocked, which the threads inherit */
+	if (flags & FLAG_PIPELINE) {
+		if (reader_start(READ_QUEUE))
+			err(1, "reader");
+		epoll_add(efd, reader_fd());
+		evdev_thread(&devs, efd, 1);
+
+		if (spawn_fd() != -1 && spawn_pipeline(LAUNCH_QUEUE) &&
+				(flags & FLAG_QUIET) == 0)
+			warn("launcher");
+	}
 
-	rc = glob(DEV_INPUT "/event*", 0, NULL, &gr);
-	if (rc == GLOB_NOSPACE)
-		errx(1, "glob: out of memory");
-	if (rc == GLOB_ABORTED)
-		errx(1, "glob: read error");
-	if (rc != GLOB_NOMATCH) {
-		for (unsigned int i = 0; gr.gl_pathv[i]; ++i) {
-			fd = open_evdev(gr.gl_pathv[i], names, nnames, flags, &ctx);
-			if (fd == -1)
-				continue;
+	scan_evdevs(&devs, efd, names, nnames, flags, &ctx);
 
-			epoll_add(efd, fd);
-		}
+	if ((flags & FLAG_MONITOR) == 0) {
+		prepare_commands(&ctx);
+		if (have_old)
+			evdevs_eval(&devs, efd, &old.coord, old.shards,
+					old.nshards);
+		else
+			evdevs_eval(&devs, efd, NULL, NULL, 0);
 	}
 
-	globfree(&gr);
+	if (have_old)
+		handover_free(&old);
 
-	if (flags & FLAG_MONITOR)
-		polltime = -1;
-	else
-		polltime = ctx_timeout(&ctx, execute, time_ms());
+	/* the shards were evaluated here so far, and are handed over now */
+	if (devs.sharded && (flags & FLAG_PIPELINE)) {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+		if (shard_start(n > 0 && n < EVAL_WORKERS ? n : EVAL_WORKERS,
+					EVAL_QUEUE, execute_fired))
+			err(1, "workers");
+		epoll_add(efd, shard_fd());
+		evdevs_start(&devs);
+	}
+
+	polltime = -1;
+	if ((flags & FLAG_MONITOR) == 0)
+		polltime = evdevs_timeout(&devs, time_ms());
+
+	/* children of a previous image may have exited meanwhile */
+	spawn_reap(done);
 
 	for (;;) {
+		int timeout = polltime;
 		int nfds;
 
-		nfds = epoll_wait(efd, events, ARRAY_SIZE(events), polltime);
+		spawn_expire();
+		rc = spawn_timeout();
+		if (rc != -1 && (timeout == -1 || rc < timeout))
+			timeout = rc;
+
+		coproc_watch(efd, &coproc_seen, &coproc_events);
+		rc = coproc_timeout();
+		if (rc != -1 && (timeout == -1 || rc < timeout))
+			timeout = rc;
+
+		nfds = epoll_wait(efd, events, ARRAY_SIZE(events), timeout);
 		if (nfds == -1 && errno != EINTR)
 			err(1, "epoll_wait");
 
 		if (nfds <= 0) {
+			if (coproc_timeout() == 0)
+				coproc_flush();
 			if ((flags & FLAG_MONITOR) == 0)
-				polltime = ctx_timeout(&ctx, execute, time_ms());
+				polltime = evdevs_timeout(&devs, time_ms());
 			continue;
 		}
 
-		polltime = -1;
 		for (unsigned int i = 0; i < nfds; ++i) {
-			int len;
-
 			fd = events[i].data.fd;
 			if (fd == ifd) {
-				struct inotify_event *ev;
-				char buffer[4096];
-
-				ev = (struct inotify_event *)buffer;
-				rc = read(fd, buffer, sizeof(*ev));
-				if (rc != sizeof(*ev))
-					errx(1, "short read");
-
-				if (!ev->len)
-					continue;
-
-				len = snprintf(buffer, sizeof(buffer),
-						"%s/", DEV_INPUT);
-				rc = read(fd, buffer + len, ev->len);
-				if (rc != ev->len)
-					errx(1, "short read");
-				buffer[rc + len] = 0;
-
-				fd = open_evdev(buffer, names, nnames, flags, NULL);
-				if (fd == -1)
-					continue;
-
-				epoll_add(efd, fd);
-			} else {
-				struct input_event ev;
-
-				rc = read(fd, &ev, sizeof(ev));
-				if (rc != sizeof(ev))
-					errx(1, "short read");
-
-				if (ev.type == EV_KEY && ev.value == 2) {
-					/* ignore key repeat */
-				} else if (flags & FLAG_MONITOR) {
-					mon_input_event(&ev);
-				} else {
-					u64 now;
-
-					if (flags & FLAG_LOGGING)
-						mon_input_event(&ev);
-
-					now = (u64)ev.time.tv_sec * 1000 +
-							ev.time.tv_usec / 1000;
-
-					rc = ctx_input_event(&ctx, execute,
-						expr_typecode(ev.type, ev.code),
-						ev.value, now);
-
-					if (rc > 0 && (polltime < 0 || rc < polltime))
-						polltime = rc;
+				reload |= read_inotify(ifd, wfd, &devs, efd,
+						names, nnames, flags);
+			} else if (fd == reader_fd()) {
+				read_queue(&devs, efd, flags);
+			} else if (fd == shard_fd()) {
+				shard_drain();
+			} else if (fd == spawn_fd()) {
+				spawn_reap(done);
+			} else if (fd == coproc_fd()) {
+				if (events[i].events & (EPOLLERR | EPOLLHUP))
+					coproc_check();
+				coproc_flush();
+			} else if (fd == sfd) {
+				struct signalfd_siginfo si;
+
+				while (read(sfd, &si, sizeof(si)) == sizeof(si)) {
+					if (si.ssi_signo == SIGCHLD)
+						spawn_reap(done);
+					else if (si.ssi_signo == SIGUSR2)
+						restart(argv, cfg, &devs, efd,
+								flags);
 				}
+#ifndef EVEV_STATIC
+			} else if (fd == ctl.fd) {
+				ctl_accept(&ctl, efd);
+			} else if (ctl_is_client(&ctl, fd)) {
+				ctl_read(&ctl, fd, efd, cfg, &ctx, &devs);
+#endif
+			} else if (fd < devs.npaths && devs.paths[fd]) {
+				rc = read_evdev(&devs, fd, flags);
+
+				if (rc == -1 || (events[i].events &
+						(EPOLLHUP | EPOLLERR)))
+					evdev_remove(&devs, efd, fd);
+			} else {
+				/* not ours to read; don't spin on it */
+				warnx("unexpected fd %d in the poll set", fd);
+				epoll_ctl(efd, EPOLL_CTL_DEL, fd, NULL);
 			}
 		}
-	}
-}
 
-static void handle_sigchld(int sig)
-{
-	wait(NULL);
-}
+#ifndef EVEV_STATIC
+		/* one reload per batch, however many files were touched */
+		if (reload && (flags & FLAG_MONITOR) == 0) {
+			reload_config(cfg, &ctx, &devs, efd, ifd,
+					names, nnames, flags);
+		}
+#endif
+		reload = 0;
 
-static struct sigaction sigchld_ign_nowait = {
-	.sa_handler = handle_sigchld,
-};
+		/* the events and commands handled may have armed timers */
+		if ((flags & FLAG_MONITOR) == 0)
+			polltime = evdevs_timeout(&devs, time_ms());
+	}
+}
 
 static void version(const char *name)
 {
@@ -451,9 +2550,18 @@ static void usage(const char *name)
 		"   Options:\n"
 		"	-m        monitor mode\n"
 		"	-l        enable logging\n"
+		"	-f        evaluate bindings once per event frame\n"
 		"	-I        output information about event devices\n"
+		"	-g        grab devices, keeping their events to evev\n"
 		"	-c <cfg>  config location (pattern)\n"
 		"	-e <txt>  inline configuration\n"
+		"	-C <file> compiled configuration cache\n"
+		"	-S <path> control socket\n"
+		"	-p <cmd>  coprocess fed by \"|\" rules\n"
+		"	-j <n>    run at most n commands at once\n"
+		"	-d        keep the state of each device apart\n"
+		"	-t        read, evaluate and launch commands in threads\n"
+		"	-G        output configuration as C for evev-static\n"
 		"	-q        disable non-fatal errors and warnings\n"
 		"	-h        this cruft\n"
 		"	-v        version info\n"
@@ -464,12 +2572,13 @@ static void usage(const char *name)
 
 int main(int argc, char **argv)
 {
-	const char *cfgtext = NULL;
-	const char *cfg = NULL;
+	struct config cfg = { NULL, };
+	unsigned long jobs;
 	int flags = 0;
+	char *end;
 	int rc;
 
-	while ((rc = getopt(argc, argv, "hvmlIc:e:q")) != -1) {
+	while ((rc = getopt(argc, argv, "hvmlfIgdtc:e:C:S:p:j:Gq")) != -1) {
 		switch (rc) {
 		case 'h':
 			usage(argv[0]);
@@ -483,17 +2592,53 @@ int main(int argc, char **argv)
 		case 'l':
 			flags |= FLAG_LOGGING;
 			break;
+		case 'f':
+			flags |= FLAG_FRAMED;
+			break;
 		case 'I':
 			flags |= FLAG_INFO;
 			break;
 		case 'q':
 			flags |= FLAG_QUIET;
 			break;
+		case 'g':
+			flags |= FLAG_GRAB;
+			break;
+		case 'd':
+			flags |= FLAG_SHARDED;
+			break;
+		case 't':
+			flags |= FLAG_PIPELINE;
+			break;
 		case 'c':
-			cfg = optarg;
+			cfg.pattern = optarg;
 			break;
 		case 'e':
-			cfgtext = optarg;
+			cfg.text = optarg;
+			break;
+		case 'C':
+			cfg.cache = optarg;
+			break;
+		case 'S':
+			cfg.socket = optarg;
+			flags |= FLAG_CONTROL;
+			break;
+		case 'p':
+			cfg.coproc = optarg;
+			break;
+		case 'j':
+			errno = 0;
+			jobs = strtoul(optarg, &end, 10);
+			if (!isdigit((unsigned char)*optarg) || *end != '\0' ||
+					errno || jobs > UINT_MAX) {
+				warnx("-j takes a number of commands");
+				usage(argv[0]);
+				return -1;
+			}
+			cfg.jobs = jobs;
+			break;
+		case 'G':
+			flags |= FLAG_GENERATE;
 			break;
 		default:
 			usage(argv[0]);
@@ -501,21 +2646,53 @@ int main(int argc, char **argv)
 		}
 	}
 
-	if ((flags & FLAG_MONITOR) == 0) {
-		sigaction(SIGCHLD, &sigchld_ign_nowait, NULL);
-	} else {
-		if (cfg) {
+#ifdef EVEV_STATIC
+	if (cfg.pattern || cfg.text || cfg.cache || cfg.socket ||
+			(flags & FLAG_GENERATE)) {
+		warnx("-c, -e, -C, -S & -G are unavailable; "
+				"configuration is built in");
+		usage(argv[0]);
+		return -1;
+	}
+#endif
+
+	if (flags & FLAG_GENERATE) {
+		if (flags & FLAG_MONITOR) {
+			warnx("-m & -G are mutually exclusive");
+			usage(argv[0]);
+			return -1;
+		}
+	} else if (flags & FLAG_MONITOR) {
+		if (cfg.pattern) {
 			warnx("-m & -c are mutually exclusive; try -l");
 			usage(argv[0]);
 			return -1;
 		}
 
-		if (cfgtext) {
+		if (cfg.text) {
 			warnx("-m & -e are mutually exclusive; try -l");
 			usage(argv[0]);
 			return -1;
 		}
 
+		if (cfg.cache) {
+			warnx("-m & -C are mutually exclusive");
+			usage(argv[0]);
+			return -1;
+		}
+
+		if (cfg.socket) {
+			warnx("-m & -S are mutually exclusive");
+			usage(argv[0]);
+			return -1;
+		}
+
+		if (cfg.coproc) {
+			warnx("-m & -p are mutually exclusive");
+			usage(argv[0]);
+			return -1;
+		}
+
 		if (flags & FLAG_LOGGING) {
 			warnx("-m & -l are mutually exclusive");
 			usage(argv[0]);
@@ -523,7 +2700,10 @@ int main(int argc, char **argv)
 		}
 	}
 
-	evev(argv + optind, argc - optind, flags, cfg, cfgtext);
+	if (flags & FLAG_FRAMED)
+		cfg.cflags = CTX_FRAMED;
+
+	evev(argv, argv + optind, argc - optind, flags, &cfg);
 
 	return 0;
 }
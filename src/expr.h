@@ -49,8 +49,9 @@ struct expr {
 	};
 };
 
-struct expr *expr_new(void);
-void expr_free(struct expr *e);
+struct arena;
+
+struct expr *expr_new(struct arena *arena);
 int expr_cmp(struct expr_match *m, int value);
 
 static inline unsigned int expr_typecode(unsigned int type, unsigned int code)
@@ -58,4 +59,28 @@ static inline unsigned int expr_typecode(unsigned int type, unsigned int code)
 	return (type << 16) | code;
 }
 
+/*
+ * Events qualified by device, "ABS_X@2", are tracked apart from the rest:
+ * device n, counting from 1, goes above the 5 bits of the type.  The last
+ * of them, "ABS_X@*", stands for any device.
+ */
+#define EXPR_DEVICES 32
+#define EXPR_ANY (EXPR_DEVICES - 1)
+
+static inline unsigned int expr_qualify(unsigned int typecode,
+		unsigned int device)
+{
+	return typecode | (device << 21);
+}
+
+static inline unsigned int expr_device(unsigned int typecode)
+{
+	return typecode >> 21;
+}
+
+static inline unsigned int expr_type(unsigned int typecode)
+{
+	return (typecode >> 16) & 0x1f;
+}
+
 #endif
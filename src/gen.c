@@ -0,0 +1,417 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "context.h"
+#include "gen.h"
+
+static const char *gen_cmp_name(enum expr_cmp cmp)
+{
+	switch (cmp) {
+	case EXPR_EQ: return "EXPR_EQ";
+	case EXPR_NE: return "EXPR_NE";
+	case EXPR_LT: return "EXPR_LT";
+	case EXPR_GT: return "EXPR_GT";
+	case EXPR_LE: return "EXPR_LE";
+	case EXPR_GE: return "EXPR_GE";
+	}
+
+	return "EXPR_EQ";
+}
+
+static void gen_string(FILE *fp, const char *s)
+{
+	fputc('"', fp);
+	for (; *s; ++s) {
+		if (*s == '"' || *s == '\\')
+			fprintf(fp, "\\%c", *s);
+		else if (isprint((unsigned char)*s))
+			fputc(*s, fp);
+		else
+			fprintf(fp, "\\%03o", (unsigned char)*s);
+	}
+	fputc('"', fp);
+}
+
+static void gen_uints(FILE *fp, const char *name,
+		const unsigned int *v, unsigned int n)
+{
+	fprintf(fp, "static unsigned int %s[%u] = {", name, n + 1);
+	for (unsigned int i = 0; i < n; ++i)
+		fprintf(fp, "%s%#x,", i % 8 ? " " : "\n\t", v[i]);
+	fprintf(fp, "\n};\n\n");
+}
+
+static void gen_insn(FILE *fp, const struct insn *in)
+{
+	static const char *ops[] = {
+		[INSN_OR] = "INSN_OR",
+		[INSN_XOR] = "INSN_XOR",
+		[INSN_AND] = "INSN_AND",
+		[INSN_NOT] = "INSN_NOT",
+		[INSN_DUR] = "INSN_DUR",
+		[INSN_CMP] = "INSN_CMP",
+	};
+
+	fprintf(fp, "\t{ .op = %s, .users = %u, .nusers = %u, ",
+			ops[in->op], in->users, in->nusers);
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		fprintf(fp, ".binop = { %u, %u } },\n",
+				in->binop.left, in->binop.right);
+		break;
+	case INSN_NOT:
+		fprintf(fp, ".not = %u },\n", in->not);
+		break;
+	case INSN_DUR:
+		fprintf(fp, ".dur = { .expr = %u, .duration = %u, "
+				".slot = -1 } },\n",
+				in->dur.expr, in->dur.duration);
+		break;
+	case INSN_CMP:
+		fprintf(fp, ".cmp = { %u, %s, %d } },\n",
+				in->cmp.lookup, gen_cmp_name(in->cmp.cmp),
+				in->cmp.value);
+		break;
+	}
+}
+
+static const char *gen_cmp_op(enum expr_cmp cmp)
+{
+	switch (cmp) {
+	case EXPR_EQ: return "==";
+	case EXPR_NE: return "!=";
+	case EXPR_LT: return "<";
+	case EXPR_GT: return ">";
+	case EXPR_LE: return "<=";
+	case EXPR_GE: return ">=";
+	}
+
+	return "==";
+}
+
+/* append the instructions i depends on, and i, in evaluation order */
+static void gen_closure(const struct context *ctx, unsigned int i,
+		unsigned int *seen, unsigned int tag,
+		unsigned int *order, unsigned int *n)
+{
+	const struct insn *in = &ctx->insns[i];
+
+	if (seen[i] == tag)
+		return;
+	seen[i] = tag;
+
+	switch (in->op) {
+	case INSN_OR:
+	case INSN_XOR:
+	case INSN_AND:
+		gen_closure(ctx, in->binop.left, seen, tag, order, n);
+		gen_closure(ctx, in->binop.right, seen, tag, order, n);
+		break;
+	case INSN_NOT:
+		gen_closure(ctx, in->not, seen, tag, order, n);
+		break;
+	case INSN_DUR:
+		gen_closure(ctx, in->dur.expr, seen, tag, order, n);
+		break;
+	case INSN_CMP:
+		break;
+	}
+
+	order[(*n)++] = i;
+}
+
+/* the expression of a binding rooted at root, evaluated straight through */
+static void gen_root(FILE *fp, const struct context *ctx, unsigned int root,
+		const unsigned int *order, unsigned int n)
+{
+	int cmp = 0;
+
+	for (unsigned int k = 0; k < n; ++k)
+		cmp |= ctx->insns[order[k]].op == INSN_CMP;
+
+	/* contexts copied by ctx_subset() have arrays of their own */
+	fprintf(fp, "static int root_%u(struct context *ctx, u64 now)\n{\n",
+			root);
+	fprintf(fp, "\tunsigned char *results = ctx->results;\n");
+	if (cmp)
+		fprintf(fp, "\tconst int *values = ctx->values;\n");
+	fprintf(fp, "\n");
+
+	for (unsigned int k = 0; k < n; ++k) {
+		unsigned int i = order[k];
+		const struct insn *in = &ctx->insns[i];
+
+		fprintf(fp, "\tresults[%u] = ", i);
+		switch (in->op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			fprintf(fp, "results[%u] %s results[%u];\n",
+					in->binop.left,
+					in->op == INSN_OR ? "|" :
+					in->op == INSN_XOR ? "^" : "&",
+					in->binop.right);
+			break;
+		case INSN_NOT:
+			fprintf(fp, "!results[%u];\n", in->not);
+			break;
+		case INSN_DUR:
+			fprintf(fp, "ctx_dur_eval(ctx, %u, now);\n", i);
+			break;
+		case INSN_CMP:
+			fprintf(fp, "values[%u] %s %d;\n", in->cmp.lookup,
+					gen_cmp_op(in->cmp.cmp),
+					in->cmp.value);
+			break;
+		}
+	}
+
+	fprintf(fp, "\n\treturn results[%u];\n}\n\n", root);
+}
+
+/*
+ * Emit the evaluation functions of the bindings, and which of them to
+ * evaluate when a state or a timer changes: for key k, a state index or
+ * nstates plus an INSN_DUR instruction index, pairs holds (k, binding).
+ */
+static int gen_eval(FILE *fp, struct context *ctx)
+{
+	unsigned int nkeys = ctx->nstates + ctx->ninsns;
+	unsigned int *pairs = NULL;
+	unsigned int npairs = 0;
+	unsigned int maxpairs = 0;
+	unsigned int *offsets;
+	unsigned int *order;
+	unsigned int *seen;
+	unsigned int *last;
+	unsigned int *done;
+	unsigned int *lists = NULL;
+	int rc = -1;
+
+	offsets = calloc(nkeys + 1, sizeof(*offsets));
+	order = calloc(ctx->ninsns + 1, sizeof(*order));
+	seen = calloc(ctx->ninsns + 1, sizeof(*seen));
+	last = calloc(nkeys + 1, sizeof(*last));
+	done = calloc(ctx->ninsns + 1, sizeof(*done));
+	if (offsets == NULL || order == NULL || seen == NULL ||
+			last == NULL || done == NULL)
+		goto out;
+
+	for (unsigned int b = 0; b < ctx->nbindings; ++b) {
+		unsigned int root = ctx->bindv[b]->root;
+		unsigned int n = 0;
+
+		gen_closure(ctx, root, seen, b + 1, order, &n);
+		if (!done[root])
+			gen_root(fp, ctx, root, order, n);
+		done[root] = 1;
+
+		for (unsigned int k = 0; k < n; ++k) {
+			const struct insn *in = &ctx->insns[order[k]];
+			unsigned int key;
+
+			if (in->op == INSN_CMP)
+				key = in->cmp.lookup;
+			else if (in->op == INSN_DUR)
+				key = ctx->nstates + order[k];
+			else
+				continue;
+
+			if (last[key] == b + 1)
+				continue;
+			last[key] = b + 1;
+
+			if (npairs == maxpairs) {
+				unsigned int *p;
+
+				maxpairs = maxpairs ? maxpairs * 2 : 256;
+				p = realloc(pairs, maxpairs * 2 * sizeof(*p));
+				if (p == NULL)
+					goto out;
+				pairs = p;
+			}
+			pairs[npairs * 2] = key;
+			pairs[npairs * 2 + 1] = b;
+			++npairs;
+			++offsets[key];
+		}
+	}
+
+	fprintf(fp, "static int (*const eval[%u])(struct context *ctx, "
+			"u64 now) = {\n", ctx->nbindings + 1);
+	for (unsigned int b = 0; b < ctx->nbindings; ++b)
+		fprintf(fp, "\troot_%u,\n", ctx->bindv[b]->root);
+	fprintf(fp, "};\n\n");
+
+	/* every list is its bindings, followed by -1 */
+	for (unsigned int key = 0, off = 0; key < nkeys; ++key) {
+		unsigned int n = offsets[key];
+
+		offsets[key] = off;
+		off += n + 1;
+	}
+
+	lists = malloc((npairs + nkeys + 1) * sizeof(*lists));
+	if (lists == NULL)
+		goto out;
+	memset(lists, 0xff, (npairs + nkeys + 1) * sizeof(*lists));
+
+	/* last[] now counts the bindings placed in each list */
+	memset(last, 0, (nkeys + 1) * sizeof(*last));
+	for (unsigned int p = 0; p < npairs; ++p) {
+		unsigned int key = pairs[p * 2];
+
+		lists[offsets[key] + last[key]++] = pairs[p * 2 + 1];
+	}
+
+	gen_uints(fp, "lists", lists, npairs + nkeys);
+	gen_uints(fp, "gen_states", offsets, ctx->nstates);
+	gen_uints(fp, "gen_durations", offsets + ctx->nstates, ctx->ninsns);
+
+	fprintf(fp, "static unsigned char marked[%u];\n",
+			ctx->nbindings + 1);
+	fprintf(fp, "static unsigned int pending[%u];\n\n",
+			ctx->nbindings + 1);
+
+	fprintf(fp, "static struct ctx_gen gen = {\n");
+	fprintf(fp, "\t.eval = eval,\n");
+	fprintf(fp, "\t.states = gen_states,\n");
+	fprintf(fp, "\t.durations = gen_durations,\n");
+	fprintf(fp, "\t.lists = lists,\n");
+	fprintf(fp, "\t.marked = marked,\n");
+	fprintf(fp, "\t.pending = pending,\n");
+	fprintf(fp, "};\n\n");
+
+	rc = 0;
+
+out:
+	free(lists);
+	free(pairs);
+	free(done);
+	free(last);
+	free(seen);
+	free(order);
+	free(offsets);
+	return rc;
+}
+
+/*
+ * Emit a translation unit holding a fully resolved context in static
+ * storage, along with ctx_static() to hook it up.  The bindings are not
+ * interpreted, but evaluated by functions of their own.
+ */
+int gen_static(struct context *ctx, FILE *fp)
+{
+	unsigned int ndurations = 0;
+
+	fprintf(fp, "/* generated by evev -G; do not edit */\n\n");
+	fprintf(fp, "#include <string.h>\n\n");
+	fprintf(fp, "#include \"context.h\"\n\n");
+
+	fprintf(fp, "static struct evstate states[%u] = {\n", ctx->nstates + 1);
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		const struct evstate *evs = &ctx->states[i];
+
+		fprintf(fp, "\t{ .typecode = %#x, .listeners = %u, "
+				".nlisteners = %u },\n",
+				evs->typecode, evs->listeners, evs->nlisteners);
+	}
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "static int values[%u];\n\n", ctx->nstates + 1);
+
+	gen_uints(fp, "listeners", ctx->listeners, ctx->nlisteners);
+
+	for (unsigned int type = 0; type < CTX_LOOKUPS; ++type) {
+		unsigned int n = ctx->nlookup[type];
+
+		if (n == 0)
+			continue;
+
+		fprintf(fp, "static unsigned short lookup_%u[%u] = {",
+				type, n);
+		for (unsigned int i = 0; i < n; ++i) {
+			fprintf(fp, "%s%#x,", i % 8 ? " " : "\n\t",
+					ctx->lookup[type][i]);
+		}
+		fprintf(fp, "\n};\n\n");
+	}
+
+	fprintf(fp, "static struct insn insns[%u] = {\n", ctx->ninsns + 1);
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		gen_insn(fp, &ctx->insns[i]);
+		if (ctx->insns[i].op == INSN_DUR)
+			++ndurations;
+	}
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "static unsigned char results[%u];\n", ctx->ninsns + 1);
+	fprintf(fp, "static unsigned char queued[%u];\n", ctx->ninsns + 1);
+	fprintf(fp, "static unsigned int dirty[%u];\n", ctx->ninsns + 1);
+	fprintf(fp, "static unsigned int durations[%u];\n\n", ndurations + 1);
+
+	gen_uints(fp, "users", ctx->users, ctx->nusers);
+
+	for (unsigned int i = ctx->nbindings; i-- > 0; ) {
+		const struct binding *b = ctx->bindv[i];
+
+		fprintf(fp, "static struct binding binding_%u = {\n", i);
+		fprintf(fp, "\t.root = %u,\n", b->root);
+		if (i + 1 < ctx->nbindings)
+			fprintf(fp, "\t.next = &binding_%u,\n", i + 1);
+		fprintf(fp, "\t.command = ");
+		gen_string(fp, b->command);
+		fprintf(fp, ",\n};\n\n");
+	}
+
+	fprintf(fp, "static struct binding *bindv[%u] = {\n",
+			ctx->nbindings + 1);
+	for (unsigned int i = 0; i < ctx->nbindings; ++i)
+		fprintf(fp, "\t&binding_%u,\n", i);
+	fprintf(fp, "};\n\n");
+
+	if (gen_eval(fp, ctx))
+		return -1;
+
+	fprintf(fp, "void ctx_static(struct context *ctx, unsigned int flags)\n");
+	fprintf(fp, "{\n");
+	fprintf(fp, "\tmemset(ctx, 0, sizeof(*ctx));\n");
+	fprintf(fp, "\tctx->flags = flags;\n\n");
+	fprintf(fp, "\tctx->states = states;\n");
+	fprintf(fp, "\tctx->values = values;\n");
+	fprintf(fp, "\tctx->nstates = %u;\n", ctx->nstates);
+	fprintf(fp, "\tctx->listeners = listeners;\n");
+	fprintf(fp, "\tctx->nlisteners = %u;\n", ctx->nlisteners);
+	fprintf(fp, "\tctx->bindings = %s;\n",
+			ctx->nbindings ? "&binding_0" : "NULL");
+	fprintf(fp, "\tctx->bindv = bindv;\n");
+	fprintf(fp, "\tctx->nbindings = %u;\n\n", ctx->nbindings);
+	for (unsigned int type = 0; type < CTX_LOOKUPS; ++type) {
+		if (ctx->nlookup[type] == 0)
+			continue;
+		fprintf(fp, "\tctx->lookup[%u] = lookup_%u;\n", type, type);
+		fprintf(fp, "\tctx->nlookup[%u] = %u;\n",
+				type, ctx->nlookup[type]);
+	}
+	fprintf(fp, "\n");
+	fprintf(fp, "\tctx->gen = &gen;\n");
+	fprintf(fp, "\tctx->insns = insns;\n");
+	fprintf(fp, "\tctx->results = results;\n");
+	fprintf(fp, "\tctx->queued = queued;\n");
+	fprintf(fp, "\tctx->ninsns = %u;\n", ctx->ninsns);
+	fprintf(fp, "\tctx->users = users;\n");
+	fprintf(fp, "\tctx->nusers = %u;\n", ctx->nusers);
+	fprintf(fp, "\tctx->dirty = dirty;\n");
+	fprintf(fp, "\tctx->durations = durations;\n");
+	fprintf(fp, "}\n");
+
+	return ferror(fp) ? -1 : 0;
+}
@@ -0,0 +1,9 @@
+#ifndef __GEN_H_
+#define __GEN_H_
+
+#include <stdio.h>
+
+struct context;
+int gen_static(struct context *ctx, FILE *fp);
+
+#endif
@@ -5,63 +5,114 @@
 #include <string.h>
 #include <ctype.h>
 
+#include "arena.h"
 #include "context.h"
 #include "parser.h"
 #include "tables.h"
 #include "types.h"
 #include "expr.h"
 
-static int psr_comment(const char **pdata)
+/*
+ * Parser cursor.  Input is bounded by end rather than NUL terminated, so
+ * that mmapped files can be parsed in place; a NUL byte still ends the
+ * input early.  Rules backtrack by working on a copy of the cursor and
+ * only writing it back on success.
+ */
+struct psr {
+	const char *data;
+	const char *end;
+	struct arena *arena;
+};
+
+static int psr_peek(const struct psr *ps, size_t off)
 {
-	const char *data = *pdata;
-
-	if (data[0] != '#')
+	if ((size_t)(ps->end - ps->data) <= off)
 		return 0;
 
-	while (*data && *data != '\n')
-		++data;
+	return (unsigned char)ps->data[off];
+}
+
+static int psr_match(struct psr *ps, const char *str)
+{
+	size_t len = strlen(str);
 
-	if (*data)
-		++data;
+	if ((size_t)(ps->end - ps->data) < len || memcmp(ps->data, str, len))
+		return 0;
 
-	*pdata = data;
+	ps->data += len;
 
 	return 1;
 }
 
-static void psr_whitespace(const char **pdata)
+static int psr_comment(struct psr *ps)
 {
-	const char *data = *pdata;
+	if (psr_peek(ps, 0) != '#')
+		return 0;
+
+	while (psr_peek(ps, 0) && psr_peek(ps, 0) != '\n')
+		++ps->data;
+
+	if (psr_peek(ps, 0))
+		++ps->data;
+
+	return 1;
+}
 
+static void psr_whitespace(struct psr *ps)
+{
 	do {
-		while (isspace(*data))
-			++data;
-	} while (psr_comment(&data));
+		while (isspace(psr_peek(ps, 0)))
+			++ps->data;
+	} while (psr_comment(ps));
+}
+
+static int psr_consume_char(struct psr *ps, int ch)
+{
+	if (psr_peek(ps, 0) != ch)
+		return -1;
+
+	++ps->data;
+	psr_whitespace(ps);
 
-	*pdata = data;
+	return 0;
 }
 
-static int psr_consume_char(const char **pdata, int ch)
+/* strtol() over the bounded input */
+static int psr_number(struct psr *ps, int base, long *value)
 {
-	const char *data = *pdata;
+	size_t skip = 0;
+	size_t len = 0;
+	char buf[32];
+	char *ep;
+	int ch;
+
+	while (isspace(psr_peek(ps, skip)))
+		++skip;
+
+	while (len < sizeof(buf) - 1) {
+		ch = psr_peek(ps, skip + len);
+		if (!isalnum(ch) && !(len == 0 && (ch == '-' || ch == '+')))
+			break;
+		buf[len++] = ch;
+	}
+	buf[len] = 0;
 
-	if (data[0] != ch)
+	*value = strtol(buf, &ep, base);
+	if (ep == buf)
 		return -1;
 
-	++data;
-	psr_whitespace(&data);
-	*pdata = data;
+	ps->data += skip + (ep - buf);
 
 	return 0;
 }
 
-static struct expr *psr_any_of(const char **pdata,
-		struct expr *(*fns[])(const char **pdata), int nfns)
+static struct expr *psr_any_of(struct psr *ps,
+		struct expr *(*fns[])(struct psr *ps), int nfns)
 {
 	struct expr *c;
 
 	for (int i = 0; i < nfns; ++i) {
-		c = fns[i](pdata);
+		c = fns[i](ps);
 		if (c != NULL)
 			return c;
 	}
@@ -69,12 +120,12 @@ static struct expr *psr_any_of(const char **pdata,
 	return NULL;
 }
 
-static struct expr *psr_binop_expr(enum expr_type t,
+static struct expr *psr_binop_expr(struct psr *ps, enum expr_type t,
 		struct expr *l, struct expr *r)
 {
 	struct expr *c;
 
-	c = expr_new();
+	c = expr_new(ps->arena);
 	if (c == NULL)
 		return NULL;
 
@@ -86,194 +137,177 @@ static struct expr *psr_binop_expr(enum expr_type t,
 	return c;
 }
 
-static struct expr *psr_seq(const char **pdata, int ch,
-		enum expr_type type, struct expr *(* fn)(const char **pdata))
+static struct expr *psr_seq(struct psr *ps, int ch,
+		enum expr_type type, struct expr *(* fn)(struct psr *ps))
 {
 	struct expr *c;
 
-	c = fn(pdata);
+	c = fn(ps);
 	while (c) {
-		const char *data = *pdata;
+		struct psr s = *ps;
 		struct expr *r;
 
-		if (psr_consume_char(&data, ch))
+		if (psr_consume_char(&s, ch))
 			break;
-		r = fn(&data);
-		if (r) {
-			*pdata = data;
-			c = psr_binop_expr(type, c, r);
-		}
+		r = fn(&s);
+		if (r == NULL)
+			break;
+
+		*ps = s;
+		c = psr_binop_expr(ps, type, c, r);
 	}
 
 	return c;
 }
 
-static unsigned int psr_duration(const char **pdata)
+static unsigned int psr_duration(struct psr *ps)
 {
-	const char *data = *pdata;
+	struct psr s = *ps;
 	unsigned int dur;
-	char *ep;
+	long value;
 
-	if (psr_consume_char(&data, '['))
+	if (psr_consume_char(&s, '['))
 		return 0;
 
-	dur = strtoul(data, &ep, 10);
-	data = ep;
+	if (psr_number(&s, 10, &value))
+		value = 0;
+	dur = value;
 
-	if (!strncmp(data, "s", 1)) {
+	if (psr_match(&s, "s"))
 		dur *= 1000;
-		data += 1;
-	} else if (!strncmp(data, "ms", 2)) {
-		data += 2;
-	}
+	else
+		psr_match(&s, "ms");
 
-	if (psr_consume_char(&data, ']'))
+	if (psr_consume_char(&s, ']'))
 		return 0;
 
-	*pdata = data;
+	*ps = s;
 
 	return dur;
 }
 
-static struct expr *psr_expr_any(const char **pdata);
+static struct expr *psr_expr_any(struct psr *ps);
 
-static struct expr *psr_expr_group(const char **pdata)
+static struct expr *psr_expr_group(struct psr *ps)
 {
-	const char *data = *pdata;
+	struct psr s = *ps;
 	struct expr *c;
 
-	if (psr_consume_char(&data, '('))
+	if (psr_consume_char(&s, '('))
 		return NULL;
 
-	c = psr_expr_any(&data);
+	c = psr_expr_any(&s);
 	if (c == NULL)
 		return NULL;
 
-	if (psr_consume_char(&data, ')')) {
-		expr_free(c);
+	if (psr_consume_char(&s, ')'))
 		return NULL;
-	}
 
-	*pdata = data;
+	*ps = s;
 
 	return c;
 }
 
-static int psr_expr_ctab_lookup(const char **pdata, struct expr_match *m)
+static int psr_expr_ctab_lookup(struct psr *ps, struct expr_match *m)
 {
-	const char *data = *pdata;
-	unsigned int h = codetab_sz;
-	unsigned int l = 0;
-	unsigned int mlen = 0;
+	static const struct {
+		const char *name;
+		enum expr_cmp cmp;
+	} cmps[] = {
+		{ "eq", EXPR_EQ }, { "ne", EXPR_NE },
+		{ "lt", EXPR_LT }, { "gt", EXPR_GT },
+		{ "le", EXPR_LE }, { "ge", EXPR_GE },
+	};
+	struct psr s = *ps;
+	unsigned int len = 0;
 	const struct code_entry *e;
-	char buf[64];
-
-	while (mlen < sizeof(buf) - 1 && data[mlen] &&
-			(data[mlen] == '_' || isalnum(data[mlen]))) {
-		buf[mlen] = data[mlen];
-		++mlen;
-	}
-	buf[mlen] = 0;
-
-	while (l < h) {
-		unsigned int m = l + ((h - l) >> 1);
-		int c;
+	long value;
 
-		e = &codetab[m];
-		c = strcmp(buf, e->name);
+	while (psr_peek(&s, len) == '_' || isalnum(psr_peek(&s, len)))
+		++len;
 
-		if (c < 0)
-			h = m;
-		else if (c > 0)
-			l = m + 1;
-		else
-			break;
-	}
-	if (l >= h)
+	e = code_lookup(s.data, len);
+	if (e == NULL)
 		return -1;
 
 	m->lookup = expr_typecode(e->type, e->code);
-	data += strlen(e->name);
-	psr_whitespace(&data);
-	if (!psr_consume_char(&data, ':')) {
-		char *ep;
-
-		if (!strncmp(data, "eq", 2)) {
-			m->cmp = EXPR_EQ;
-			data += 2;
-		} else if (!strncmp(data, "ne", 2)) {
-			m->cmp = EXPR_NE;
-			data += 2;
-		} else if (!strncmp(data, "lt", 2)) {
-			m->cmp = EXPR_LT;
-			data += 2;
-		} else if (!strncmp(data, "gt", 2)) {
-			m->cmp = EXPR_GT;
-			data += 2;
-		} else if (!strncmp(data, "le", 2)) {
-			m->cmp = EXPR_LE;
-			data += 2;
-		} else if (!strncmp(data, "ge", 2)) {
-			m->cmp = EXPR_GE;
-			data += 2;
-		} else {
-			m->cmp = EXPR_EQ;
+	s.data += len;
+	psr_whitespace(&s);
+
+	/* only as seen on devices matching the given pattern */
+	if (!psr_consume_char(&s, '@')) {
+		if (!psr_consume_char(&s, '*'))
+			value = EXPR_ANY;
+		else if (psr_number(&s, 0, &value) ||
+				value < 1 || value >= EXPR_ANY)
+			return -1;
+		m->lookup = expr_qualify(m->lookup, value);
+		psr_whitespace(&s);
+	}
+	if (!psr_consume_char(&s, ':')) {
+		m->cmp = EXPR_EQ;
+		for (unsigned int i = 0; i < ARRAY_SIZE(cmps); ++i) {
+			if (psr_match(&s, cmps[i].name)) {
+				m->cmp = cmps[i].cmp;
+				break;
+			}
 		}
 
-		m->value = strtol(data, &ep, 0);
-		data = ep;
-		psr_whitespace(&data);
+		if (psr_number(&s, 0, &value))
+			value = 0;
+		m->value = value;
+		psr_whitespace(&s);
 	} else {
 		m->cmp = EXPR_EQ;
 		m->value = 1;
 	}
 
-	*pdata = data;
+	*ps = s;
 
 	return 0;
 }
 
-static struct expr *psr_expr_event(const char **pdata)
+static struct expr *psr_expr_event(struct psr *ps)
 {
-	const char *data = *pdata;
+	struct psr s = *ps;
 	struct expr_match m;
 	struct expr *c;
 
-	if (psr_expr_ctab_lookup(&data, &m))
+	if (psr_expr_ctab_lookup(&s, &m))
 		return NULL;
 
-	c = expr_new();
+	c = expr_new(s.arena);
 	if (c == NULL)
 		return NULL;
 
 	c->type = EXPR_PRIMARY;
 	c->primary = m;
 
-	psr_whitespace(&data);
+	psr_whitespace(&s);
 
-	*pdata = data;
+	*ps = s;
 
 	return c;
 }
 
-static struct expr *psr_expr_postfix(const char **pdata)
+static struct expr *psr_expr_postfix(struct psr *ps)
 {
-	struct expr *(*opts[])(const char **) = {
+	struct expr *(*opts[])(struct psr *) = {
 		psr_expr_group, psr_expr_event,
 	};
-	const char *data = *pdata;
+	struct psr s = *ps;
 	unsigned int dur;
 	struct expr *e;
 
-	e = psr_any_of(&data, opts, ARRAY_SIZE(opts));
+	e = psr_any_of(&s, opts, ARRAY_SIZE(opts));
 	if (e == NULL)
 		return NULL;
 
-	dur = psr_duration(&data);
+	dur = psr_duration(&s);
 	if (dur != 0) {
 		struct expr *de;
 
-		de = expr_new();
+		de = expr_new(s.arena);
 		if (de == NULL)
 			return NULL;
 
@@ -283,128 +317,125 @@ static struct expr *psr_expr_postfix(const char **pdata)
 		e = de;
 	}
 
-	*pdata = data;
+	*ps = s;
 
 	return e;
 }
 
-static struct expr *psr_expr_not(const char **pdata);
+static struct expr *psr_expr_not(struct psr *ps);
 
-static struct expr *psr_expr_primary(const char **pdata)
+static struct expr *psr_expr_primary(struct psr *ps)
 {
-	struct expr *(*opts[])(const char **) = {
+	struct expr *(*opts[])(struct psr *) = {
 		psr_expr_not, psr_expr_postfix,
 	};
-	return psr_any_of(pdata, opts, ARRAY_SIZE(opts));
+	return psr_any_of(ps, opts, ARRAY_SIZE(opts));
 }
 
-static struct expr *psr_expr_not(const char **pdata)
+static struct expr *psr_expr_not(struct psr *ps)
 {
-	const char *data = *pdata;
+	struct psr s = *ps;
 	struct expr *c, *p;
 
-	if (psr_consume_char(&data, '!'))
+	if (psr_consume_char(&s, '!'))
 		return NULL;
 
-	c = psr_expr_primary(&data);
+	c = psr_expr_primary(&s);
 	if (c == NULL)
 		return NULL;
 
-	p = expr_new();
+	p = expr_new(s.arena);
 	if (p == NULL)
 		return NULL;
 
 	p->type = EXPR_NOT;
 	p->not = c;
 
-	*pdata = data;
+	*ps = s;
 
 	return p;
 }
 
-static struct expr *psr_expr_and(const char **pdata)
+static struct expr *psr_expr_and(struct psr *ps)
 {
-	return psr_seq(pdata, '&', EXPR_AND, psr_expr_primary);
+	return psr_seq(ps, '&', EXPR_AND, psr_expr_primary);
 }
 
-static struct expr *psr_expr_xor(const char **pdata)
+static struct expr *psr_expr_xor(struct psr *ps)
 {
-	return psr_seq(pdata, '^', EXPR_XOR, psr_expr_and);
+	return psr_seq(ps, '^', EXPR_XOR, psr_expr_and);
 }
 
-static struct expr *psr_expr_or(const char **pdata)
+static struct expr *psr_expr_or(struct psr *ps)
 {
-	return psr_seq(pdata, '|', EXPR_OR, psr_expr_xor);
+	return psr_seq(ps, '|', EXPR_OR, psr_expr_xor);
 }
 
-static struct expr *psr_expr_any(const char **pdata)
+static struct expr *psr_expr_any(struct psr *ps)
 {
-	return psr_expr_or(pdata);
+	return psr_expr_or(ps);
 }
 
-static struct binding *psr_binding(const char **pdata)
+static struct binding *psr_binding(struct psr *ps)
 {
-	const char *data = *pdata;
+	struct psr s = *ps;
 	struct binding *b;
 	struct expr *e;
-	const char *p;
+	size_t len = 0;
 
-	e = psr_expr_any(&data);
+	e = psr_expr_any(&s);
 	if (e == NULL)
 		return NULL;
 
-	if (strncmp(data, "<=", 2)) {
-		expr_free(e);
+	if (!psr_match(&s, "<="))
 		return NULL;
-	}
-	data += 2;
-	psr_whitespace(&data);
-	p = data;
+	psr_whitespace(&s);
 
-	while (*p && *p != '\n')
-		++p;
+	while (psr_peek(&s, len) && psr_peek(&s, len) != '\n')
+		++len;
 
-	b = calloc(1, sizeof(*b) + (p - data) + 1);
-	if (b == NULL) {
-		expr_free(e);
+	/* the command is copied alongside; the input need not outlive us */
+	b = arena_alloc(s.arena, sizeof(*b) + len + 1);
+	if (b == NULL)
 		return NULL;
-	}
 
-	memcpy(b->command, data, p - data);
-	b->command[p - data] = 0;
+	memcpy(b->command, s.data, len);
 	b->expr = e;
 
-	*pdata = p + !!*p;
+	s.data += len;
+	if (psr_peek(&s, 0) == '\n')
+		++s.data;
+
+	psr_whitespace(&s);
 
-	psr_whitespace(pdata);
+	*ps = s;
 
 	return b;
 }
 
-struct binding *psr_parse(const char *data)
+/*
+ * Parse len bytes of configuration, allocating from arena.  On success,
+ * *bindings is set to the (possibly empty) list of parsed rules.
+ */
+int psr_parse(const char *data, size_t len, struct arena *arena,
+		struct binding **bindings)
 {
+	struct psr ps = { data, data + len, arena };
 	struct binding *head = NULL;
-	struct binding *next;
 	struct binding *b;
 
-	psr_whitespace(&data);
+	psr_whitespace(&ps);
 
-	while (data[0]) {
-		b = psr_binding(&data);
+	while (psr_peek(&ps, 0)) {
+		b = psr_binding(&ps);
 		if (b == NULL)
-			goto err;
+			return -1;
 
 		b->next = head;
 		head = b;
 	}
 
-	return head;
+	*bindings = head;
 
-err:
-	for (b = head; b; b = next) {
-		next = b->next;
-		expr_free(b->expr);
-		free(b);
-	}
-	return NULL;
+	return 0;
 }
@@ -1,7 +1,11 @@
 #ifndef __PARSER_H_
 #define __PARSER_H_
 
+#include <stddef.h>
+
+struct arena;
 struct binding;
-struct binding *psr_parse(const char *data);
+int psr_parse(const char *data, size_t len, struct arena *arena,
+		struct binding **bindings);
 
 #endif
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "reader.h"
+#include "ring.h"
+
+/* events read from a device at a time */
+#ifndef READER_BATCH
+#define READER_BATCH 64
+#endif
+
+/*
+ * The reader thread: drains the devices in its own epoll set into the
+ * ring as soon as they have events, however long the main thread takes
+ * over them, so they don't back up in the kernel and get dropped.
+ */
+static struct ring reader_ring;
+static int reader_efd = -1;
+static int reader_evfd = -1;
+static int reader_spacefd = -1;
+static atomic_int reader_waiting;
+
+/*
+ * Held while reading the devices, so one isn't closed by the main thread
+ * in the middle of it; reader_open says which descriptors still count.
+ */
+static pthread_mutex_t reader_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned char *reader_open;
+static unsigned int reader_nopen;
+
+static void reader_wake(void)
+{
+	uint64_t one = 1;
+
+	write(reader_evfd, &one, sizeof(one));
+}
+
+/* queue rev, waiting for the main thread to make room if need be */
+static void reader_push(const struct reader_event *rev)
+{
+	uint64_t n;
+
+	while (ring_push(&reader_ring, rev)) {
+		atomic_store(&reader_waiting, 1);
+		if (ring_depth(&reader_ring) < reader_ring.size) {
+			atomic_store(&reader_waiting, 0);
+			continue;
+		}
+
+		pthread_mutex_unlock(&reader_lock);
+		reader_wake();
+		read(reader_spacefd, &n, sizeof(n));
+		pthread_mutex_lock(&reader_lock);
+
+		/* the device may have been removed, its number reused */
+		if (!rev->gone && !reader_open[rev->fd])
+			return;
+	}
+}
+
+static void reader_read(int fd)
+{
+	struct input_event evs[READER_BATCH];
+	struct reader_event rev = { fd, 0, };
+	ssize_t rc;
+
+	rc = read(fd, evs, sizeof(evs));
+	if (rc == -1 && (errno == EINTR || errno == EAGAIN))
+		return;
+
+	if (rc <= 0 || rc % sizeof(evs[0])) {
+		/* the main thread closes it once it gets to this */
+		epoll_ctl(reader_efd, EPOLL_CTL_DEL, fd, NULL);
+		reader_open[fd] = 0;
+		rev.gone = 1;
+		reader_push(&rev);
+		return;
+	}
+
+	for (unsigned int i = 0; i < rc / sizeof(evs[0]); ++i) {
+		/* room may have been made by removing the device meanwhile */
+		if (!reader_open[fd])
+			return;
+
+		rev.ev = evs[i];
+		reader_push(&rev);
+	}
+}
+
+static void *reader_thread(void *arg)
+{
+	struct epoll_event evs[16];
+	int n;
+
+	for (;;) {
+		n = epoll_wait(reader_efd, evs, 16, -1);
+		if (n <= 0)
+			continue;
+
+		pthread_mutex_lock(&reader_lock);
+		for (int i = 0; i < n; ++i) {
+			int fd = evs[i].data.fd;
+
+			if (fd < reader_nopen && reader_open[fd])
+				reader_read(fd);
+		}
+		pthread_mutex_unlock(&reader_lock);
+
+		reader_wake();
+	}
+
+	return NULL;
+}
+
+/* start the reader thread, with room for size events to be queued */
+int reader_start(unsigned int size)
+{
+	pthread_t thread;
+
+	if (ring_init(&reader_ring, size, sizeof(struct reader_event)))
+		return -1;
+
+	reader_efd = epoll_create1(EPOLL_CLOEXEC);
+	reader_evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	reader_spacefd = eventfd(0, EFD_CLOEXEC);
+	if (reader_efd == -1 || reader_evfd == -1 || reader_spacefd == -1)
+		return -1;
+
+	errno = pthread_create(&thread, NULL, reader_thread, NULL);
+	if (errno)
+		return -1;
+	pthread_detach(thread);
+
+	return 0;
+}
+
+/* the descriptor which is readable when there are events to pop */
+int reader_fd(void)
+{
+	return reader_evfd;
+}
+
+/* the queue of events, for its depth and such; NULL if not started */
+struct ring *reader_queue(void)
+{
+	return reader_ring.buf ? &reader_ring : NULL;
+}
+
+/* have the reader thread read device fd */
+int reader_add(int fd)
+{
+	struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+	unsigned char *open;
+	int rc = -1;
+
+	pthread_mutex_lock(&reader_lock);
+
+	if (fd >= reader_nopen) {
+		open = realloc(reader_open, fd + 16);
+		if (open == NULL)
+			goto out;
+		memset(open + reader_nopen, 0, fd + 16 - reader_nopen);
+		reader_open = open;
+		reader_nopen = fd + 16;
+	}
+
+	rc = epoll_ctl(reader_efd, EPOLL_CTL_ADD, fd, &ev);
+	if (rc == 0)
+		reader_open[fd] = 1;
+
+out:
+	pthread_mutex_unlock(&reader_lock);
+	return rc;
+}
+
+/* stop reading device fd, so it can be closed */
+void reader_remove(int fd)
+{
+	pthread_mutex_lock(&reader_lock);
+
+	if (fd < reader_nopen && reader_open[fd]) {
+		epoll_ctl(reader_efd, EPOLL_CTL_DEL, fd, NULL);
+		reader_open[fd] = 0;
+	}
+
+	pthread_mutex_unlock(&reader_lock);
+}
+
+/* take the next event read, or fail if there is none */
+int reader_pop(struct reader_event *rev)
+{
+	uint64_t n;
+
+	if (ring_pop(&reader_ring, rev)) {
+		/* reset the wakeup; the reader wakes us again after pushing */
+		read(reader_evfd, &n, sizeof(n));
+		return ring_pop(&reader_ring, rev);
+	}
+
+	if (atomic_exchange(&reader_waiting, 0)) {
+		n = 1;
+		write(reader_spacefd, &n, sizeof(n));
+	}
+
+	return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef __READER_H_
+#define __READER_H_
+
+#include <linux/input.h>
+
+struct ring;
+
+/* an event of device fd, or with gone set, that it can't be read */
+struct reader_event {
+	int fd;
+	int gone;
+	struct input_event ev;
+};
+
+int reader_start(unsigned int size);
+int reader_fd(void);
+struct ring *reader_queue(void);
+int reader_add(int fd);
+void reader_remove(int fd);
+int reader_pop(struct reader_event *rev);
+
+#endif
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdlib.h>
+
+#include "ring.h"
+
+/* size is rounded up to a power of two */
+int ring_init(struct ring *r, unsigned int size, size_t elem)
+{
+	unsigned int n = 1;
+
+	while (n < size)
+		n <<= 1;
+
+	r->buf = calloc(n, elem);
+	if (r->buf == NULL)
+		return -1;
+
+	atomic_init(&r->head, 0);
+	atomic_init(&r->tail, 0);
+	atomic_init(&r->peak, 0);
+	atomic_init(&r->full, 0);
+	r->size = n;
+	r->elem = elem;
+
+	return 0;
+}
+
+void ring_free(struct ring *r)
+{
+	free(r->buf);
+	r->buf = NULL;
+}
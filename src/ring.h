@@ -0,0 +1,75 @@
+#ifndef __RING_H_
+#define __RING_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Bounded single-producer, single-consumer queue of fixed-size elements.
+ * head is only written by the consumer and tail by the producer, each on
+ * a cache line of its own; neither side ever waits on the other.
+ */
+struct ring {
+	_Alignas(64) atomic_uint head;
+	_Alignas(64) atomic_uint tail;
+	/* the most elements ever queued at once, and pushes turned away */
+	atomic_uint peak;
+	atomic_uint full;
+
+	_Alignas(64) unsigned int size;
+	size_t elem;
+	char *buf;
+};
+
+int ring_init(struct ring *r, unsigned int size, size_t elem);
+void ring_free(struct ring *r);
+
+static inline unsigned int ring_depth(struct ring *r)
+{
+	return atomic_load_explicit(&r->tail, memory_order_acquire) -
+		atomic_load_explicit(&r->head, memory_order_acquire);
+}
+
+/* queue a copy of elem, or fail if the ring is full */
+static inline int ring_push(struct ring *r, const void *elem)
+{
+	unsigned int tail = atomic_load_explicit(&r->tail,
+			memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&r->head,
+			memory_order_acquire);
+	unsigned int depth = tail - head;
+
+	if (depth == r->size) {
+		atomic_fetch_add_explicit(&r->full, 1, memory_order_relaxed);
+		return -1;
+	}
+
+	memcpy(r->buf + (tail & (r->size - 1)) * r->elem, elem, r->elem);
+	atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+
+	if (depth + 1 > atomic_load_explicit(&r->peak, memory_order_relaxed))
+		atomic_store_explicit(&r->peak, depth + 1,
+				memory_order_relaxed);
+
+	return 0;
+}
+
+/* take the oldest element into elem, or fail if the ring is empty */
+static inline int ring_pop(struct ring *r, void *elem)
+{
+	unsigned int head = atomic_load_explicit(&r->head,
+			memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&r->tail,
+			memory_order_acquire);
+
+	if (head == tail)
+		return -1;
+
+	memcpy(elem, r->buf + (head & (r->size - 1)) * r->elem, r->elem);
+	atomic_store_explicit(&r->head, head + 1, memory_order_release);
+
+	return 0;
+}
+
+#endif
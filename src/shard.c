@@ -0,0 +1,487 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <sys/eventfd.h>
+#include <sys/time.h>
+
+#include "context.h"
+#include "ring.h"
+#include "shard.h"
+
+enum {
+	SHARD_EVENT,
+	SHARD_ADD,
+	SHARD_PAUSE,
+};
+
+/* what the main thread hands a worker, in order */
+struct shard_msg {
+	int op;
+	unsigned int typecode;
+	int value;
+	struct shard *shard;
+	u64 time;
+};
+
+/*
+ * A worker thread, evaluating the shards handed to it as their events come
+ * in through in, and handing the bindings that fire back through out, as
+ * commands are only run by the main thread.  Either thread waits on the
+ * other for room in a full ring: the worker on spacefd, with waiting set,
+ * and the main thread on roomfd, with blocked set.  Its list of shards is
+ * only touched by the main thread while it is paused.
+ */
+struct shard_worker {
+	struct ring in;
+	struct ring out;
+	int evfd;
+	int spacefd;
+	int roomfd;
+	atomic_int waiting;
+	atomic_int blocked;
+	int kick;
+	int fired;
+
+	struct shard *shards;
+	unsigned int nshards;
+};
+
+static struct shard_worker *shard_workers;
+static unsigned int shard_nworkers;
+static int shard_evfd = -1;
+static void (*shard_fired)(const struct shard_fire *f);
+
+/*
+ * how many shard_pause() calls are in effect, and how many workers the
+ * first one saw stop so far
+ */
+static pthread_mutex_t shard_pause_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t shard_pause_cond = PTHREAD_COND_INITIALIZER;
+static unsigned int shard_paused;
+static unsigned int shard_stopped;
+
+static u64 shard_time(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (u64)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static void shard_signal(int fd)
+{
+	uint64_t one = 1;
+
+	write(fd, &one, sizeof(one));
+}
+
+/*
+ * Queue f for the main thread, waiting for it to make room if need be.
+ * The shard of f is held, but only its results change while it is let go
+ * meanwhile, and the main thread merely reads its values.
+ */
+static void shard_push(struct shard_worker *w, const struct shard_fire *f)
+{
+	uint64_t n;
+
+	while (ring_push(&w->out, f)) {
+		atomic_store(&w->waiting, 1);
+		if (ring_depth(&w->out) < w->out.size) {
+			atomic_store(&w->waiting, 0);
+			continue;
+		}
+
+		/* the main thread takes the shard to run what is queued */
+		if (f->shard)
+			pthread_mutex_unlock(&f->shard->lock);
+		shard_signal(shard_evfd);
+		read(w->spacefd, &n, sizeof(n));
+		if (f->shard)
+			pthread_mutex_lock(&f->shard->lock);
+	}
+
+	w->fired = 1;
+}
+
+static int shard_run(struct context *ctx, struct binding *b)
+{
+	struct shard *s = (struct shard *)ctx;
+	struct shard_fire f = { s, b, s->time };
+
+	shard_push(&shard_workers[s->worker], &f);
+
+	return 0;
+}
+
+/* run the timers of the shards of w that are due; returns the next wait */
+static int shard_expire(struct shard_worker *w)
+{
+	u64 now = shard_time();
+	int timeout = -1;
+	int rc;
+
+	for (struct shard *s = w->shards; s; s = s->next) {
+		pthread_mutex_lock(&s->lock);
+		s->time = 0;
+		rc = ctx_timeout(&s->ctx, shard_run, now);
+		pthread_mutex_unlock(&s->lock);
+
+		if (rc != -1 && (timeout == -1 || rc < timeout))
+			timeout = rc;
+	}
+
+	return timeout;
+}
+
+static void shard_wait(struct shard_worker *w)
+{
+	struct shard_fire f = { NULL, };
+
+	shard_push(w, &f);
+	shard_signal(shard_evfd);
+	w->fired = 0;
+
+	pthread_mutex_lock(&shard_pause_lock);
+	while (shard_paused)
+		pthread_cond_wait(&shard_pause_cond, &shard_pause_lock);
+	pthread_mutex_unlock(&shard_pause_lock);
+}
+
+static void *shard_thread(void *arg)
+{
+	struct shard_worker *w = arg;
+	struct pollfd pfd = { w->evfd, POLLIN, };
+	struct shard *locked = NULL;
+	struct shard_msg msg;
+	uint64_t n;
+
+	for (;;) {
+		pfd.revents = 0;
+		poll(&pfd, 1, shard_expire(w));
+		read(w->evfd, &n, sizeof(n));
+
+		while (ring_pop(&w->in, &msg) == 0) {
+			struct shard *s = msg.shard;
+
+			if (atomic_exchange(&w->blocked, 0))
+				shard_signal(w->roomfd);
+
+			/* events mostly come in runs of one device */
+			if (s != locked) {
+				if (locked)
+					pthread_mutex_unlock(&locked->lock);
+				locked = NULL;
+			}
+
+			switch (msg.op) {
+			case SHARD_EVENT:
+				if (locked == NULL) {
+					pthread_mutex_lock(&s->lock);
+					locked = s;
+				}
+				s->time = msg.time;
+				ctx_input_event(&s->ctx, shard_run, s->fd, 0,
+						msg.typecode, msg.value,
+						msg.time);
+				break;
+			case SHARD_ADD:
+				s->next = w->shards;
+				w->shards = s;
+				break;
+			case SHARD_PAUSE:
+				if (locked)
+					pthread_mutex_unlock(&locked->lock);
+				locked = NULL;
+				shard_wait(w);
+				break;
+			}
+		}
+
+		if (locked)
+			pthread_mutex_unlock(&locked->lock);
+		locked = NULL;
+
+		if (w->fired) {
+			w->fired = 0;
+			shard_signal(shard_evfd);
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Start nworkers threads to evaluate shards on, each with room for size
+ * events queued to it, and as many of its bindings firing.  fired is
+ * called on the main thread, by shard_drain(), to run their commands.
+ */
+int shard_start(unsigned int nworkers, unsigned int size,
+		void (*fired)(const struct shard_fire *f))
+{
+	pthread_t thread;
+
+	shard_workers = calloc(nworkers, sizeof(*shard_workers));
+	if (shard_workers == NULL)
+		return -1;
+
+	shard_evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (shard_evfd == -1)
+		return -1;
+	shard_fired = fired;
+
+	for (unsigned int i = 0; i < nworkers; ++i) {
+		struct shard_worker *w = &shard_workers[i];
+
+		if (ring_init(&w->in, size, sizeof(struct shard_msg)) ||
+		    ring_init(&w->out, size, sizeof(struct shard_fire)))
+			return -1;
+
+		w->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		w->spacefd = eventfd(0, EFD_CLOEXEC);
+		w->roomfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (w->evfd == -1 || w->spacefd == -1 || w->roomfd == -1)
+			return -1;
+
+		errno = pthread_create(&thread, NULL, shard_thread, w);
+		if (errno)
+			return -1;
+		pthread_detach(thread);
+
+		++shard_nworkers;
+	}
+
+	return 0;
+}
+
+/* the descriptor which is readable when there are bindings to run */
+int shard_fd(void)
+{
+	return shard_evfd;
+}
+
+/* the queue of events to a worker, for its depth; NULL past the last */
+struct ring *shard_queue(unsigned int worker)
+{
+	return worker < shard_nworkers ? &shard_workers[worker].in : NULL;
+}
+
+/*
+ * a shard of device fd, with the bindings of tmpl keep is set for, see
+ * ctx_subset(), evaluated inline until handed to shard_add()
+ */
+struct shard *shard_new(struct context *tmpl, const unsigned char *keep,
+		int fd, const char *device)
+{
+	struct shard *s;
+
+	s = calloc(1, sizeof(*s));
+	if (s == NULL)
+		return NULL;
+
+	s->device = strdup(device);
+	if (s->device == NULL || ctx_subset(&s->ctx, tmpl, keep)) {
+		free(s->device);
+		free(s);
+		return NULL;
+	}
+
+	pthread_mutex_init(&s->lock, NULL);
+	s->fd = fd;
+	s->worker = -1;
+
+	return s;
+}
+
+/*
+ * Queue msg to worker w, waiting for it to make room if need be, and
+ * running what the workers fire meanwhile: w may well be waiting on that.
+ */
+static void shard_send(struct shard_worker *w, const struct shard_msg *msg)
+{
+	struct pollfd pfd[2] = {
+		{ w->roomfd, POLLIN, },
+		{ shard_evfd, POLLIN, },
+	};
+	uint64_t n;
+
+	while (ring_push(&w->in, msg)) {
+		atomic_store(&w->blocked, 1);
+		if (ring_depth(&w->in) < w->in.size) {
+			atomic_store(&w->blocked, 0);
+			continue;
+		}
+
+		shard_signal(w->evfd);
+		if (poll(pfd, ARRAY_SIZE(pfd), -1) == -1)
+			continue;
+		if (pfd[0].revents)
+			read(w->roomfd, &n, sizeof(n));
+		if (pfd[1].revents)
+			shard_drain();
+	}
+
+	w->kick = 1;
+}
+
+/* hand s to the worker with the fewest shards, if there are workers */
+void shard_add(struct shard *s)
+{
+	struct shard_msg msg = { SHARD_ADD, .shard = s };
+	struct shard_worker *w = NULL;
+
+	for (unsigned int i = 0; i < shard_nworkers; ++i) {
+		if (w == NULL || shard_workers[i].nshards < w->nshards)
+			w = &shard_workers[i];
+	}
+	if (w == NULL)
+		return;
+
+	s->worker = w - shard_workers;
+	++w->nshards;
+	shard_send(w, &msg);
+	shard_kick();
+}
+
+/* free s, which a worker must not be running meanwhile, see shard_pause() */
+void shard_free(struct shard *s)
+{
+	if (s->worker != -1) {
+		struct shard_worker *w = &shard_workers[s->worker];
+		struct shard **ps;
+
+		for (ps = &w->shards; *ps && *ps != s; ps = &(*ps)->next)
+			;
+		if (*ps)
+			*ps = s->next;
+		--w->nshards;
+	}
+
+	ctx_free(&s->ctx);
+	pthread_mutex_destroy(&s->lock);
+	free(s->device);
+	free(s);
+}
+
+/*
+ * Handle an event of the device of s: at once with run if s is evaluated
+ * inline, or by queueing it to its worker, see shard_kick().
+ */
+void shard_input(struct shard *s,
+		int (*run)(struct context *ctx, struct binding *b),
+		unsigned int typecode, int value, u64 now)
+{
+	struct shard_msg msg = { SHARD_EVENT, typecode, value, s, now };
+
+	if (s->worker != -1) {
+		shard_send(&shard_workers[s->worker], &msg);
+		return;
+	}
+
+	s->time = now;
+	ctx_input_event(&s->ctx, run, s->fd, 0, typecode, value, now);
+}
+
+/* wake the workers events were queued to */
+void shard_kick(void)
+{
+	for (unsigned int i = 0; i < shard_nworkers; ++i) {
+		struct shard_worker *w = &shard_workers[i];
+
+		if (w->kick) {
+			w->kick = 0;
+			shard_signal(w->evfd);
+		}
+	}
+}
+
+/* run the bindings the workers found to fire */
+void shard_drain(void)
+{
+	struct shard_fire f;
+	uint64_t n;
+
+	read(shard_evfd, &n, sizeof(n));
+
+	for (unsigned int i = 0; i < shard_nworkers; ++i) {
+		struct shard_worker *w = &shard_workers[i];
+
+		while (ring_pop(&w->out, &f) == 0) {
+			/* before taking the lock the worker may be holding */
+			if (atomic_exchange(&w->waiting, 0))
+				shard_signal(w->spacefd);
+
+			if (f.shard == NULL) {
+				++shard_stopped;
+				continue;
+			}
+
+			pthread_mutex_lock(&f.shard->lock);
+			shard_fired(&f);
+			pthread_mutex_unlock(&f.shard->lock);
+		}
+	}
+}
+
+/*
+ * Stop the workers once they are through with what is queued to them,
+ * running what fired, so that the main thread has the shards to itself
+ * until shard_resume().  Calls nest.  A shard handed to shard_add()
+ * meanwhile only reaches its worker afterwards, and must not be freed
+ * before that.
+ */
+void shard_pause(void)
+{
+	struct shard_msg msg = { SHARD_PAUSE, };
+	struct pollfd pfd = { shard_evfd, POLLIN, };
+	unsigned int paused;
+
+	if (shard_nworkers == 0)
+		return;
+
+	pthread_mutex_lock(&shard_pause_lock);
+	paused = shard_paused++;
+	pthread_mutex_unlock(&shard_pause_lock);
+	if (paused)
+		return;
+
+	shard_stopped = 0;
+
+	for (unsigned int i = 0; i < shard_nworkers; ++i)
+		shard_send(&shard_workers[i], &msg);
+	shard_kick();
+
+	for (;;) {
+		shard_drain();
+		if (shard_stopped == shard_nworkers)
+			break;
+		poll(&pfd, 1, -1);
+	}
+}
+
+void shard_resume(void)
+{
+	unsigned int paused;
+
+	if (shard_nworkers == 0)
+		return;
+
+	pthread_mutex_lock(&shard_pause_lock);
+	paused = --shard_paused;
+	if (!paused)
+		pthread_cond_broadcast(&shard_pause_cond);
+	pthread_mutex_unlock(&shard_pause_lock);
+	if (paused)
+		return;
+
+	/* to have another look at the timers */
+	for (unsigned int i = 0; i < shard_nworkers; ++i)
+		shard_signal(shard_workers[i].evfd);
+}
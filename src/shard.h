@@ -0,0 +1,56 @@
+#ifndef __SHARD_H_
+#define __SHARD_H_
+
+#include <pthread.h>
+
+#include "context.h"
+#include "types.h"
+
+struct ring;
+
+/*
+ * The rules of a single device, see ctx_binding_local(), that it has
+ * events for, evaluated with state of its own: inline, or after
+ * shard_add() by a worker thread.
+ */
+struct shard {
+	struct context ctx;
+	int fd;
+	char *device;
+
+	/* the time of the event being handled, 0 while handling timers */
+	u64 time;
+
+	/* held while ctx is evaluated, or the commands of its rules run */
+	pthread_mutex_t lock;
+	int worker;
+	struct shard *next;
+};
+
+/* a binding of shard that fired, or with shard NULL, a worker pausing */
+struct shard_fire {
+	struct shard *shard;
+	struct binding *b;
+	u64 time;
+};
+
+int shard_start(unsigned int nworkers, unsigned int size,
+		void (*fired)(const struct shard_fire *f));
+int shard_fd(void);
+struct ring *shard_queue(unsigned int worker);
+
+struct shard *shard_new(struct context *tmpl, const unsigned char *keep,
+		int fd, const char *device);
+void shard_add(struct shard *s);
+void shard_free(struct shard *s);
+
+void shard_input(struct shard *s,
+		int (*run)(struct context *ctx, struct binding *b),
+		unsigned int typecode, int value, u64 now);
+void shard_kick(void);
+void shard_drain(void);
+
+void shard_pause(void);
+void shard_resume(void);
+
+#endif
@@ -0,0 +1,1424 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#define _GNU_SOURCE
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "builtin.h"
+#include "expr.h"
+#include "ring.h"
+#include "spawner.h"
+#include "tables.h"
+#include "types.h"
+
+/* longest command handed to the helper; longer ones are spawned directly */
+#ifndef SPAWN_MSG_MAX
+#define SPAWN_MSG_MAX 4096
+#endif
+
+/* time given to a command between SIGTERM and SIGKILL on timing out */
+#define SPAWN_KILL_GRACE 1000
+
+/* "%{NAME}" templates per command, and the room each is expanded into */
+#define SPAWN_SLOTS_MAX 64
+#define SPAWN_SLOT_LEN 64
+
+/* a template in argv, followed by 0x80 plus the index of its slot */
+#define SPAWN_MARK '\x01'
+
+extern char **environ;
+
+enum {
+	SPAWN_SINGLE	= (1 << 0),
+	SPAWN_QUEUE	= (1 << 1),
+	SPAWN_PREPARED	= (1 << 2),
+};
+
+enum {
+	SPAWN_SLOT_VALUE,
+	SPAWN_SLOT_TIME,
+	SPAWN_SLOT_DEVICE,
+};
+
+struct spawn_slot {
+	unsigned int type;
+	unsigned int typecode;
+};
+
+/*
+ * A prepared command: its policy, parsed from the "@option" words it
+ * starts with, what is left to run, and argv if that can be executed
+ * without a shell, or the builtin action it stands for.  With templates,
+ * argv is always set, marked where the slots go, and expanded into xargv
+ * and xbuf on each run.  Entries outlive spawn_reset() while their commands
+ * are still running, so those can be accounted for.
+ */
+struct spawn_entry {
+	u32 hash;
+	unsigned int flags;
+	unsigned int interval;
+	unsigned int timeout;
+
+	u64 last;
+	unsigned int running;
+	int queued;
+
+	unsigned int runs;
+	unsigned int failures;
+	u64 runtime;
+	int status;
+
+	const char *text;
+	char **argv;
+	char *path;
+	struct builtin *builtin;
+
+	struct spawn_slot *slots;
+	unsigned int nslots;
+	char **xargv;
+	char *xbuf;
+
+	char command[];
+};
+
+/*
+ * A running command, either a child of ours or, with pid 0, one the
+ * helper started for request id, or with pid -1, one the launcher has
+ * yet to start.  entry is NULL for commands which were never prepared.
+ */
+struct spawn_child {
+	pid_t pid;
+	u32 id;
+	int killed;
+	u64 start;
+	u64 deadline;
+	struct spawn_entry *entry;
+};
+
+/* what the helper sends back for each command once it has exited */
+struct spawn_report {
+	u32 id;
+	int status;
+};
+
+/* a command for the launcher to start, argv and path in one block */
+struct spawn_launch {
+	u32 id;
+	int group;
+	const char *path;
+	char **argv;
+};
+
+/* and what it sends back: the pid, or the error starting it */
+struct spawn_launched {
+	u32 id;
+	pid_t pid;
+	int rc;
+};
+
+static struct spawn_entry **spawn_table;
+static unsigned int spawn_size;
+static unsigned int spawn_count;
+
+static struct spawn_child *spawn_children;
+static unsigned int spawn_nchildren;
+static unsigned int spawn_maxchildren;
+static unsigned int spawn_max;
+
+/* epoll set of the helper socket, which changes as it is restarted */
+static int spawn_efd = -1;
+
+/* socket to the shell helper, see spawn_helper_start() */
+static int spawn_sock = -1;
+static pid_t spawn_helper_pid;
+static u32 spawn_id;
+
+/*
+ * The launcher thread, see spawn_pipeline(), and the children waiting on
+ * it; there are never more of those than fit either ring.  Children can
+ * exit before their pids are known here, so those are kept aside.
+ */
+static struct ring spawn_launches;
+static struct ring spawn_launched;
+static int spawn_launch_fd = -1;
+static int spawn_launched_fd = -1;
+static unsigned int spawn_pending;
+
+static struct spawn_early {
+	pid_t pid;
+	int status;
+} *spawn_early;
+static unsigned int spawn_nearly;
+static unsigned int spawn_maxearly;
+
+/* shell builtins without a binary of the same name and behaviour */
+static const char *const spawn_builtins[] = {
+	".", ":", "alias", "bg", "break", "cd", "command", "continue",
+	"eval", "exec", "exit", "export", "fg", "getopts", "hash", "jobs",
+	"local", "read", "readonly", "return", "set", "shift", "source",
+	"times", "trap", "type", "ulimit", "umask", "unalias", "unset",
+	"wait",
+};
+
+static u64 spawn_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static u32 spawn_hash(const char *s)
+{
+	u32 h = 2166136261u;
+
+	while (*s) {
+		h ^= (unsigned char)*s++;
+		h *= 16777619u;
+	}
+
+	return h;
+}
+
+/*
+ * Split command into words as sh would, or fail if that takes more than
+ * blanks and quotes: expansions, redirections, lists and the like.
+ * Returns the number of words, with the words written to buf.
+ */
+static int spawn_split(const char *command, char *buf)
+{
+	const char *p = command;
+	int nwords = 0;
+
+	for (;;) {
+		while (*p == ' ' || *p == '\t')
+			++p;
+		if (*p == '\0')
+			break;
+
+		while (*p != '\0' && *p != ' ' && *p != '\t') {
+			if (*p == '\'') {
+				while (*++p != '\'') {
+					if (*p == '\0')
+						return -1;
+					*buf++ = *p;
+				}
+				++p;
+			} else if (*p == '"') {
+				while (*++p != '"') {
+					if (*p == '\0' || strchr("$`\\!", *p))
+						return -1;
+					*buf++ = *p;
+				}
+				++p;
+			} else if (strchr("|&;<>()$`\\*?[]#~!{}\n\r", *p)) {
+				return -1;
+			} else if (*p == '=' && nwords == 0) {
+				/* a variable assignment */
+				return -1;
+			} else {
+				*buf++ = *p++;
+			}
+		}
+
+		*buf++ = '\0';
+		++nwords;
+	}
+
+	return nwords;
+}
+
+/* argv and its words, allocated as one block */
+static char **spawn_argv(const char *command)
+{
+	size_t len = strlen(command) + 1;
+	char **argv;
+	char *words;
+	int nwords;
+
+	/* at most one word per two bytes, with its terminator */
+	argv = malloc((len / 2 + 2) * sizeof(*argv) + len);
+	if (argv == NULL)
+		return NULL;
+	words = (char *)(argv + len / 2 + 2);
+
+	nwords = spawn_split(command, words);
+	if (nwords <= 0)
+		goto fail;
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(spawn_builtins); ++i) {
+		if (!strcmp(words, spawn_builtins[i]))
+			goto fail;
+	}
+
+	for (int i = 0; i < nwords; ++i) {
+		argv[i] = words;
+		words += strlen(words) + 1;
+	}
+	argv[nwords] = NULL;
+
+	return argv;
+
+fail:
+	free(argv);
+	return NULL;
+}
+
+/* a duration as in the configuration: milliseconds, or seconds with "s" */
+static const char *spawn_duration(const char *p, unsigned int *ms)
+{
+	char *ep;
+
+	*ms = strtoul(p, &ep, 10);
+	if (ep == p)
+		return NULL;
+
+	if (ep[0] == 's') {
+		*ms *= 1000;
+		++ep;
+	} else if (ep[0] == 'm' && ep[1] == 's') {
+		ep += 2;
+	}
+
+	return ep;
+}
+
+/*
+ * Parse the policy options command starts with into e, returning the
+ * command proper, or NULL if an option isn't understood:
+ *   @single		don't start while the last run is going
+ *   @queue		like @single, but run once more when it finishes
+ *   @interval=N	don't start within N of the last start
+ *   @timeout=N		kill the command if it is still running after N
+ */
+static const char *spawn_policy(const char *command, struct spawn_entry *e)
+{
+	const char *p = command;
+	size_t len;
+
+	for (;;) {
+		while (*p == ' ' || *p == '\t')
+			++p;
+		if (*p != '@')
+			return p;
+
+		len = strcspn(++p, " \t=");
+		if (len == 6 && !strncmp(p, "single", len)) {
+			e->flags |= SPAWN_SINGLE;
+			p += len;
+		} else if (len == 5 && !strncmp(p, "queue", len)) {
+			e->flags |= SPAWN_SINGLE | SPAWN_QUEUE;
+			p += len;
+		} else if (len == 8 && !strncmp(p, "interval", len) &&
+				p[len] == '=') {
+			p = spawn_duration(p + len + 1, &e->interval);
+		} else if (len == 7 && !strncmp(p, "timeout", len) &&
+				p[len] == '=') {
+			p = spawn_duration(p + len + 1, &e->timeout);
+		} else {
+			return NULL;
+		}
+
+		if (p == NULL || (*p != ' ' && *p != '\t' && *p != '\0'))
+			return NULL;
+	}
+}
+
+/* the full path of the program name, as found in PATH, or NULL */
+static char *spawn_lookup(const char *name)
+{
+	const char *dirs = getenv("PATH");
+	char path[PATH_MAX];
+	size_t len;
+
+	if (strchr(name, '/'))
+		return NULL;
+	if (dirs == NULL)
+		dirs = "/bin:/usr/bin";
+
+	for (;;) {
+		len = strcspn(dirs, ":");
+		if (len > 0 && snprintf(path, sizeof(path), "%.*s/%s",
+					(int)len, dirs, name) < sizeof(path) &&
+				access(path, X_OK) == 0)
+			return strdup(path);
+
+		if (dirs[len] == '\0')
+			return NULL;
+		dirs += len + 1;
+	}
+}
+
+static int spawn_slot_parse(const char *name, size_t len,
+		struct spawn_slot *slot)
+{
+	const struct code_entry *ce;
+	const char *at;
+	unsigned long device = 0;
+	char *end;
+
+	if (len == 4 && !strncmp(name, "TIME", len)) {
+		slot->type = SPAWN_SLOT_TIME;
+	} else if (len == 6 && !strncmp(name, "DEVICE", len)) {
+		slot->type = SPAWN_SLOT_DEVICE;
+	} else {
+		/* "ABS_X@2", as qualified in expressions */
+		at = memchr(name, '@', len);
+		if (at && at + 2 == name + len && at[1] == '*') {
+			device = EXPR_ANY;
+			len = at - name;
+		} else if (at) {
+			device = strtoul(at + 1, &end, 10);
+			if (end != name + len || device < 1 ||
+					device >= EXPR_ANY)
+				return -1;
+			len = at - name;
+		}
+
+		ce = code_lookup(name, len);
+		if (ce == NULL)
+			return -1;
+		slot->type = SPAWN_SLOT_VALUE;
+		slot->typecode = expr_qualify(
+				expr_typecode(ce->type, ce->code), device);
+	}
+
+	return 0;
+}
+
+/*
+ * argv to run text, with its n templates marked, through sh, which gets
+ * them as positional parameters: "%{NAME}" is turned into "${1}" and the
+ * like, for sh to expand without it ever being quoted.
+ */
+static char **spawn_shell_argv(const char *text, unsigned int n)
+{
+	size_t len = strlen(text) + n * 3 + 1;
+	unsigned int i = 0;
+	char **argv;
+	char *p;
+
+	argv = malloc((n + 5) * sizeof(*argv) + len + n * 3);
+	if (argv == NULL)
+		return NULL;
+	p = (char *)(argv + n + 5);
+
+	argv[0] = "/bin/sh";
+	argv[1] = "-c";
+	argv[2] = p;
+	argv[3] = "evev";
+
+	while (*text) {
+		if (*text == SPAWN_MARK) {
+			p += sprintf(p, "${%u}", ++i);
+			text += 2;
+		} else {
+			*p++ = *text++;
+		}
+	}
+	*p++ = '\0';
+
+	for (i = 0; i < n; ++i) {
+		argv[4 + i] = p;
+		*p++ = SPAWN_MARK;
+		*p++ = 0x80 + i;
+		*p++ = '\0';
+	}
+	argv[4 + n] = NULL;
+
+	return argv;
+}
+
+/*
+ * Compile the "%{NAME}" templates in the command of e, for the value of
+ * an event, the trigger's TIME or its DEVICE, into slots and an argv
+ * marked with where they go, so running it is one pass over argv.  The
+ * command is run through sh unless direct, or it needs no shell anyway.
+ */
+static int spawn_template(struct spawn_entry *e, int direct)
+{
+	const char *p = e->text;
+	const char *end;
+	unsigned int nwords;
+	unsigned int n = 0;
+	size_t len = 0;
+	char **argv;
+	char *text;
+	char *q;
+
+	while ((p = strstr(p, "%{")) != NULL) {
+		++n;
+		p += 2;
+	}
+	if (n == 0)
+		return 0;
+
+	if (n > SPAWN_SLOTS_MAX || strchr(e->text, SPAWN_MARK))
+		goto inval;
+
+	e->slots = calloc(n, sizeof(*e->slots));
+	text = malloc(strlen(e->text) + 1);
+	if (e->slots == NULL || text == NULL) {
+		free(text);
+		return -1;
+	}
+
+	n = 0;
+	for (p = e->text, q = text; *p; ) {
+		if (p[0] != '%' || p[1] != '{') {
+			*q++ = *p++;
+			continue;
+		}
+
+		end = strchr(p + 2, '}');
+		if (end == NULL ||
+				spawn_slot_parse(p + 2, end - p - 2, &e->slots[n])) {
+			free(text);
+			goto inval;
+		}
+
+		*q++ = SPAWN_MARK;
+		*q++ = 0x80 + n++;
+		p = end + 1;
+	}
+	*q = '\0';
+
+	argv = spawn_argv(text);
+	if (argv == NULL && !direct)
+		argv = spawn_shell_argv(text, n);
+	free(text);
+	if (argv == NULL)
+		goto inval;
+
+	for (nwords = 0; argv[nwords]; ++nwords)
+		len += strlen(argv[nwords]) + 1;
+
+	e->argv = argv;
+	e->nslots = n;
+	e->xargv = malloc((nwords + 1) * sizeof(*e->xargv));
+	e->xbuf = malloc(len + n * SPAWN_SLOT_LEN);
+	if (e->xargv == NULL || e->xbuf == NULL)
+		return -1;
+
+	return 0;
+
+inval:
+	errno = EINVAL;
+	return -1;
+}
+
+/* write what slot expands to, at most SPAWN_SLOT_LEN - 1 bytes, to out */
+static size_t spawn_slot_format(const struct spawn_slot *slot,
+		const struct spawn_vars *vars, char *out)
+{
+	int value;
+	int n = 0;
+
+	if (vars == NULL)
+		return 0;
+
+	switch (slot->type) {
+	case SPAWN_SLOT_VALUE:
+		if (vars->value &&
+				vars->value(vars->data, slot->typecode, &value) == 0)
+			n = snprintf(out, SPAWN_SLOT_LEN, "%d", value);
+		break;
+	case SPAWN_SLOT_TIME:
+		n = snprintf(out, SPAWN_SLOT_LEN, "%llu",
+				(unsigned long long)vars->time);
+		break;
+	case SPAWN_SLOT_DEVICE:
+		if (vars->device)
+			n = snprintf(out, SPAWN_SLOT_LEN, "%s", vars->device);
+		break;
+	}
+
+	return n < SPAWN_SLOT_LEN ? n : SPAWN_SLOT_LEN - 1;
+}
+
+/* argv of e with its templates filled in from vars */
+static char **spawn_expand(struct spawn_entry *e,
+		const struct spawn_vars *vars)
+{
+	char *out = e->xbuf;
+	const char *p;
+	unsigned int i;
+
+	for (i = 0; e->argv[i]; ++i) {
+		p = e->argv[i];
+		if (strchr(p, SPAWN_MARK) == NULL) {
+			e->xargv[i] = e->argv[i];
+			continue;
+		}
+
+		e->xargv[i] = out;
+		for (; *p; ++p) {
+			if (*p == SPAWN_MARK)
+				out += spawn_slot_format(
+					&e->slots[(unsigned char)*++p - 0x80],
+					vars, out);
+			else
+				*out++ = *p;
+		}
+		*out++ = '\0';
+	}
+	e->xargv[i] = NULL;
+
+	return e->xargv;
+}
+
+/*
+ * Prepare what is special about the command of e: a builtin action, or
+ * with "=exec", a command which must be executed without a shell, whose
+ * program is looked up in PATH just the once.
+ */
+static int spawn_special(struct spawn_entry *e)
+{
+	const char *p = e->text;
+	int direct = 0;
+
+	if (!strncmp(p, "=exec", 5) && (p[5] == ' ' || p[5] == '\t')) {
+		e->text = p + 5 + strspn(p + 5, " \t");
+		direct = 1;
+	} else if (builtin_parse(p, &e->builtin) || e->builtin) {
+		return e->builtin ? 0 : -1;
+	}
+
+	if (spawn_template(e, direct))
+		return -1;
+
+	if (!direct)
+		return 0;
+
+	if (e->argv == NULL)
+		e->argv = spawn_argv(e->text);
+	if (e->argv == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	e->path = spawn_lookup(e->argv[0]);
+
+	return 0;
+}
+
+static void spawn_entry_free(struct spawn_entry *e)
+{
+	free(e->xbuf);
+	free(e->xargv);
+	free(e->slots);
+	builtin_free(e->builtin);
+	free(e->path);
+	free(e->argv);
+	free(e);
+}
+
+static struct spawn_entry **spawn_find(const char *command, u32 hash)
+{
+	unsigned int mask = spawn_size - 1;
+	unsigned int h = hash & mask;
+
+	if (spawn_table == NULL)
+		return NULL;
+
+	while (spawn_table[h]) {
+		if (spawn_table[h]->hash == hash &&
+				!strcmp(spawn_table[h]->command, command))
+			return &spawn_table[h];
+		h = (h + 1) & mask;
+	}
+
+	return &spawn_table[h];
+}
+
+static int spawn_rehash(unsigned int size)
+{
+	struct spawn_entry **old = spawn_table;
+	unsigned int n = spawn_size;
+
+	spawn_table = calloc(size, sizeof(*spawn_table));
+	if (spawn_table == NULL) {
+		spawn_table = old;
+		return -1;
+	}
+	spawn_size = size;
+
+	for (unsigned int i = 0; i < n; ++i) {
+		if (old[i])
+			*spawn_find(old[i]->command, old[i]->hash) = old[i];
+	}
+	free(old);
+
+	return 0;
+}
+
+/*
+ * Start over preparing commands, such as when the configuration changes.
+ * Entries of commands which aren't prepared again are dropped by
+ * spawn_sweep(), once nothing of theirs is running.
+ */
+void spawn_reset(void)
+{
+	for (unsigned int i = 0; i < spawn_size; ++i) {
+		if (spawn_table[i])
+			spawn_table[i]->flags &= ~SPAWN_PREPARED;
+	}
+}
+
+void spawn_sweep(void)
+{
+	if (spawn_size == 0)
+		return;
+
+	for (unsigned int i = 0; i < spawn_size; ++i) {
+		struct spawn_entry *e = spawn_table[i];
+
+		if (e && (e->flags & SPAWN_PREPARED) == 0 && e->running == 0) {
+			spawn_entry_free(e);
+			spawn_table[i] = NULL;
+			--spawn_count;
+		}
+	}
+
+	/* open addressing doesn't take holes; fill them back in */
+	spawn_rehash(spawn_size);
+}
+
+/*
+ * Work out once, ahead of the first run, the policy of command, and
+ * whether it can be executed directly, and if so the argv to do it with.
+ * Fails with EINVAL if the policy or a builtin isn't understood.
+ */
+int spawn_prepare(const char *command)
+{
+	struct spawn_entry **slot;
+	struct spawn_entry *e;
+	u32 hash = spawn_hash(command);
+	size_t len = strlen(command);
+
+	/* keep the table at most half full */
+	if ((spawn_count + 1) * 2 > spawn_size &&
+			spawn_rehash(spawn_size ? spawn_size * 2 : 64))
+		return -1;
+
+	slot = spawn_find(command, hash);
+	if (*slot) {
+		(*slot)->flags |= SPAWN_PREPARED;
+		return 0;
+	}
+
+	e = calloc(1, sizeof(*e) + len + 1);
+	if (e == NULL)
+		return -1;
+	memcpy(e->command, command, len);
+
+	e->text = spawn_policy(e->command, e);
+	if (e->text == NULL) {
+		free(e);
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (spawn_special(e)) {
+		spawn_entry_free(e);
+		errno = EINVAL;
+		return -1;
+	}
+
+	e->hash = hash;
+	e->flags |= SPAWN_PREPARED;
+	e->status = -1;
+	if (e->argv == NULL && e->builtin == NULL)
+		e->argv = spawn_argv(e->text);
+	*slot = e;
+	++spawn_count;
+
+	return 0;
+}
+
+/* limit the number of commands running at once, or not with 0 */
+void spawn_limit(unsigned int max)
+{
+	spawn_max = max;
+}
+
+static int spawn_exec(const char *path, char *const argv[], pid_t *pid,
+		int group)
+{
+	posix_spawnattr_t attr;
+	sigset_t mask;
+	int rc;
+
+	/* signals read through the signalfd are blocked; don't pass that on */
+	sigemptyset(&mask);
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setsigmask(&attr, &mask);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK |
+			(group ? POSIX_SPAWN_SETPGROUP : 0));
+
+	rc = posix_spawnp(pid, path, NULL, &attr, argv, environ);
+	posix_spawnattr_destroy(&attr);
+
+	return rc;
+}
+
+/* copy of argv for the launcher, with path, in one block */
+static char **spawn_argv_copy(const char *path, char *const argv[],
+		const char **pathp)
+{
+	size_t len = strlen(path) + 1;
+	unsigned int n;
+	char **copy;
+	char *p;
+
+	for (n = 0; argv[n]; ++n)
+		len += strlen(argv[n]) + 1;
+
+	copy = malloc((n + 1) * sizeof(char *) + len);
+	if (copy == NULL)
+		return NULL;
+
+	p = (char *)(copy + n + 1);
+	for (n = 0; argv[n]; ++n) {
+		copy[n] = p;
+		p = stpcpy(p, argv[n]) + 1;
+	}
+	copy[n] = NULL;
+	*pathp = strcpy(p, path);
+
+	return copy;
+}
+
+static void *spawn_launcher(void *arg)
+{
+	struct spawn_launched r;
+	struct spawn_launch l;
+	uint64_t n;
+
+	for (;;) {
+		if (read(spawn_launch_fd, &n, sizeof(n)) != sizeof(n))
+			continue;
+
+		while (ring_pop(&spawn_launches, &l) == 0) {
+			r.id = l.id;
+			r.pid = -1;
+			r.rc = spawn_exec(l.path, l.argv, &r.pid, l.group);
+			free(l.argv);
+
+			/* can't be full, there are no more than were launched */
+			ring_push(&spawn_launched, &r);
+			n = 1;
+			write(spawn_launched_fd, &n, sizeof(n));
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Leave starting direct commands to a thread of their own, with room for
+ * size of them at once, so the event loop doesn't wait on posix_spawn().
+ * Shell commands still go through the helper.
+ */
+int spawn_pipeline(unsigned int size)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	pthread_t thread;
+
+	if (ring_init(&spawn_launches, size, sizeof(struct spawn_launch)) ||
+	    ring_init(&spawn_launched, size, sizeof(struct spawn_launched)))
+		return -1;
+
+	spawn_launch_fd = eventfd(0, EFD_CLOEXEC);
+	spawn_launched_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (spawn_launch_fd == -1 || spawn_launched_fd == -1)
+		return -1;
+
+	ev.data.fd = spawn_launched_fd;
+	if (epoll_ctl(spawn_efd, EPOLL_CTL_ADD, spawn_launched_fd, &ev) == -1)
+		return -1;
+
+	errno = pthread_create(&thread, NULL, spawn_launcher, NULL);
+	if (errno)
+		return -1;
+	pthread_detach(thread);
+
+	return 0;
+}
+
+/* the queue of commands to launch, for its depth and such; or NULL */
+struct ring *spawn_queue(void)
+{
+	return spawn_launches.buf ? &spawn_launches : NULL;
+}
+
+/* queue argv for the launcher, as child c */
+static int spawn_launch(struct spawn_child *c, const char *path,
+		char *const argv[])
+{
+	struct spawn_launch l = { c->id, c->deadline != 0, };
+	uint64_t one = 1;
+
+	if (spawn_pending >= spawn_launches.size)
+		return EAGAIN;
+
+	l.argv = spawn_argv_copy(path, argv, &l.path);
+	if (l.argv == NULL)
+		return ENOMEM;
+
+	ring_push(&spawn_launches, &l);
+	write(spawn_launch_fd, &one, sizeof(one));
+
+	c->pid = -1;
+	++spawn_pending;
+
+	return 0;
+}
+
+/*
+ * The helper: receives a request id followed by a command, runs the
+ * command through sh, and reports its wait status under that id once it
+ * has exited.
+ */
+static void spawn_helper(int fd)
+{
+	char buf[sizeof(u32) + SPAWN_MSG_MAX + 1];
+	char *const argv[] = {
+		"/bin/sh", "-c", buf + sizeof(u32), NULL
+	};
+	struct { pid_t pid; u32 id; } *jobs = NULL;
+	unsigned int maxjobs = 0;
+	unsigned int njobs = 0;
+	struct signalfd_siginfo si;
+	struct spawn_report r;
+	struct pollfd pfd[2];
+	sigset_t mask;
+	pid_t pid;
+	ssize_t n;
+
+	/* whatever else was open belongs to evev */
+	if (fd > 3)
+		close_range(3, fd - 1, 0);
+	close_range(fd + 1, ~0U, 0);
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigprocmask(SIG_SETMASK, &mask, NULL);
+
+	pfd[0].fd = fd;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = signalfd(-1, &mask, SFD_NONBLOCK);
+	pfd[1].events = POLLIN;
+	if (pfd[1].fd == -1)
+		_exit(1);
+
+	for (;;) {
+		if (poll(pfd, 2, -1) == -1)
+			continue;
+
+		while (read(pfd[1].fd, &si, sizeof(si)) == sizeof(si))
+			;
+
+		while ((pid = waitpid(-1, &r.status, WNOHANG)) > 0) {
+			for (unsigned int i = 0; i < njobs; ++i) {
+				if (jobs[i].pid != pid)
+					continue;
+
+				r.id = jobs[i].id;
+				send(fd, &r, sizeof(r), MSG_NOSIGNAL);
+				jobs[i] = jobs[--njobs];
+				break;
+			}
+		}
+
+		if ((pfd[0].revents & (POLLIN | POLLHUP | POLLERR)) == 0)
+			continue;
+
+		n = recv(fd, buf, sizeof(buf) - 1, MSG_DONTWAIT);
+		if (n == -1 && (errno == EINTR || errno == EAGAIN))
+			continue;
+		if (n < (ssize_t)sizeof(u32))
+			_exit(0);
+		buf[n] = '\0';
+		memcpy(&r.id, buf, sizeof(u32));
+
+		if (njobs == maxjobs) {
+			maxjobs = maxjobs ? maxjobs * 2 : 16;
+			jobs = realloc(jobs, maxjobs * sizeof(*jobs));
+			if (jobs == NULL)
+				_exit(1);
+		}
+
+		if (spawn_exec(argv[0], argv, &pid, 0)) {
+			/* as sh would have it */
+			r.status = 127 << 8;
+			send(fd, &r, sizeof(r), MSG_NOSIGNAL);
+			continue;
+		}
+
+		jobs[njobs].pid = pid;
+		jobs[njobs].id = r.id;
+		++njobs;
+	}
+}
+
+/*
+ * Start the helper that runs commands needing a shell, so the event loop
+ * only has to queue a message rather than wait for sh to be spawned.  It
+ * exits once this process closes the socket, including when it execs.
+ */
+static int spawn_helper_start(void)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	int sv[2];
+	pid_t pid;
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) == -1)
+		return -1;
+
+	ev.data.fd = sv[0];
+	if (epoll_ctl(spawn_efd, EPOLL_CTL_ADD, sv[0], &ev) == -1)
+		goto err;
+
+	pid = fork();
+	if (pid == -1)
+		goto err;
+
+	if (pid == 0) {
+		close(sv[0]);
+		spawn_helper(sv[1]);
+	}
+
+	close(sv[1]);
+	spawn_sock = sv[0];
+	spawn_helper_pid = pid;
+
+	return 0;
+
+err:
+	close(sv[0]);
+	close(sv[1]);
+	return -1;
+}
+
+int spawn_init(void)
+{
+	spawn_efd = epoll_create1(EPOLL_CLOEXEC);
+	if (spawn_efd == -1)
+		return -1;
+
+	return spawn_helper_start();
+}
+
+/*
+ * The descriptor which is readable when the helper has news of commands
+ * it ran; others are waited for on SIGCHLD.  Either way, call
+ * spawn_reap().
+ */
+int spawn_fd(void)
+{
+	return spawn_efd;
+}
+
+/*
+ * Give up on the helper; whatever it had running can't be accounted for
+ * any more.
+ */
+static void spawn_helper_stop(void)
+{
+	/* closing it takes it out of spawn_efd */
+	close(spawn_sock);
+	spawn_sock = -1;
+	spawn_helper_pid = 0;
+
+	for (unsigned int i = 0; i < spawn_nchildren; ) {
+		struct spawn_child *c = &spawn_children[i];
+
+		if (c->pid == 0) {
+			if (c->entry)
+				--c->entry->running;
+			*c = spawn_children[--spawn_nchildren];
+		} else {
+			++i;
+		}
+	}
+}
+
+/* hand command to the helper as request id, restarting it if need be */
+static int spawn_send(const char *command, u32 id)
+{
+	char buf[sizeof(u32) + SPAWN_MSG_MAX];
+	size_t len = strlen(command);
+
+	/* an empty command would read as the socket closing */
+	if (len == 0 || len > SPAWN_MSG_MAX)
+		return -1;
+
+	memcpy(buf, &id, sizeof(id));
+	memcpy(buf + sizeof(id), command, len);
+	len += sizeof(id);
+
+	if (spawn_sock != -1 && send(spawn_sock, buf, len,
+				MSG_DONTWAIT | MSG_NOSIGNAL) == len)
+		return 0;
+
+	/* a dead helper is restarted, a backed up one passed by */
+	if (spawn_sock != -1 && (errno == EAGAIN || errno == EINTR))
+		return -1;
+
+	if (spawn_sock != -1)
+		spawn_helper_stop();
+	if (spawn_efd == -1 || spawn_helper_start())
+		return -1;
+
+	return send(spawn_sock, buf, len, MSG_DONTWAIT | MSG_NOSIGNAL) == len ?
+		0 : -1;
+}
+
+static int spawn_start(struct spawn_entry *e, const char *command,
+		const struct spawn_vars *vars)
+{
+	const char *text = e ? e->text : command;
+	char *const shell[] = {
+		"/bin/sh", "-c", (char *)text, NULL
+	};
+	struct spawn_child c = { 0, };
+	struct spawn_child *children;
+	char *const *argv = NULL;
+	const char *path;
+	unsigned int n;
+	int rc;
+
+	if (spawn_max && spawn_nchildren >= spawn_max)
+		return EAGAIN;
+
+	if (spawn_nchildren == spawn_maxchildren) {
+		n = spawn_maxchildren ? spawn_maxchildren * 2 : 16;
+		children = realloc(spawn_children, n * sizeof(*children));
+		if (children == NULL)
+			return ENOMEM;
+		spawn_children = children;
+		spawn_maxchildren = n;
+	}
+
+	c.id = ++spawn_id;
+	c.start = spawn_now();
+	c.deadline = e && e->timeout ? c.start + e->timeout : 0;
+	c.entry = e;
+
+	if (e && e->argv) {
+		argv = e->nslots ? spawn_expand(e, vars) : e->argv;
+		path = e->path ? e->path : argv[0];
+	} else if (c.deadline || spawn_send(text, c.id)) {
+		argv = shell;
+		path = shell[0];
+	}
+
+	/* timed commands are ours to kill, in a group so that takes all */
+	if (argv == NULL)
+		rc = 0;
+	else if (spawn_launch_fd != -1)
+		rc = spawn_launch(&c, path, argv);
+	else
+		rc = spawn_exec(path, argv, &c.pid, c.deadline != 0);
+	if (rc)
+		return rc;
+
+	spawn_children[spawn_nchildren++] = c;
+	if (e)
+		++e->running;
+
+	return 0;
+}
+
+/* carry out a builtin action in place, accounted for as a run of e */
+static int spawn_builtin(struct spawn_entry *e)
+{
+	int rc = 0;
+
+	if (builtin_run(e->builtin))
+		rc = errno;
+
+	++e->runs;
+	if (rc)
+		++e->failures;
+	/* as if it exited with 1 on failure */
+	e->status = rc ? 1 << 8 : 0;
+
+	return rc;
+}
+
+/*
+ * Run command: in place if it is a builtin, directly if spawn_prepare()
+ * found it needs no shell, through the helper otherwise, unless its
+ * policy says to skip it.  Templates are filled in from vars, if given.
+ * Returns 0, or an errno value; EAGAIN if too many commands are running.
+ */
+int spawn_run(const char *command, const struct spawn_vars *vars)
+{
+	struct spawn_entry **slot;
+	struct spawn_entry *e;
+	u64 now;
+
+	slot = spawn_find(command, spawn_hash(command));
+	if (slot == NULL || *slot == NULL)
+		return spawn_start(NULL, command, vars);
+	e = *slot;
+
+	now = spawn_now();
+	if (e->interval && e->last && now - e->last < e->interval)
+		return 0;
+
+	if ((e->flags & SPAWN_SINGLE) && e->running) {
+		if (e->flags & SPAWN_QUEUE)
+			e->queued = 1;
+		return 0;
+	}
+
+	e->last = now;
+
+	if (e->builtin)
+		return spawn_builtin(e);
+
+	return spawn_start(e, command, vars);
+}
+
+/* account for the exit of child i, and start its command again if queued */
+static void spawn_done(unsigned int i, int status,
+		void (*done)(const char *command, int status, unsigned int ms))
+{
+	struct spawn_child *c = &spawn_children[i];
+	struct spawn_entry *e = c->entry;
+	unsigned int ms = spawn_now() - c->start;
+
+	spawn_children[i] = spawn_children[--spawn_nchildren];
+	if (e == NULL)
+		return;
+
+	--e->running;
+	++e->runs;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		++e->failures;
+	e->runtime += ms;
+	e->status = status;
+
+	if (done)
+		done(e->command, status, ms);
+
+	if (e->running == 0 && e->queued) {
+		e->queued = 0;
+		e->last = spawn_now();
+		/* what set off the run that was queued is long gone */
+		spawn_start(e, e->command, NULL);
+	}
+}
+
+static int spawn_child_find(pid_t pid, u32 id)
+{
+	for (unsigned int i = 0; i < spawn_nchildren; ++i) {
+		if (spawn_children[i].pid == pid &&
+				(pid > 0 || spawn_children[i].id == id))
+			return i;
+	}
+
+	return -1;
+}
+
+/* take in what the launcher started, or failed to */
+static void spawn_collect(void (*done)(const char *command, int status,
+			unsigned int ms))
+{
+	struct spawn_launched r;
+	uint64_t n;
+	int i;
+
+	read(spawn_launched_fd, &n, sizeof(n));
+
+	while (ring_pop(&spawn_launched, &r) == 0) {
+		--spawn_pending;
+
+		i = spawn_child_find(-1, r.id);
+		if (i == -1)
+			continue;
+
+		if (r.rc) {
+			/* as sh would have it */
+			spawn_done(i, 127 << 8, done);
+			continue;
+		}
+
+		spawn_children[i].pid = r.pid;
+		for (unsigned int j = 0; j < spawn_nearly; ++j) {
+			int status = spawn_early[j].status;
+
+			if (spawn_early[j].pid != r.pid)
+				continue;
+
+			spawn_early[j] = spawn_early[--spawn_nearly];
+			spawn_done(i, status, done);
+			break;
+		}
+	}
+
+	/* whatever is left wasn't any of them */
+	if (spawn_pending == 0)
+		spawn_nearly = 0;
+}
+
+/* make room to keep aside one more child reaped early */
+static int spawn_early_room(void)
+{
+	struct spawn_early *early;
+	unsigned int n;
+
+	if (spawn_nearly < spawn_maxearly)
+		return 0;
+
+	n = spawn_maxearly ? spawn_maxearly * 2 : 16;
+	early = realloc(spawn_early, n * sizeof(*early));
+	if (early == NULL)
+		return -1;
+	spawn_early = early;
+	spawn_maxearly = n;
+
+	return 0;
+}
+
+/*
+ * Reap every child which has exited, and collect the reports of the
+ * helper, accounting for each command and calling done, if given, with
+ * its wait status and how long it ran.  Children which aren't commands,
+ * such as the helper itself, are reaped all the same.
+ */
+void spawn_reap(void (*done)(const char *command, int status,
+			unsigned int ms))
+{
+	struct spawn_report r;
+	int helper = 0;
+	ssize_t n;
+	pid_t pid;
+	int i;
+
+	if (spawn_launched_fd != -1)
+		spawn_collect(done);
+
+	/* without room to keep a status aside, leave the rest for later */
+	while ((spawn_pending == 0 || spawn_early_room() == 0) &&
+			(pid = waitpid(-1, &r.status, WNOHANG)) > 0) {
+		if (pid == spawn_helper_pid)
+			helper = 1;
+
+		i = spawn_child_find(pid, 0);
+		if (i != -1) {
+			spawn_done(i, r.status, done);
+		} else if (spawn_pending) {
+			/* possibly launched, with the news still on its way */
+			spawn_early[spawn_nearly].pid = pid;
+			spawn_early[spawn_nearly].status = r.status;
+			++spawn_nearly;
+		}
+	}
+
+	/* reports outlast the helper, so take them before giving up on it */
+	while (spawn_sock != -1) {
+		n = recv(spawn_sock, &r, sizeof(r), MSG_DONTWAIT);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n == 0)
+			helper = 1;
+		if (n != sizeof(r))
+			break;
+
+		i = spawn_child_find(0, r.id);
+		if (i != -1)
+			spawn_done(i, r.status, done);
+	}
+
+	if (helper && spawn_sock != -1)
+		spawn_helper_stop();
+}
+
+/* milliseconds until a command is due to be killed, or -1 */
+int spawn_timeout(void)
+{
+	u64 now = spawn_now();
+	u64 next = 0;
+
+	for (unsigned int i = 0; i < spawn_nchildren; ++i) {
+		u64 deadline = spawn_children[i].deadline;
+
+		if (spawn_children[i].pid < 0)
+			continue;
+		if (deadline && (next == 0 || deadline < next))
+			next = deadline;
+	}
+
+	if (next == 0)
+		return -1;
+
+	return next > now ? next - now : 0;
+}
+
+/*
+ * Kill commands which ran past their timeout: SIGTERM first, SIGKILL if
+ * they are still around SPAWN_KILL_GRACE later.  They are ours to reap,
+ * so the process group can't have been reused meanwhile.
+ */
+void spawn_expire(void)
+{
+	u64 now = spawn_now();
+
+	for (unsigned int i = 0; i < spawn_nchildren; ++i) {
+		struct spawn_child *c = &spawn_children[i];
+
+		/* not started yet; it will be soon enough */
+		if (c->deadline == 0 || c->deadline > now || c->pid <= 0)
+			continue;
+
+		kill(-c->pid, c->killed ? SIGKILL : SIGTERM);
+		c->deadline = c->killed ? 0 : now + SPAWN_KILL_GRACE;
+		c->killed = 1;
+	}
+}
+
+/*
+ * Statistics of the prepared commands, one per call: *iter starts at 0.
+ * Returns -1 once there are no more.
+ */
+int spawn_stats(unsigned int *iter, struct spawn_stats *st)
+{
+	struct spawn_entry *e;
+
+	while (*iter < spawn_size) {
+		e = spawn_table[(*iter)++];
+		if (e == NULL)
+			continue;
+
+		st->command = e->command;
+		st->running = e->running;
+		st->runs = e->runs;
+		st->failures = e->failures;
+		st->runtime = e->runtime;
+		st->status = e->status;
+		return 0;
+	}
+
+	return -1;
+}
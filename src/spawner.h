@@ -0,0 +1,42 @@
+#ifndef __SPAWNER_H_
+#define __SPAWNER_H_
+
+#include "types.h"
+
+struct spawn_stats {
+	const char *command;
+	unsigned int running;
+	unsigned int runs;
+	unsigned int failures;
+	/* total milliseconds of finished runs */
+	u64 runtime;
+	/* wait status of the last run, or -1 */
+	int status;
+};
+
+/* what the templates of a command are filled in from, see spawn_run() */
+struct spawn_vars {
+	u64 time;
+	const char *device;
+	int (*value)(void *data, unsigned int typecode, int *value);
+	void *data;
+};
+
+struct ring;
+
+int spawn_init(void);
+int spawn_fd(void);
+int spawn_pipeline(unsigned int size);
+struct ring *spawn_queue(void);
+void spawn_limit(unsigned int max);
+void spawn_reset(void);
+int spawn_prepare(const char *command);
+void spawn_sweep(void);
+int spawn_run(const char *command, const struct spawn_vars *vars);
+void spawn_reap(void (*done)(const char *command, int status,
+			unsigned int ms));
+int spawn_timeout(void);
+void spawn_expire(void);
+int spawn_stats(unsigned int *iter, struct spawn_stats *st);
+
+#endif
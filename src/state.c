@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "context.h"
+#include "state.h"
+#include "types.h"
+
+#define STATE_MAGIC "evevstat"
+#define STATE_VERSION 3
+
+/*
+ * Runtime state of a context, as handed from one process to the next,
+ * along with a number telling the contexts of a process apart:
+ *   header
+ *   nstates * state_value
+ *   ninsns * state_insn
+ * Instructions are stored by structure so the receiving side, which may
+ * have compiled a different configuration, can match them with
+ * ctx_adopt().
+ */
+struct state_header {
+	char magic[8];
+	u32 version;
+	u32 nstates;
+	u32 ninsns;
+	u32 source;
+};
+
+/*
+ * pending is 1 + the source of a frame holding back next as the state's
+ * new value, if any
+ */
+struct state_value {
+	u32 typecode;
+	u32 value;
+	u32 pending;
+	u32 next;
+};
+
+enum {
+	STATE_ARMED	= (1 << 0),
+	STATE_DEAD	= (1 << 1),
+};
+
+struct state_insn {
+	u32 op;
+	u32 arg[3];
+	u64 end;
+	u32 result;
+	u32 flags;
+};
+
+static int state_write(int fd, const void *data, size_t len)
+{
+	const char *p = data;
+	ssize_t n;
+
+	while (len > 0) {
+		n = write(fd, p, len);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int state_read(int fd, void *data, size_t len)
+{
+	char *p = data;
+	ssize_t n;
+
+	while (len > 0) {
+		n = read(fd, p, len);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (n == 0)
+			return -1;
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/* write the runtime state of ctx, from source, to fd at its current offset */
+int state_save(struct context *ctx, unsigned int source, int fd)
+{
+	struct state_header hdr = { STATE_MAGIC, };
+	struct state_value *sv;
+	struct state_insn *si;
+	int rc = -1;
+
+	sv = calloc(ctx->nstates + 1, sizeof(*sv));
+	si = calloc(ctx->ninsns + 1, sizeof(*si));
+	if (sv == NULL || si == NULL)
+		goto out;
+
+	hdr.version = STATE_VERSION;
+	hdr.nstates = ctx->nstates;
+	hdr.ninsns = ctx->ninsns;
+	hdr.source = source;
+
+	for (unsigned int i = 0; i < ctx->nstates; ++i) {
+		sv[i].typecode = ctx->states[i].typecode;
+		sv[i].value = ctx->values[i];
+	}
+
+	for (unsigned int s = ctx->nframes; s-- > 0; ) {
+		const struct ctx_frame *f = &ctx->frames[s];
+
+		for (unsigned int i = 0; i < f->nstates; ++i) {
+			sv[f->states[i]].pending = s + 1;
+			sv[f->states[i]].next = f->values[i];
+		}
+	}
+
+	for (unsigned int i = 0; i < ctx->ninsns; ++i) {
+		const struct insn *in = &ctx->insns[i];
+
+		si[i].op = in->op;
+		si[i].result = ctx->results[i];
+		if (in->users == INSN_DEAD)
+			si[i].flags |= STATE_DEAD;
+
+		switch (in->op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			si[i].arg[0] = in->binop.left;
+			si[i].arg[1] = in->binop.right;
+			break;
+		case INSN_NOT:
+			si[i].arg[0] = in->not;
+			break;
+		case INSN_DUR:
+			si[i].arg[0] = in->dur.expr;
+			si[i].arg[1] = in->dur.duration;
+			si[i].end = in->dur.end;
+			if (in->dur.slot != -1)
+				si[i].flags |= STATE_ARMED;
+			break;
+		case INSN_CMP:
+			si[i].arg[0] = in->cmp.lookup;
+			si[i].arg[1] = in->cmp.cmp;
+			si[i].arg[2] = in->cmp.value;
+			break;
+		}
+	}
+
+	if (state_write(fd, &hdr, sizeof(hdr)) ||
+			state_write(fd, sv, ctx->nstates * sizeof(*sv)) ||
+			state_write(fd, si, ctx->ninsns * sizeof(*si)))
+		goto out;
+
+	rc = 0;
+
+out:
+	free(si);
+	free(sv);
+	return rc;
+}
+
+/*
+ * Read state written by state_save() from fd into old, a context only
+ * fit to be passed to ctx_adopt() and ctx_state_lookup(), and its source.
+ */
+int state_load(struct context *old, unsigned int *source, int fd)
+{
+	static const unsigned int none[1];
+	struct state_header hdr;
+	struct ctx_image img = { NULL, };
+	struct state_value *sv = NULL;
+	struct state_insn *si = NULL;
+	struct evstate *states = NULL;
+	struct insn *insns = NULL;
+	int rc = -1;
+
+	if (state_read(fd, &hdr, sizeof(hdr)) ||
+			memcmp(hdr.magic, STATE_MAGIC, sizeof(hdr.magic)) ||
+			hdr.version != STATE_VERSION ||
+			hdr.nstates >= 0xffff || hdr.ninsns > 0x7fffffff)
+		return -1;
+
+	sv = calloc(hdr.nstates + 1, sizeof(*sv));
+	si = calloc(hdr.ninsns + 1, sizeof(*si));
+	states = calloc(hdr.nstates + 1, sizeof(*states));
+	insns = calloc(hdr.ninsns + 1, sizeof(*insns));
+	if (sv == NULL || si == NULL || states == NULL || insns == NULL)
+		goto out;
+
+	if (state_read(fd, sv, hdr.nstates * sizeof(*sv)) ||
+			state_read(fd, si, hdr.ninsns * sizeof(*si)))
+		goto out;
+
+	for (unsigned int i = 0; i < hdr.nstates; ++i)
+		states[i].typecode = sv[i].typecode;
+
+	for (unsigned int i = 0; i < hdr.ninsns; ++i) {
+		struct insn *in = &insns[i];
+
+		in->op = si[i].op;
+
+		switch (in->op) {
+		case INSN_OR:
+		case INSN_XOR:
+		case INSN_AND:
+			in->binop.left = si[i].arg[0];
+			in->binop.right = si[i].arg[1];
+			break;
+		case INSN_NOT:
+			in->not = si[i].arg[0];
+			break;
+		case INSN_DUR:
+			in->dur.expr = si[i].arg[0];
+			in->dur.duration = si[i].arg[1];
+			break;
+		case INSN_CMP:
+			in->cmp.lookup = si[i].arg[0];
+			in->cmp.cmp = si[i].arg[1];
+			in->cmp.value = si[i].arg[2];
+			break;
+		}
+	}
+
+	img.states = states;
+	img.nstates = hdr.nstates;
+	img.listeners = none;
+	img.insns = insns;
+	img.ninsns = hdr.ninsns;
+	img.users = none;
+
+	/* validates the structure, and sets up the lookup tables */
+	if (ctx_load(old, &img, NULL, 0))
+		goto out;
+
+	for (unsigned int i = 0; i < hdr.nstates; ++i) {
+		old->values[i] = sv[i].value;
+		if (sv[i].pending &&
+				ctx_frame_add(old, sv[i].pending - 1, i,
+					sv[i].next)) {
+			ctx_free(old);
+			goto out;
+		}
+	}
+
+	for (unsigned int i = 0; i < hdr.ninsns; ++i) {
+		struct insn *in = &old->insns[i];
+
+		old->results[i] = si[i].result != 0;
+		if (si[i].flags & STATE_DEAD)
+			in->users = INSN_DEAD;
+		if (in->op == INSN_DUR) {
+			in->dur.end = si[i].end;
+			/* ctx_adopt() only asks whether it is armed */
+			in->dur.slot = (si[i].flags & STATE_ARMED) ? 0 : -1;
+		}
+	}
+
+	*source = hdr.source;
+	rc = 0;
+
+out:
+	free(insns);
+	free(states);
+	free(si);
+	free(sv);
+	return rc;
+}
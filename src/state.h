@@ -0,0 +1,9 @@
+#ifndef __STATE_H_
+#define __STATE_H_
+
+struct context;
+
+int state_save(struct context *ctx, unsigned int source, int fd);
+int state_load(struct context *old, unsigned int *source, int fd);
+
+#endif
@@ -0,0 +1,141 @@
+/* generated by evev -G; do not edit */
+
+#include <string.h>
+
+#include "context.h"
+
+static struct evstate states[4] = {
+	{ .typecode = 0x1001e, .listeners = 0, .nlisteners = 1 },
+	{ .typecode = 0x1002a, .listeners = 1, .nlisteners = 1 },
+	{ .typecode = 0x10030, .listeners = 2, .nlisteners = 1 },
+};
+
+static int values[4];
+
+static unsigned int listeners[4] = {
+	0x3, 0x2, 0,
+};
+
+static unsigned short lookup_1[49] = {
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0x1, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x2,
+};
+
+static struct insn insns[6] = {
+	{ .op = INSN_CMP, .users = 0, .nusers = 1, .cmp = { 2, EXPR_EQ, 1 } },
+	{ .op = INSN_DUR, .users = 1, .nusers = 1, .dur = { .expr = 0, .duration = 1000, .slot = -1 } },
+	{ .op = INSN_CMP, .users = 2, .nusers = 1, .cmp = { 1, EXPR_EQ, 1 } },
+	{ .op = INSN_CMP, .users = 3, .nusers = 1, .cmp = { 0, EXPR_EQ, 1 } },
+	{ .op = INSN_AND, .users = 4, .nusers = 1, .binop = { 2, 3 } },
+};
+
+static unsigned char results[6];
+static unsigned char queued[6];
+static unsigned int dirty[6];
+static unsigned int durations[2];
+
+static unsigned int users[6] = {
+	0x1, 0x80000000, 0x4, 0x4, 0x80000001,
+};
+
+static struct binding binding_1 = {
+	.root = 4,
+	.command = "echo shiftA",
+};
+
+static struct binding binding_0 = {
+	.root = 1,
+	.next = &binding_1,
+	.command = "echo holdB",
+};
+
+static struct binding *bindv[3] = {
+	&binding_0,
+	&binding_1,
+};
+
+static int root_1(struct context *ctx, u64 now)
+{
+	unsigned char *results = ctx->results;
+	const int *values = ctx->values;
+
+	results[0] = values[2] == 1;
+	results[1] = ctx_dur_eval(ctx, 1, now);
+
+	return results[1];
+}
+
+static int root_4(struct context *ctx, u64 now)
+{
+	unsigned char *results = ctx->results;
+	const int *values = ctx->values;
+
+	results[2] = values[1] == 1;
+	results[3] = values[0] == 1;
+	results[4] = results[2] & results[3];
+
+	return results[4];
+}
+
+static int (*const eval[3])(struct context *ctx, u64 now) = {
+	root_1,
+	root_4,
+};
+
+static unsigned int lists[13] = {
+	0x1, 0xffffffff, 0x1, 0xffffffff, 0, 0xffffffff, 0xffffffff, 0,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+
+static unsigned int gen_states[4] = {
+	0, 0x2, 0x4,
+};
+
+static unsigned int gen_durations[6] = {
+	0x6, 0x7, 0x9, 0xa, 0xb,
+};
+
+static unsigned char marked[3];
+static unsigned int pending[3];
+
+static struct ctx_gen gen = {
+	.eval = eval,
+	.states = gen_states,
+	.durations = gen_durations,
+	.lists = lists,
+	.marked = marked,
+	.pending = pending,
+};
+
+void ctx_static(struct context *ctx, unsigned int flags)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->flags = flags;
+
+	ctx->states = states;
+	ctx->values = values;
+	ctx->nstates = 3;
+	ctx->listeners = listeners;
+	ctx->nlisteners = 3;
+	ctx->bindings = &binding_0;
+	ctx->bindv = bindv;
+	ctx->nbindings = 2;
+
+	ctx->lookup[1] = lookup_1;
+	ctx->nlookup[1] = 49;
+
+	ctx->gen = &gen;
+	ctx->insns = insns;
+	ctx->results = results;
+	ctx->queued = queued;
+	ctx->ninsns = 5;
+	ctx->users = users;
+	ctx->nusers = 5;
+	ctx->dirty = dirty;
+	ctx->durations = durations;
+}
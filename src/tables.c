@@ -0,0 +1,2289 @@
+#include <string.h>
+
+#include "tables.h"
+#include "types.h"
+
+const char code_strings[] =
+	"\0"
+	"ABS_X\0"
+	"ABS_Y\0"
+	"ABS_Z\0"
+	"ABS_RX\0"
+	"ABS_RY\0"
+	"ABS_RZ\0"
+	"ABS_THROTTLE\0"
+	"ABS_RUDDER\0"
+	"ABS_WHEEL\0"
+	"ABS_GAS\0"
+	"ABS_BRAKE\0"
+	"ABS_HAT0X\0"
+	"ABS_HAT0Y\0"
+	"ABS_HAT1X\0"
+	"ABS_HAT1Y\0"
+	"ABS_HAT2X\0"
+	"ABS_HAT2Y\0"
+	"ABS_HAT3X\0"
+	"ABS_HAT3Y\0"
+	"ABS_PRESSURE\0"
+	"ABS_DISTANCE\0"
+	"ABS_TILT_X\0"
+	"ABS_TILT_Y\0"
+	"ABS_TOOL_WIDTH\0"
+	"ABS_VOLUME\0"
+	"ABS_PROFILE\0"
+	"ABS_MISC\0"
+	"ABS_RESERVED\0"
+	"ABS_MT_SLOT\0"
+	"ABS_MT_TOUCH_MAJOR\0"
+	"ABS_MT_TOUCH_MINOR\0"
+	"ABS_MT_WIDTH_MAJOR\0"
+	"ABS_MT_WIDTH_MINOR\0"
+	"ABS_MT_ORIENTATION\0"
+	"ABS_MT_POSITION_X\0"
+	"ABS_MT_POSITION_Y\0"
+	"ABS_MT_TOOL_TYPE\0"
+	"ABS_MT_BLOB_ID\0"
+	"ABS_MT_TRACKING_ID\0"
+	"ABS_MT_PRESSURE\0"
+	"ABS_MT_DISTANCE\0"
+	"ABS_MT_TOOL_X\0"
+	"ABS_MT_TOOL_Y\0"
+	"EV_SYN\0"
+	"EV_KEY\0"
+	"EV_REL\0"
+	"EV_ABS\0"
+	"EV_MSC\0"
+	"EV_SW\0"
+	"EV_LED\0"
+	"EV_SND\0"
+	"EV_REP\0"
+	"EV_FF\0"
+	"EV_PWR\0"
+	"EV_FF_STATUS\0"
+	"INPUT_PROP_POINTER\0"
+	"INPUT_PROP_DIRECT\0"
+	"INPUT_PROP_BUTTONPAD\0"
+	"INPUT_PROP_SEMI_MT\0"
+	"INPUT_PROP_TOPBUTTONPAD\0"
+	"INPUT_PROP_POINTING_STICK\0"
+	"INPUT_PROP_ACCELEROMETER\0"
+	"KEY_RESERVED\0"
+	"KEY_ESC\0"
+	"KEY_1\0"
+	"KEY_2\0"
+	"KEY_3\0"
+	"KEY_4\0"
+	"KEY_5\0"
+	"KEY_6\0"
+	"KEY_7\0"
+	"KEY_8\0"
+	"KEY_9\0"
+	"KEY_0\0"
+	"KEY_MINUS\0"
+	"KEY_EQUAL\0"
+	"KEY_BACKSPACE\0"
+	"KEY_TAB\0"
+	"KEY_Q\0"
+	"KEY_W\0"
+	"KEY_E\0"
+	"KEY_R\0"
+	"KEY_T\0"
+	"KEY_Y\0"
+	"KEY_U\0"
+	"KEY_I\0"
+	"KEY_O\0"
+	"KEY_P\0"
+	"KEY_LEFTBRACE\0"
+	"KEY_RIGHTBRACE\0"
+	"KEY_ENTER\0"
+	"KEY_LEFTCTRL\0"
+	"KEY_A\0"
+	"KEY_S\0"
+	"KEY_D\0"
+	"KEY_F\0"
+	"KEY_G\0"
+	"KEY_H\0"
+	"KEY_J\0"
+	"KEY_K\0"
+	"KEY_L\0"
+	"KEY_SEMICOLON\0"
+	"KEY_APOSTROPHE\0"
+	"KEY_GRAVE\0"
+	"KEY_LEFTSHIFT\0"
+	"KEY_BACKSLASH\0"
+	"KEY_Z\0"
+	"KEY_X\0"
+	"KEY_C\0"
+	"KEY_V\0"
+	"KEY_B\0"
+	"KEY_N\0"
+	"KEY_M\0"
+	"KEY_COMMA\0"
+	"KEY_DOT\0"
+	"KEY_SLASH\0"
+	"KEY_RIGHTSHIFT\0"
+	"KEY_KPASTERISK\0"
+	"KEY_LEFTALT\0"
+	"KEY_SPACE\0"
+	"KEY_CAPSLOCK\0"
+	"KEY_F1\0"
+	"KEY_F2\0"
+	"KEY_F3\0"
+	"KEY_F4\0"
+	"KEY_F5\0"
+	"KEY_F6\0"
+	"KEY_F7\0"
+	"KEY_F8\0"
+	"KEY_F9\0"
+	"KEY_F10\0"
+	"KEY_NUMLOCK\0"
+	"KEY_SCROLLLOCK\0"
+	"KEY_KP7\0"
+	"KEY_KP8\0"
+	"KEY_KP9\0"
+	"KEY_KPMINUS\0"
+	"KEY_KP4\0"
+	"KEY_KP5\0"
+	"KEY_KP6\0"
+	"KEY_KPPLUS\0"
+	"KEY_KP1\0"
+	"KEY_KP2\0"
+	"KEY_KP3\0"
+	"KEY_KP0\0"
+	"KEY_KPDOT\0"
+	"KEY_ZENKAKUHANKAKU\0"
+	"KEY_102ND\0"
+	"KEY_F11\0"
+	"KEY_F12\0"
+	"KEY_RO\0"
+	"KEY_KATAKANA\0"
+	"KEY_HIRAGANA\0"
+	"KEY_HENKAN\0"
+	"KEY_KATAKANAHIRAGANA\0"
+	"KEY_MUHENKAN\0"
+	"KEY_KPJPCOMMA\0"
+	"KEY_KPENTER\0"
+	"KEY_RIGHTCTRL\0"
+	"KEY_KPSLASH\0"
+	"KEY_SYSRQ\0"
+	"KEY_RIGHTALT\0"
+	"KEY_LINEFEED\0"
+	"KEY_HOME\0"
+	"KEY_UP\0"
+	"KEY_PAGEUP\0"
+	"KEY_LEFT\0"
+	"KEY_RIGHT\0"
+	"KEY_END\0"
+	"KEY_DOWN\0"
+	"KEY_PAGEDOWN\0"
+	"KEY_INSERT\0"
+	"KEY_DELETE\0"
+	"KEY_MACRO\0"
+	"KEY_MUTE\0"
+	"KEY_VOLUMEDOWN\0"
+	"KEY_VOLUMEUP\0"
+	"KEY_POWER\0"
+	"KEY_KPEQUAL\0"
+	"KEY_KPPLUSMINUS\0"
+	"KEY_PAUSE\0"
+	"KEY_SCALE\0"
+	"KEY_KPCOMMA\0"
+	"KEY_HANGEUL\0"
+	"KEY_HANJA\0"
+	"KEY_YEN\0"
+	"KEY_LEFTMETA\0"
+	"KEY_RIGHTMETA\0"
+	"KEY_COMPOSE\0"
+	"KEY_STOP\0"
+	"KEY_AGAIN\0"
+	"KEY_PROPS\0"
+	"KEY_UNDO\0"
+	"KEY_FRONT\0"
+	"KEY_COPY\0"
+	"KEY_OPEN\0"
+	"KEY_PASTE\0"
+	"KEY_FIND\0"
+	"KEY_CUT\0"
+	"KEY_HELP\0"
+	"KEY_MENU\0"
+	"KEY_CALC\0"
+	"KEY_SETUP\0"
+	"KEY_SLEEP\0"
+	"KEY_WAKEUP\0"
+	"KEY_FILE\0"
+	"KEY_SENDFILE\0"
+	"KEY_DELETEFILE\0"
+	"KEY_XFER\0"
+	"KEY_PROG1\0"
+	"KEY_PROG2\0"
+	"KEY_WWW\0"
+	"KEY_MSDOS\0"
+	"KEY_COFFEE\0"
+	"KEY_ROTATE_DISPLAY\0"
+	"KEY_CYCLEWINDOWS\0"
+	"KEY_MAIL\0"
+	"KEY_BOOKMARKS\0"
+	"KEY_COMPUTER\0"
+	"KEY_BACK\0"
+	"KEY_FORWARD\0"
+	"KEY_CLOSECD\0"
+	"KEY_EJECTCD\0"
+	"KEY_EJECTCLOSECD\0"
+	"KEY_NEXTSONG\0"
+	"KEY_PLAYPAUSE\0"
+	"KEY_PREVIOUSSONG\0"
+	"KEY_STOPCD\0"
+	"KEY_RECORD\0"
+	"KEY_REWIND\0"
+	"KEY_PHONE\0"
+	"KEY_ISO\0"
+	"KEY_CONFIG\0"
+	"KEY_HOMEPAGE\0"
+	"KEY_REFRESH\0"
+	"KEY_EXIT\0"
+	"KEY_MOVE\0"
+	"KEY_EDIT\0"
+	"KEY_SCROLLUP\0"
+	"KEY_SCROLLDOWN\0"
+	"KEY_KPLEFTPAREN\0"
+	"KEY_KPRIGHTPAREN\0"
+	"KEY_NEW\0"
+	"KEY_REDO\0"
+	"KEY_F13\0"
+	"KEY_F14\0"
+	"KEY_F15\0"
+	"KEY_F16\0"
+	"KEY_F17\0"
+	"KEY_F18\0"
+	"KEY_F19\0"
+	"KEY_F20\0"
+	"KEY_F21\0"
+	"KEY_F22\0"
+	"KEY_F23\0"
+	"KEY_F24\0"
+	"KEY_PLAYCD\0"
+	"KEY_PAUSECD\0"
+	"KEY_PROG3\0"
+	"KEY_PROG4\0"
+	"KEY_ALL_APPLICATIONS\0"
+	"KEY_SUSPEND\0"
+	"KEY_CLOSE\0"
+	"KEY_PLAY\0"
+	"KEY_FASTFORWARD\0"
+	"KEY_BASSBOOST\0"
+	"KEY_PRINT\0"
+	"KEY_HP\0"
+	"KEY_CAMERA\0"
+	"KEY_SOUND\0"
+	"KEY_QUESTION\0"
+	"KEY_EMAIL\0"
+	"KEY_CHAT\0"
+	"KEY_SEARCH\0"
+	"KEY_CONNECT\0"
+	"KEY_FINANCE\0"
+	"KEY_SPORT\0"
+	"KEY_SHOP\0"
+	"KEY_ALTERASE\0"
+	"KEY_CANCEL\0"
+	"KEY_BRIGHTNESSDOWN\0"
+	"KEY_BRIGHTNESSUP\0"
+	"KEY_MEDIA\0"
+	"KEY_SWITCHVIDEOMODE\0"
+	"KEY_KBDILLUMTOGGLE\0"
+	"KEY_KBDILLUMDOWN\0"
+	"KEY_KBDILLUMUP\0"
+	"KEY_SEND\0"
+	"KEY_REPLY\0"
+	"KEY_FORWARDMAIL\0"
+	"KEY_SAVE\0"
+	"KEY_DOCUMENTS\0"
+	"KEY_BATTERY\0"
+	"KEY_BLUETOOTH\0"
+	"KEY_WLAN\0"
+	"KEY_UWB\0"
+	"KEY_UNKNOWN\0"
+	"KEY_VIDEO_NEXT\0"
+	"KEY_VIDEO_PREV\0"
+	"KEY_BRIGHTNESS_CYCLE\0"
+	"KEY_BRIGHTNESS_AUTO\0"
+	"KEY_DISPLAY_OFF\0"
+	"KEY_WWAN\0"
+	"KEY_RFKILL\0"
+	"KEY_MICMUTE\0"
+	"BTN_0\0"
+	"BTN_MISC\0"
+	"BTN_1\0"
+	"BTN_2\0"
+	"BTN_3\0"
+	"BTN_4\0"
+	"BTN_5\0"
+	"BTN_6\0"
+	"BTN_7\0"
+	"BTN_8\0"
+	"BTN_9\0"
+	"BTN_LEFT\0"
+	"BTN_MOUSE\0"
+	"BTN_RIGHT\0"
+	"BTN_MIDDLE\0"
+	"BTN_SIDE\0"
+	"BTN_EXTRA\0"
+	"BTN_FORWARD\0"
+	"BTN_BACK\0"
+	"BTN_TASK\0"
+	"BTN_JOYSTICK\0"
+	"BTN_TRIGGER\0"
+	"BTN_THUMB\0"
+	"BTN_THUMB2\0"
+	"BTN_TOP\0"
+	"BTN_TOP2\0"
+	"BTN_PINKIE\0"
+	"BTN_BASE\0"
+	"BTN_BASE2\0"
+	"BTN_BASE3\0"
+	"BTN_BASE4\0"
+	"BTN_BASE5\0"
+	"BTN_BASE6\0"
+	"BTN_DEAD\0"
+	"BTN_GAMEPAD\0"
+	"BTN_SOUTH\0"
+	"BTN_EAST\0"
+	"BTN_C\0"
+	"BTN_NORTH\0"
+	"BTN_WEST\0"
+	"BTN_Z\0"
+	"BTN_TL\0"
+	"BTN_TR\0"
+	"BTN_TL2\0"
+	"BTN_TR2\0"
+	"BTN_SELECT\0"
+	"BTN_START\0"
+	"BTN_MODE\0"
+	"BTN_THUMBL\0"
+	"BTN_THUMBR\0"
+	"BTN_DIGI\0"
+	"BTN_TOOL_PEN\0"
+	"BTN_TOOL_RUBBER\0"
+	"BTN_TOOL_BRUSH\0"
+	"BTN_TOOL_PENCIL\0"
+	"BTN_TOOL_AIRBRUSH\0"
+	"BTN_TOOL_FINGER\0"
+	"BTN_TOOL_MOUSE\0"
+	"BTN_TOOL_LENS\0"
+	"BTN_TOOL_QUINTTAP\0"
+	"BTN_STYLUS3\0"
+	"BTN_TOUCH\0"
+	"BTN_STYLUS\0"
+	"BTN_STYLUS2\0"
+	"BTN_TOOL_DOUBLETAP\0"
+	"BTN_TOOL_TRIPLETAP\0"
+	"BTN_TOOL_QUADTAP\0"
+	"BTN_GEAR_DOWN\0"
+	"BTN_WHEEL\0"
+	"BTN_GEAR_UP\0"
+	"KEY_OK\0"
+	"KEY_SELECT\0"
+	"KEY_GOTO\0"
+	"KEY_CLEAR\0"
+	"KEY_POWER2\0"
+	"KEY_OPTION\0"
+	"KEY_INFO\0"
+	"KEY_TIME\0"
+	"KEY_VENDOR\0"
+	"KEY_ARCHIVE\0"
+	"KEY_PROGRAM\0"
+	"KEY_CHANNEL\0"
+	"KEY_FAVORITES\0"
+	"KEY_EPG\0"
+	"KEY_PVR\0"
+	"KEY_MHP\0"
+	"KEY_LANGUAGE\0"
+	"KEY_TITLE\0"
+	"KEY_SUBTITLE\0"
+	"KEY_ANGLE\0"
+	"KEY_FULL_SCREEN\0"
+	"KEY_MODE\0"
+	"KEY_KEYBOARD\0"
+	"KEY_ASPECT_RATIO\0"
+	"KEY_PC\0"
+	"KEY_TV\0"
+	"KEY_TV2\0"
+	"KEY_VCR\0"
+	"KEY_VCR2\0"
+	"KEY_SAT\0"
+	"KEY_SAT2\0"
+	"KEY_CD\0"
+	"KEY_TAPE\0"
+	"KEY_RADIO\0"
+	"KEY_TUNER\0"
+	"KEY_PLAYER\0"
+	"KEY_TEXT\0"
+	"KEY_DVD\0"
+	"KEY_AUX\0"
+	"KEY_MP3\0"
+	"KEY_AUDIO\0"
+	"KEY_VIDEO\0"
+	"KEY_DIRECTORY\0"
+	"KEY_LIST\0"
+	"KEY_MEMO\0"
+	"KEY_CALENDAR\0"
+	"KEY_RED\0"
+	"KEY_GREEN\0"
+	"KEY_YELLOW\0"
+	"KEY_BLUE\0"
+	"KEY_CHANNELUP\0"
+	"KEY_CHANNELDOWN\0"
+	"KEY_FIRST\0"
+	"KEY_LAST\0"
+	"KEY_AB\0"
+	"KEY_NEXT\0"
+	"KEY_RESTART\0"
+	"KEY_SLOW\0"
+	"KEY_SHUFFLE\0"
+	"KEY_BREAK\0"
+	"KEY_PREVIOUS\0"
+	"KEY_DIGITS\0"
+	"KEY_TEEN\0"
+	"KEY_TWEN\0"
+	"KEY_VIDEOPHONE\0"
+	"KEY_GAMES\0"
+	"KEY_ZOOMIN\0"
+	"KEY_ZOOMOUT\0"
+	"KEY_ZOOMRESET\0"
+	"KEY_WORDPROCESSOR\0"
+	"KEY_EDITOR\0"
+	"KEY_SPREADSHEET\0"
+	"KEY_GRAPHICSEDITOR\0"
+	"KEY_PRESENTATION\0"
+	"KEY_DATABASE\0"
+	"KEY_NEWS\0"
+	"KEY_VOICEMAIL\0"
+	"KEY_ADDRESSBOOK\0"
+	"KEY_MESSENGER\0"
+	"KEY_DISPLAYTOGGLE\0"
+	"KEY_SPELLCHECK\0"
+	"KEY_LOGOFF\0"
+	"KEY_DOLLAR\0"
+	"KEY_EURO\0"
+	"KEY_FRAMEBACK\0"
+	"KEY_FRAMEFORWARD\0"
+	"KEY_CONTEXT_MENU\0"
+	"KEY_MEDIA_REPEAT\0"
+	"KEY_10CHANNELSUP\0"
+	"KEY_10CHANNELSDOWN\0"
+	"KEY_IMAGES\0"
+	"KEY_NOTIFICATION_CENTER\0"
+	"KEY_PICKUP_PHONE\0"
+	"KEY_HANGUP_PHONE\0"
+	"KEY_LINK_PHONE\0"
+	"KEY_DEL_EOL\0"
+	"KEY_DEL_EOS\0"
+	"KEY_INS_LINE\0"
+	"KEY_DEL_LINE\0"
+	"KEY_FN\0"
+	"KEY_FN_ESC\0"
+	"KEY_FN_F1\0"
+	"KEY_FN_F2\0"
+	"KEY_FN_F3\0"
+	"KEY_FN_F4\0"
+	"KEY_FN_F5\0"
+	"KEY_FN_F6\0"
+	"KEY_FN_F7\0"
+	"KEY_FN_F8\0"
+	"KEY_FN_F9\0"
+	"KEY_FN_F10\0"
+	"KEY_FN_F11\0"
+	"KEY_FN_F12\0"
+	"KEY_FN_1\0"
+	"KEY_FN_2\0"
+	"KEY_FN_D\0"
+	"KEY_FN_E\0"
+	"KEY_FN_F\0"
+	"KEY_FN_S\0"
+	"KEY_FN_B\0"
+	"KEY_FN_RIGHT_SHIFT\0"
+	"KEY_BRL_DOT1\0"
+	"KEY_BRL_DOT2\0"
+	"KEY_BRL_DOT3\0"
+	"KEY_BRL_DOT4\0"
+	"KEY_BRL_DOT5\0"
+	"KEY_BRL_DOT6\0"
+	"KEY_BRL_DOT7\0"
+	"KEY_BRL_DOT8\0"
+	"KEY_BRL_DOT9\0"
+	"KEY_BRL_DOT10\0"
+	"KEY_NUMERIC_0\0"
+	"KEY_NUMERIC_1\0"
+	"KEY_NUMERIC_2\0"
+	"KEY_NUMERIC_3\0"
+	"KEY_NUMERIC_4\0"
+	"KEY_NUMERIC_5\0"
+	"KEY_NUMERIC_6\0"
+	"KEY_NUMERIC_7\0"
+	"KEY_NUMERIC_8\0"
+	"KEY_NUMERIC_9\0"
+	"KEY_NUMERIC_STAR\0"
+	"KEY_NUMERIC_POUND\0"
+	"KEY_NUMERIC_A\0"
+	"KEY_NUMERIC_B\0"
+	"KEY_NUMERIC_C\0"
+	"KEY_NUMERIC_D\0"
+	"KEY_CAMERA_FOCUS\0"
+	"KEY_WPS_BUTTON\0"
+	"KEY_TOUCHPAD_TOGGLE\0"
+	"KEY_TOUCHPAD_ON\0"
+	"KEY_TOUCHPAD_OFF\0"
+	"KEY_CAMERA_ZOOMIN\0"
+	"KEY_CAMERA_ZOOMOUT\0"
+	"KEY_CAMERA_UP\0"
+	"KEY_CAMERA_DOWN\0"
+	"KEY_CAMERA_LEFT\0"
+	"KEY_CAMERA_RIGHT\0"
+	"KEY_ATTENDANT_ON\0"
+	"KEY_ATTENDANT_OFF\0"
+	"KEY_ATTENDANT_TOGGLE\0"
+	"KEY_LIGHTS_TOGGLE\0"
+	"BTN_DPAD_UP\0"
+	"BTN_DPAD_DOWN\0"
+	"BTN_DPAD_LEFT\0"
+	"BTN_DPAD_RIGHT\0"
+	"KEY_ALS_TOGGLE\0"
+	"KEY_ROTATE_LOCK_TOGGLE\0"
+	"KEY_REFRESH_RATE_TOGGLE\0"
+	"KEY_BUTTONCONFIG\0"
+	"KEY_TASKMANAGER\0"
+	"KEY_JOURNAL\0"
+	"KEY_CONTROLPANEL\0"
+	"KEY_APPSELECT\0"
+	"KEY_SCREENSAVER\0"
+	"KEY_VOICECOMMAND\0"
+	"KEY_ASSISTANT\0"
+	"KEY_KBD_LAYOUT_NEXT\0"
+	"KEY_EMOJI_PICKER\0"
+	"KEY_DICTATE\0"
+	"KEY_BRIGHTNESS_MIN\0"
+	"KEY_KBDINPUTASSIST_PREV\0"
+	"KEY_KBDINPUTASSIST_NEXT\0"
+	"KEY_KBDINPUTASSIST_PREVGROUP\0"
+	"KEY_KBDINPUTASSIST_NEXTGROUP\0"
+	"KEY_KBDINPUTASSIST_ACCEPT\0"
+	"KEY_KBDINPUTASSIST_CANCEL\0"
+	"KEY_RIGHT_UP\0"
+	"KEY_RIGHT_DOWN\0"
+	"KEY_LEFT_UP\0"
+	"KEY_LEFT_DOWN\0"
+	"KEY_ROOT_MENU\0"
+	"KEY_MEDIA_TOP_MENU\0"
+	"KEY_NUMERIC_11\0"
+	"KEY_NUMERIC_12\0"
+	"KEY_AUDIO_DESC\0"
+	"KEY_3D_MODE\0"
+	"KEY_NEXT_FAVORITE\0"
+	"KEY_STOP_RECORD\0"
+	"KEY_PAUSE_RECORD\0"
+	"KEY_VOD\0"
+	"KEY_UNMUTE\0"
+	"KEY_FASTREVERSE\0"
+	"KEY_SLOWREVERSE\0"
+	"KEY_DATA\0"
+	"KEY_ONSCREEN_KEYBOARD\0"
+	"KEY_PRIVACY_SCREEN_TOGGLE\0"
+	"KEY_SELECTIVE_SCREENSHOT\0"
+	"KEY_NEXT_ELEMENT\0"
+	"KEY_PREVIOUS_ELEMENT\0"
+	"KEY_AUTOPILOT_ENGAGE_TOGGLE\0"
+	"KEY_MARK_WAYPOINT\0"
+	"KEY_SOS\0"
+	"KEY_NAV_CHART\0"
+	"KEY_FISHING_CHART\0"
+	"KEY_SINGLE_RANGE_RADAR\0"
+	"KEY_DUAL_RANGE_RADAR\0"
+	"KEY_RADAR_OVERLAY\0"
+	"KEY_TRADITIONAL_SONAR\0"
+	"KEY_CLEARVU_SONAR\0"
+	"KEY_SIDEVU_SONAR\0"
+	"KEY_NAV_INFO\0"
+	"KEY_BRIGHTNESS_MENU\0"
+	"KEY_MACRO1\0"
+	"KEY_MACRO2\0"
+	"KEY_MACRO3\0"
+	"KEY_MACRO4\0"
+	"KEY_MACRO5\0"
+	"KEY_MACRO6\0"
+	"KEY_MACRO7\0"
+	"KEY_MACRO8\0"
+	"KEY_MACRO9\0"
+	"KEY_MACRO10\0"
+	"KEY_MACRO11\0"
+	"KEY_MACRO12\0"
+	"KEY_MACRO13\0"
+	"KEY_MACRO14\0"
+	"KEY_MACRO15\0"
+	"KEY_MACRO16\0"
+	"KEY_MACRO17\0"
+	"KEY_MACRO18\0"
+	"KEY_MACRO19\0"
+	"KEY_MACRO20\0"
+	"KEY_MACRO21\0"
+	"KEY_MACRO22\0"
+	"KEY_MACRO23\0"
+	"KEY_MACRO24\0"
+	"KEY_MACRO25\0"
+	"KEY_MACRO26\0"
+	"KEY_MACRO27\0"
+	"KEY_MACRO28\0"
+	"KEY_MACRO29\0"
+	"KEY_MACRO30\0"
+	"KEY_MACRO_RECORD_START\0"
+	"KEY_MACRO_RECORD_STOP\0"
+	"KEY_MACRO_PRESET_CYCLE\0"
+	"KEY_MACRO_PRESET1\0"
+	"KEY_MACRO_PRESET2\0"
+	"KEY_MACRO_PRESET3\0"
+	"KEY_KBD_LCD_MENU1\0"
+	"KEY_KBD_LCD_MENU2\0"
+	"KEY_KBD_LCD_MENU3\0"
+	"KEY_KBD_LCD_MENU4\0"
+	"KEY_KBD_LCD_MENU5\0"
+	"BTN_TRIGGER_HAPPY\0"
+	"BTN_TRIGGER_HAPPY1\0"
+	"BTN_TRIGGER_HAPPY2\0"
+	"BTN_TRIGGER_HAPPY3\0"
+	"BTN_TRIGGER_HAPPY4\0"
+	"BTN_TRIGGER_HAPPY5\0"
+	"BTN_TRIGGER_HAPPY6\0"
+	"BTN_TRIGGER_HAPPY7\0"
+	"BTN_TRIGGER_HAPPY8\0"
+	"BTN_TRIGGER_HAPPY9\0"
+	"BTN_TRIGGER_HAPPY10\0"
+	"BTN_TRIGGER_HAPPY11\0"
+	"BTN_TRIGGER_HAPPY12\0"
+	"BTN_TRIGGER_HAPPY13\0"
+	"BTN_TRIGGER_HAPPY14\0"
+	"BTN_TRIGGER_HAPPY15\0"
+	"BTN_TRIGGER_HAPPY16\0"
+	"BTN_TRIGGER_HAPPY17\0"
+	"BTN_TRIGGER_HAPPY18\0"
+	"BTN_TRIGGER_HAPPY19\0"
+	"BTN_TRIGGER_HAPPY20\0"
+	"BTN_TRIGGER_HAPPY21\0"
+	"BTN_TRIGGER_HAPPY22\0"
+	"BTN_TRIGGER_HAPPY23\0"
+	"BTN_TRIGGER_HAPPY24\0"
+	"BTN_TRIGGER_HAPPY25\0"
+	"BTN_TRIGGER_HAPPY26\0"
+	"BTN_TRIGGER_HAPPY27\0"
+	"BTN_TRIGGER_HAPPY28\0"
+	"BTN_TRIGGER_HAPPY29\0"
+	"BTN_TRIGGER_HAPPY30\0"
+	"BTN_TRIGGER_HAPPY31\0"
+	"BTN_TRIGGER_HAPPY32\0"
+	"BTN_TRIGGER_HAPPY33\0"
+	"BTN_TRIGGER_HAPPY34\0"
+	"BTN_TRIGGER_HAPPY35\0"
+	"BTN_TRIGGER_HAPPY36\0"
+	"BTN_TRIGGER_HAPPY37\0"
+	"BTN_TRIGGER_HAPPY38\0"
+	"BTN_TRIGGER_HAPPY39\0"
+	"BTN_TRIGGER_HAPPY40\0"
+	"LED_NUML\0"
+	"LED_CAPSL\0"
+	"LED_SCROLLL\0"
+	"LED_COMPOSE\0"
+	"LED_KANA\0"
+	"LED_SLEEP\0"
+	"LED_SUSPEND\0"
+	"LED_MUTE\0"
+	"LED_MISC\0"
+	"LED_MAIL\0"
+	"LED_CHARGING\0"
+	"MSC_SERIAL\0"
+	"MSC_PULSELED\0"
+	"MSC_GESTURE\0"
+	"MSC_RAW\0"
+	"MSC_SCAN\0"
+	"MSC_TIMESTAMP\0"
+	"REL_X\0"
+	"REL_Y\0"
+	"REL_Z\0"
+	"REL_RX\0"
+	"REL_RY\0"
+	"REL_RZ\0"
+	"REL_HWHEEL\0"
+	"REL_DIAL\0"
+	"REL_WHEEL\0"
+	"REL_MISC\0"
+	"REL_RESERVED\0"
+	"REL_WHEEL_HI_RES\0"
+	"REL_HWHEEL_HI_RES\0"
+	"REP_DELAY\0"
+	"REP_PERIOD\0"
+	"SND_CLICK\0"
+	"SND_BELL\0"
+	"SND_TONE\0"
+	"SW_LID\0"
+	"SW_TABLET_MODE\0"
+	"SW_HEADPHONE_INSERT\0"
+	"SW_RFKILL_ALL\0"
+	"SW_MICROPHONE_INSERT\0"
+	"SW_DOCK\0"
+	"SW_LINEOUT_INSERT\0"
+	"SW_JACK_PHYSICAL_INSERT\0"
+	"SW_VIDEOOUT_INSERT\0"
+	"SW_CAMERA_LENS_COVER\0"
+	"SW_KEYPAD_SLIDE\0"
+	"SW_FRONT_PROXIMITY\0"
+	"SW_ROTATE_LOCK\0"
+	"SW_LINEIN_INSERT\0"
+	"SW_MUTE_DEVICE\0"
+	"SW_PEN_INSERTED\0"
+	"SW_MACHINE_COVER\0"
+	"SYN_REPORT\0"
+	"SYN_CONFIG\0"
+	"SYN_MT_REPORT\0"
+	"SYN_DROPPED\0"
+;
+
+#define CODE_SEED 0
+#define CODE_SIZE 739
+#define CODE_BUCKETS 184
+
+static const unsigned short code_disp[CODE_BUCKETS] = {
+	14, 1, 37, 18, 0, 45, 3, 4,
+	0, 4, 24, 21, 55, 0, 99, 1,
+	79, 1, 1, 54, 23, 7, 55, 2,
+	132, 3, 17, 4, 1, 0, 12, 438,
+	2, 0, 1, 14, 101, 96, 72, 53,
+	3, 59, 24, 82, 26, 24, 16, 47,
+	22, 135, 5, 14, 83, 28, 62, 38,
+	72, 105, 53, 1, 97, 125, 73, 105,
+	43, 215, 132, 175, 104, 71, 169, 251,
+	104, 307, 4, 227, 0, 7, 2, 193,
+	137, 172, 126, 0, 238, 4, 108, 183,
+	6, 203, 148, 21, 37, 7, 140, 234,
+	164, 8, 78, 84, 241, 18, 214, 6,
+	228, 202, 343, 675, 19, 4, 70, 163,
+	14, 0, 7, 6, 585, 2, 111, 1387,
+	68, 123, 27, 1127, 91, 5, 217, 0,
+	8, 22, 1173, 115, 109, 406, 9, 60,
+	142, 1, 7, 0, 1, 21, 198, 1,
+	0, 7, 22, 523, 21, 43, 958, 473,
+	28, 159, 191, 29, 5, 3474, 2, 33,
+	150, 2, 1189, 69, 4, 140, 97, 0,
+	4, 0, 283, 19, 1, 26, 7, 3173,
+	113, 515, 657, 30, 32, 0, 0, 17,
+};
+
+static const struct code_entry codetab[CODE_SIZE] = {
+	[   0] = {  3818, 0x1, 0x144 },	/* BTN_TOOL_AIRBRUSH */
+	[   1] = {  1914, 0x1, 0x7b },	/* KEY_HANJA */
+	[   2] = {  8798, 0x14, 0x1 },	/* REP_PERIOD */
+	[   3] = {  7654, 0x1, 0x2bc },	/* KEY_KBD_LCD_MENU5 */
+	[   4] = {   933, 0x1, 0x16 },	/* KEY_U */
+	[   5] = {  3082, 0x1, 0xe8 },	/* KEY_REPLY */
+	[   6] = {  1554, 0x1, 0x5c },	/* KEY_HENKAN */
+	[   7] = {  7120, 0x1, 0x291 },	/* KEY_MACRO2 */
+	[   8] = {  2747, 0x1, 0xcd },	/* KEY_SUSPEND */
+	[   9] = {  7564, 0x1, 0x2b5 },	/* KEY_MACRO_PRESET3 */
+	[  10] = {  5619, 0x1, 0x205 },	/* KEY_NUMERIC_5 */
+	[  11] = {  6573, 0x1, 0x26b },	/* KEY_MEDIA_TOP_MENU */
+	[  12] = {  1651, 0x1, 0x63 },	/* KEY_SYSRQ */
+	[  13] = {  7186, 0x1, 0x297 },	/* KEY_MACRO8 */
+	[  14] = {  4749, 0x1, 0x1a5 },	/* KEY_WORDPROCESSOR */
+	[  15] = {  6132, 0x1, 0x232 },	/* KEY_REFRESH_RATE_TOGGLE */
+	[  16] = {  4896, 0x1, 0x1af },	/* KEY_DISPLAYTOGGLE */
+	[  17] = {   292, 0x3, 0x30 },	/* ABS_MT_TOUCH_MAJOR */
+	[  18] = {   185, 0x3, 0x19 },	/* ABS_DISTANCE */
+	[  19] = {  2992, 0x1, 0xe2 },	/* KEY_MEDIA */
+	[  20] = {  3041, 0x1, 0xe5 },	/* KEY_KBDILLUMDOWN */
+	[  21] = {  7376, 0x1, 0x2a7 },	/* KEY_MACRO24 */
+	[  22] = {  6218, 0x1, 0x244 },	/* KEY_APPSELECT */
+	[  23] = {  6957, 0x1, 0x282 },	/* KEY_SINGLE_RANGE_RADAR */
+	[  24] = {  2759, 0x1, 0xce },	/* KEY_CLOSE */
+	[  25] = {  1870, 0x1, 0x77 },	/* KEY_PAUSE */
+	[  26] = {  9102, 0x5, 0x10 },	/* SW_MACHINE_COVER */
+	[  27] = {  4712, 0x1, 0x1a2 },	/* KEY_ZOOMIN */
+	[  28] = {   865, 0x1, 0xd },	/* KEY_EQUAL */
+	[  29] = {   723, 0, 0x5 },	/* INPUT_PROP_POINTING_STICK */
+	[  30] = {  4669, 0x1, 0x19e },	/* KEY_TEEN */
+	[  31] = {  2276, 0x1, 0x9d },	/* KEY_COMPUTER */
+	[  32] = {  3338, 0x1, 0x104 },	/* BTN_4 */
+	[  33] = {  6173, 0x1, 0x241 },	/* KEY_TASKMANAGER */
+	[  34] = {   198, 0x3, 0x1a },	/* ABS_TILT_X */
+	[  35] = {  3982, 0x1, 0x14f },	/* BTN_TOOL_QUADTAP */
+	[  36] = {  4189, 0x1, 0x16f },	/* KEY_MHP */
+	[  37] = {  1407, 0x1, 0x4c },	/* KEY_KP5 */
+	[  38] = {  2351, 0x1, 0xa3 },	/* KEY_NEXTSONG */
+	[  39] = {  3881, 0x1, 0x148 },	/* BTN_TOOL_QUINTTAP */
+	[  40] = {  1741, 0x1, 0x6c },	/* KEY_DOWN */
+	[  41] = {  1774, 0x1, 0x6f },	/* KEY_DELETE */
+	[  42] = {  1505, 0x1, 0x57 },	/* KEY_F11 */
+	[  43] = {  4623, 0x1, 0x19a },	/* KEY_SHUFFLE */
+	[  44] = {  2188, 0x1, 0x96 },	/* KEY_WWW */
+	[  45] = {   641, 0, 0x1 },	/* INPUT_PROP_DIRECT */
+	[  46] = {  2595, 0x1, 0xb8 },	/* KEY_F14 */
+	[  47] = {  1442, 0x1, 0x50 },	/* KEY_KP2 */
+	[  48] = {  1450, 0x1, 0x51 },	/* KEY_KP3 */
+	[  49] = {  9141, 0, 0x2 },	/* SYN_MT_REPORT */
+	[  50] = {  3556, 0x1, 0x128 },	/* BTN_BASE3 */
+	[  51] = {  3617, 0x1, 0x130 },	/* BTN_SOUTH */
+	[  52] = {  2196, 0x1, 0x97 },	/* KEY_MSDOS */
+	[  53] = {  5372, 0x1, 0x1e2 },	/* KEY_FN_F */
+	[  54] = {  1379, 0x1, 0x49 },	/* KEY_KP9 */
+	[  55] = {  4735, 0x1, 0x1a4 },	/* KEY_ZOOMRESET */
+	[  56] = {  6395, 0x1, 0x262 },	/* KEY_KBDINPUTASSIST_PREVGROUP */
+	[  57] = {  2778, 0x1, 0xd0 },	/* KEY_FASTFORWARD */
+	[  58] = {  8687, 0x2, 0x4 },	/* REL_RY */
+	[  59] = {  3596, 0x1, 0x12f },	/* BTN_DEAD */
+	[  60] = {  2470, 0x1, 0xad },	/* KEY_REFRESH */
+	[  61] = {  3186, 0x1, 0xf1 },	/* KEY_VIDEO_NEXT */
+	[  62] = {  3293, 0x1, 0xf8 },	/* KEY_MICMUTE */
+	[  63] = {  2406, 0x1, 0xa7 },	/* KEY_RECORD */
+	[  64] = {  1230, 0x1, 0x38 },	/* KEY_LEFTALT */
+	[  65] = {  4843, 0x1, 0x1ab },	/* KEY_NEWS */
+	[  66] = {  1021, 0x1, 0x20 },	/* KEY_D */
+	[  67] = {  5605, 0x1, 0x204 },	/* KEY_NUMERIC_4 */
+	[  68] = {  7690, 0x1, 0x2c0 },	/* BTN_TRIGGER_HAPPY1 */
+	[  69] = {  1399, 0x1, 0x4b },	/* KEY_KP4 */
+	[  70] = {  7861, 0x1, 0x2c9 },	/* BTN_TRIGGER_HAPPY10 */
+	[  71] = {   849, 0x1, 0xb },	/* KEY_0 */
+	[  72] = {  7785, 0x1, 0x2c5 },	/* BTN_TRIGGER_HAPPY6 */
+	[  73] = {  5812, 0x1, 0x212 },	/* KEY_TOUCHPAD_TOGGLE */
+	[  74] = {  1142, 0x1, 0x2e },	/* KEY_C */
+	[  75] = {  4013, 0x1, 0x150 },	/* BTN_WHEEL */
+	[  76] = {  7109, 0x1, 0x290 },	/* KEY_MACRO1 */
+	[  77] = {  7582, 0x1, 0x2b8 },	/* KEY_KBD_LCD_MENU1 */
+	[  78] = {  7961, 0x1, 0x2ce },	/* BTN_TRIGGER_HAPPY15 */
+	[  79] = {  1785, 0x1, 0x70 },	/* KEY_MACRO */
+	[  80] = {  8619, 0x4, 0x2 },	/* MSC_GESTURE */
+	[  81] = {  6735, 0x1, 0x276 },	/* KEY_SLOWREVERSE */
+	[  82] = {  5848, 0x1, 0x214 },	/* KEY_TOUCHPAD_OFF */
+	[  83] = {   875, 0x1, 0xe },	/* KEY_BACKSPACE */
+	[  84] = {  4042, 0x1, 0x161 },	/* KEY_SELECT */
+	[  85] = {  2019, 0x1, 0x85 },	/* KEY_COPY */
+	[  86] = {  1063, 0x1, 0x27 },	/* KEY_SEMICOLON */
+	[  87] = {  6505, 0x1, 0x266 },	/* KEY_RIGHT_UP */
+	[  88] = {   440, 0x3, 0x38 },	/* ABS_MT_BLOB_ID */
+	[  89] = {  4210, 0x1, 0x171 },	/* KEY_TITLE */
+	[  90] = {  1148, 0x1, 0x2f },	/* KEY_V */
+	[  91] = {  6622, 0x1, 0x26e },	/* KEY_AUDIO_DESC */
+	[  92] = {  3674, 0x1, 0x137 },	/* BTN_TR */
+	[  93] = {  3002, 0x1, 0xe3 },	/* KEY_SWITCHVIDEOMODE */
+	[  94] = {   555, 0, 0x3 },	/* EV_ABS */
+	[  95] = {  6533, 0x1, 0x268 },	/* KEY_LEFT_UP */
+	[  96] = {  2553, 0x1, 0xb4 },	/* KEY_KPRIGHTPAREN */
+	[  97] = {  7340, 0x1, 0x2a4 },	/* KEY_MACRO21 */
+	[  98] = {  4298, 0x1, 0x178 },	/* KEY_PC */
+	[  99] = {  1039, 0x1, 0x23 },	/* KEY_H */
+	[ 100] = {  1854, 0x1, 0x76 },	/* KEY_KPPLUSMINUS */
+	[ 101] = {   582, 0, 0x12 },	/* EV_SND */
+	[ 102] = {  2945, 0x1, 0xdf },	/* KEY_CANCEL */
+	[ 103] = {  6833, 0x1, 0x27b },	/* KEY_NEXT_ELEMENT */
+	[ 104] = {  4444, 0x1, 0x189 },	/* KEY_VIDEO */
+	[ 105] = {  6637, 0x1, 0x26f },	/* KEY_3D_MODE */
+	[ 106] = {   368, 0x3, 0x34 },	/* ABS_MT_ORIENTATION */
+	[ 107] = {  7412, 0x1, 0x2aa },	/* KEY_MACRO27 */
+	[ 108] = {   909, 0x1, 0x12 },	/* KEY_E */
+	[ 109] = {  1272, 0x1, 0x3c },	/* KEY_F2 */
+	[ 110] = {  2889, 0x1, 0xda },	/* KEY_CONNECT */
+	[ 111] = {  1321, 0x1, 0x43 },	/* KEY_F9 */
+	[ 112] = {  8441, 0x1, 0x2e6 },	/* BTN_TRIGGER_HAPPY39 */
+	[ 113] = {  1300, 0x1, 0x40 },	/* KEY_F6 */
+	[ 114] = {  3257, 0x1, 0xf5 },	/* KEY_DISPLAY_OFF */
+	[ 115] = {  6719, 0x1, 0x275 },	/* KEY_FASTREVERSE */
+	[ 116] = {  5916, 0x1, 0x218 },	/* KEY_CAMERA_DOWN */
+	[ 117] = {  2836, 0x1, 0xd5 },	/* KEY_SOUND */
+	[ 118] = {  7636, 0x1, 0x2bb },	/* KEY_KBD_LCD_MENU4 */
+	[ 119] = {  1639, 0x1, 0x62 },	/* KEY_KPSLASH */
+	[ 120] = {  2794, 0x1, 0xd1 },	/* KEY_BASSBOOST */
+	[ 121] = {  8221, 0x1, 0x2db },	/* BTN_TRIGGER_HAPPY28 */
+	[ 122] = {  3498, 0x1, 0x122 },	/* BTN_THUMB2 */
+	[ 123] = {  5354, 0x1, 0x1e0 },	/* KEY_FN_D */
+	[ 124] = {  6051, 0x1, 0x221 },	/* BTN_DPAD_DOWN */
+	[ 125] = {  5025, 0x1, 0x1b8 },	/* KEY_10CHANNELSUP */
+	[ 126] = {  1565, 0x1, 0x5d },	/* KEY_KATAKANAHIRAGANA */
+	[ 127] = {  3836, 0x1, 0x145 },	/* BTN_TOOL_FINGER */
+	[ 128] = {  2726, 0x1, 0xcc },	/* KEY_ALL_APPLICATIONS */
+	[ 129] = {  4361, 0x1, 0x180 },	/* KEY_TAPE */
+	[ 130] = {   246, 0x3, 0x21 },	/* ABS_PROFILE */
+	[ 131] = {  7672, 0x1, 0x2c0 },	/* BTN_TRIGGER_HAPPY */
+	[ 132] = {  1980, 0x1, 0x81 },	/* KEY_AGAIN */
+	[ 133] = {  4434, 0x1, 0x188 },	/* KEY_AUDIO */
+	[ 134] = {  2298, 0x1, 0x9f },	/* KEY_FORWARD */
+	[ 135] = {   589, 0, 0x14 },	/* EV_REP */
+	[ 136] = {  4687, 0x1, 0x1a0 },	/* KEY_VIDEOPHONE */
+	[ 137] = {  4401, 0x1, 0x184 },	/* KEY_TEXT */
+	[ 138] = {   455, 0x3, 0x39 },	/* ABS_MT_TRACKING_ID */
+	[ 139] = {    26, 0x3, 0x4 },	/* ABS_RY */
+	[ 140] = {  1336, 0x1, 0x45 },	/* KEY_NUMLOCK */
+	[ 141] = {  5008, 0x1, 0x1b7 },	/* KEY_MEDIA_REPEAT */
+	[ 142] = {  6299, 0x1, 0x249 },	/* KEY_EMOJI_PICKER */
+	[ 143] = {  2131, 0x1, 0x91 },	/* KEY_SENDFILE */
+	[ 144] = {  5948, 0x1, 0x21a },	/* KEY_CAMERA_RIGHT */
+	[ 145] = {  4468, 0x1, 0x18b },	/* KEY_LIST */
+	[ 146] = {  1279, 0x1, 0x3d },	/* KEY_F3 */
+	[ 147] = {  2178, 0x1, 0x95 },	/* KEY_PROG2 */
+	[ 148] = {  2675, 0x1, 0xc2 },	/* KEY_F24 */
+	[ 149] = {  3537, 0x1, 0x126 },	/* BTN_BASE */
+	[ 150] = {  9004, 0x5, 0xa },	/* SW_KEYPAD_SLIDE */
+	[ 151] = {  1466, 0x1, 0x53 },	/* KEY_KPDOT */
+	[ 152] = {  8662, 0x2, 0 },	/* REL_X */
+	[ 153] = {  1625, 0x1, 0x61 },	/* KEY_RIGHTCTRL */
+	[ 154] = {  6850, 0x1, 0x27c },	/* KEY_PREVIOUS_ELEMENT */
+	[ 155] = {  7268, 0x1, 0x29e },	/* KEY_MACRO15 */
+	[ 156] = {  3689, 0x1, 0x139 },	/* BTN_TR2 */
+	[ 157] = {  4023, 0x1, 0x151 },	/* BTN_GEAR_UP */
+	[ 158] = {  7823, 0x1, 0x2c7 },	/* BTN_TRIGGER_HAPPY8 */
+	[ 159] = {   622, 0, 0 },	/* INPUT_PROP_POINTER */
+	[ 160] = {  1215, 0x1, 0x37 },	/* KEY_KPASTERISK */
+	[ 161] = {  1328, 0x1, 0x44 },	/* KEY_F10 */
+	[ 162] = {  7220, 0x1, 0x29a },	/* KEY_MACRO11 */
+	[ 163] = {  4173, 0x1, 0x16d },	/* KEY_EPG */
+	[ 164] = {  3201, 0x1, 0xf2 },	/* KEY_VIDEO_PREV */
+	[ 165] = {  7483, 0x1, 0x2b1 },	/* KEY_MACRO_RECORD_STOP */
+	[ 166] = {  1057, 0x1, 0x26 },	/* KEY_L */
+	[ 167] = {  3344, 0x1, 0x105 },	/* BTN_5 */
+	[ 168] = {   986, 0x1, 0x1c },	/* KEY_ENTER */
+	[ 169] = {  5675, 0x1, 0x209 },	/* KEY_NUMERIC_9 */
+	[ 170] = {  1832, 0x1, 0x74 },	/* KEY_POWER */
+	[ 171] = {  4929, 0x1, 0x1b1 },	/* KEY_LOGOFF */
+	[ 172] = {  8121, 0x1, 0x2d6 },	/* BTN_TRIGGER_HAPPY23 */
+	[ 173] = {  5444, 0x1, 0x1f3 },	/* KEY_BRL_DOT3 */
+	[ 174] = {  7232, 0x1, 0x29b },	/* KEY_MACRO12 */
+	[ 175] = {  8281, 0x1, 0x2de },	/* BTN_TRIGGER_HAPPY31 */
+	[ 176] = {  7842, 0x1, 0x2c8 },	/* BTN_TRIGGER_HAPPY9 */
+	[ 177] = {  1842, 0x1, 0x75 },	/* KEY_KPEQUAL */
+	[ 178] = {  2901, 0x1, 0xdb },	/* KEY_FINANCE */
+	[ 179] = {  6201, 0x1, 0x243 },	/* KEY_CONTROLPANEL */
+	[ 180] = {  7175, 0x1, 0x296 },	/* KEY_MACRO7 */
+	[ 181] = {  2619, 0x1, 0xbb },	/* KEY_F17 */
+	[ 182] = {  7197, 0x1, 0x298 },	/* KEY_MACRO9 */
+	[ 183] = {  3852, 0x1, 0x146 },	/* BTN_TOOL_MOUSE */
+	[ 184] = {  3073, 0x1, 0xe7 },	/* KEY_SEND */
+	[ 185] = {  3433, 0x1, 0x115 },	/* BTN_FORWARD */
+	[ 186] = {   951, 0x1, 0x19 },	/* KEY_P */
+	[ 187] = {  8639, 0x4, 0x4 },	/* MSC_SCAN */
+	[ 188] = {    53, 0x3, 0x7 },	/* ABS_RUDDER */
+	[ 189] = {  1521, 0x1, 0x59 },	/* KEY_RO */
+	[ 190] = {  5661, 0x1, 0x208 },	/* KEY_NUMERIC_8 */
+	[ 191] = {  6607, 0x1, 0x26d },	/* KEY_NUMERIC_12 */
+	[ 192] = {  8879, 0x5, 0x3 },	/* SW_RFKILL_ALL */
+	[ 193] = {  5457, 0x1, 0x1f4 },	/* KEY_BRL_DOT4 */
+	[ 194] = {  1613, 0x1, 0x60 },	/* KEY_KPENTER */
+	[ 195] = {  8361, 0x1, 0x2e2 },	/* BTN_TRIGGER_HAPPY35 */
+	[ 196] = {  9086, 0x5, 0xf },	/* SW_PEN_INSERTED */
+	[ 197] = {  4960, 0x1, 0x1b4 },	/* KEY_FRAMEBACK */
+	[ 198] = {  4528, 0x1, 0x191 },	/* KEY_BLUE */
+	[ 199] = {   506, 0x3, 0x3c },	/* ABS_MT_TOOL_X */
+	[ 200] = {  7728, 0x1, 0x2c2 },	/* BTN_TRIGGER_HAPPY3 */
+	[ 201] = {  3586, 0x1, 0x12b },	/* BTN_BASE6 */
+	[ 202] = {  3652, 0x1, 0x134 },	/* BTN_WEST */
+	[ 203] = {  8543, 0x11, 0x6 },	/* LED_SUSPEND */
+	[ 204] = {  4337, 0x1, 0x17d },	/* KEY_SAT */
+	[ 205] = {  1434, 0x1, 0x4f },	/* KEY_KP1 */
+	[ 206] = {  1102, 0x1, 0x2a },	/* KEY_LEFTSHIFT */
+	[ 207] = {  1971, 0x1, 0x80 },	/* KEY_STOP */
+	[ 208] = {  7292, 0x1, 0x2a0 },	/* KEY_MACRO17 */
+	[ 209] = {  2846, 0x1, 0xd6 },	/* KEY_QUESTION */
+	[ 210] = {   311, 0x3, 0x31 },	/* ABS_MT_TOUCH_MINOR */
+	[ 211] = {  2322, 0x1, 0xa1 },	/* KEY_EJECTCD */
+	[ 212] = {   474, 0x3, 0x3a },	/* ABS_MT_PRESSURE */
+	[ 213] = {  5399, 0x1, 0x1e5 },	/* KEY_FN_RIGHT_SHIFT */
+	[ 214] = {  8081, 0x1, 0x2d4 },	/* BTN_TRIGGER_HAPPY21 */
+	[ 215] = {   774, 0x1, 0 },	/* KEY_RESERVED */
+	[ 216] = {  3921, 0x1, 0x14b },	/* BTN_STYLUS */
+	[ 217] = {  4259, 0x1, 0x175 },	/* KEY_MODE */
+	[ 218] = {  5591, 0x1, 0x203 },	/* KEY_NUMERIC_3 */
+	[ 219] = {  7528, 0x1, 0x2b3 },	/* KEY_MACRO_PRESET1 */
+	[ 220] = {  2064, 0x1, 0x8a },	/* KEY_HELP */
+	[ 221] = {  6700, 0x1, 0x273 },	/* KEY_VOD */
+	[ 222] = {  4159, 0x1, 0x16c },	/* KEY_FAVORITES */
+	[ 223] = {  3383, 0x1, 0x110 },	/* BTN_MOUSE */
+	[ 224] = {  5418, 0x1, 0x1f1 },	/* KEY_BRL_DOT1 */
+	[ 225] = {  2009, 0x1, 0x84 },	/* KEY_FRONT */
+	[ 226] = {  3143, 0x1, 0xed },	/* KEY_BLUETOOTH */
+	[ 227] = {  2482, 0x1, 0xae },	/* KEY_EXIT */
+	[ 228] = {  2056, 0x1, 0x89 },	/* KEY_CUT */
+	[ 229] = {  2000, 0x1, 0x83 },	/* KEY_UNDO */
+	[ 230] = {    92, 0x3, 0x10 },	/* ABS_HAT0X */
+	[ 231] = {  5303, 0x1, 0x1db },	/* KEY_FN_F10 */
+	[ 232] = {  8481, 0x11, 0 },	/* LED_NUML */
+	[ 233] = {  5738, 0x1, 0x20d },	/* KEY_NUMERIC_B */
+	[ 234] = {  3963, 0x1, 0x14e },	/* BTN_TOOL_TRIPLETAP */
+	[ 235] = {  9039, 0x5, 0xc },	/* SW_ROTATE_LOCK */
+	[ 236] = {  3092, 0x1, 0xe9 },	/* KEY_FORWARDMAIL */
+	[ 237] = {  1242, 0x1, 0x39 },	/* KEY_SPACE */
+	[ 238] = {  3326, 0x1, 0x102 },	/* BTN_2 */
+	[ 239] = {  2706, 0x1, 0xca },	/* KEY_PROG3 */
+	[ 240] = {  2716, 0x1, 0xcb },	/* KEY_PROG4 */
+	[ 241] = {  6925, 0x1, 0x280 },	/* KEY_NAV_CHART */
+	[ 242] = {  8837, 0x5, 0 },	/* SW_LID */
+	[ 243] = {  3356, 0x1, 0x107 },	/* BTN_7 */
+	[ 244] = {  9054, 0x5, 0xd },	/* SW_LINEIN_INSERT */
+	[ 245] = {  4035, 0x1, 0x160 },	/* KEY_OK */
+	[ 246] = {  6592, 0x1, 0x26c },	/* KEY_NUMERIC_11 */
+	[ 247] = {  2659, 0x1, 0xc0 },	/* KEY_F22 */
+	[ 248] = {  8694, 0x2, 0x5 },	/* REL_RZ */
+	[ 249] = {  4678, 0x1, 0x19f },	/* KEY_TWEN */
+	[ 250] = {  1363, 0x1, 0x47 },	/* KEY_KP7 */
+	[ 251] = {  3414, 0x1, 0x113 },	/* BTN_SIDE */
+	[ 252] = {  1027, 0x1, 0x21 },	/* KEY_F */
+	[ 253] = {  7364, 0x1, 0x2a6 },	/* KEY_MACRO23 */
+	[ 254] = {   819, 0x1, 0x6 },	/* KEY_5 */
+	[ 255] = {   927, 0x1, 0x15 },	/* KEY_Y */
+	[ 256] = {  1172, 0x1, 0x33 },	/* KEY_COMMA */
+	[ 257] = {  6479, 0x1, 0x265 },	/* KEY_KBDINPUTASSIST_CANCEL */
+	[ 258] = {  7424, 0x1, 0x2ab },	/* KEY_MACRO28 */
+	[ 259] = {  6760, 0x1, 0x278 },	/* KEY_ONSCREEN_KEYBOARD */
+	[ 260] = {  2683, 0x1, 0xc8 },	/* KEY_PLAYCD */
+	[ 261] = {   939, 0x1, 0x17 },	/* KEY_I */
+	[ 262] = {  4197, 0x1, 0x170 },	/* KEY_LANGUAGE */
+	[ 263] = {  5213, 0x1, 0x1d2 },	/* KEY_FN_F1 */
+	[ 264] = {  2457, 0x1, 0xac },	/* KEY_HOMEPAGE */
+	[ 265] = {  1015, 0x1, 0x1f },	/* KEY_S */
+	[ 266] = {  7901, 0x1, 0x2cb },	/* BTN_TRIGGER_HAPPY12 */
+	[ 267] = {  2395, 0x1, 0xa6 },	/* KEY_STOPCD */
+	[ 268] = {   795, 0x1, 0x2 },	/* KEY_1 */
+	[ 269] = {  8964, 0x5, 0x8 },	/* SW_VIDEOOUT_INSERT */
+	[ 270] = {  3642, 0x1, 0x133 },	/* BTN_NORTH */
+	[ 271] = {  1293, 0x1, 0x3f },	/* KEY_F5 */
+	[ 272] = {  5647, 0x1, 0x207 },	/* KEY_NUMERIC_7 */
+	[ 273] = {  4410, 0x1, 0x185 },	/* KEY_DVD */
+	[ 274] = {   813, 0x1, 0x5 },	/* KEY_4 */
+	[ 275] = {     1, 0x3, 0 },	/* ABS_X */
+	[ 276] = {  6000, 0x1, 0x21d },	/* KEY_ATTENDANT_TOGGLE */
+	[ 277] = {  2825, 0x1, 0xd4 },	/* KEY_CAMERA */
+	[ 278] = {  8819, 0x12, 0x1 },	/* SND_BELL */
+	[ 279] = {  8490, 0x11, 0x1 },	/* LED_CAPSL */
+	[ 280] = {   831, 0x1, 0x8 },	/* KEY_7 */
+	[ 281] = {  1307, 0x1, 0x41 },	/* KEY_F7 */
+	[ 282] = {  5243, 0x1, 0x1d5 },	/* KEY_FN_F4 */
+	[ 283] = {  4147, 0x1, 0x16b },	/* KEY_CHANNEL */
+	[ 284] = {  2491, 0x1, 0xaf },	/* KEY_MOVE */
+	[ 285] = {  8241, 0x1, 0x2dc },	/* BTN_TRIGGER_HAPPY29 */
+	[ 286] = {  4567, 0x1, 0x194 },	/* KEY_FIRST */
+	[ 287] = {  8721, 0x2, 0x8 },	/* REL_WHEEL */
+	[ 288] = {  8021, 0x1, 0x2d1 },	/* BTN_TRIGGER_HAPPY18 */
+	[ 289] = {  1750, 0x1, 0x6d },	/* KEY_PAGEDOWN */
+	[ 290] = {  6683, 0x1, 0x272 },	/* KEY_PAUSE_RECORD */
+	[ 291] = {  5345, 0x1, 0x1df },	/* KEY_FN_2 */
+	[ 292] = {  5223, 0x1, 0x1d3 },	/* KEY_FN_F2 */
+	[ 293] = {  2500, 0x1, 0xb0 },	/* KEY_EDIT */
+	[ 294] = {  7546, 0x1, 0x2b4 },	/* KEY_MACRO_PRESET2 */
+	[ 295] = {  6980, 0x1, 0x283 },	/* KEY_DUAL_RANGE_RADAR */
+	[ 296] = {  7709, 0x1, 0x2c1 },	/* BTN_TRIGGER_HAPPY2 */
+	[ 297] = {  6279, 0x1, 0x248 },	/* KEY_KBD_LAYOUT_NEXT */
+	[ 298] = {  5325, 0x1, 0x1dd },	/* KEY_FN_F12 */
+	[ 299] = {  4974, 0x1, 0x1b5 },	/* KEY_FRAMEFORWARD */
+	[ 300] = {  1136, 0x1, 0x2d },	/* KEY_X */
+	[ 301] = {  6079, 0x1, 0x223 },	/* BTN_DPAD_RIGHT */
+	[ 302] = {  1924, 0x1, 0x7c },	/* KEY_YEN */
+	[ 303] = {  2643, 0x1, 0xbe },	/* KEY_F20 */
+	[ 304] = {   855, 0x1, 0xc },	/* KEY_MINUS */
+	[ 305] = {  4723, 0x1, 0x1a3 },	/* KEY_ZOOMOUT */
+	[ 306] = {   152, 0x3, 0x16 },	/* ABS_HAT3X */
+	[ 307] = {  3605, 0x1, 0x130 },	/* BTN_GAMEPAD */
+	[ 308] = {  3667, 0x1, 0x136 },	/* BTN_TL */
+	[ 309] = {  2667, 0x1, 0xc1 },	/* KEY_F23 */
+	[ 310] = {  4123, 0x1, 0x169 },	/* KEY_ARCHIVE */
+	[ 311] = {  8712, 0x2, 0x7 },	/* REL_DIAL */
+	[ 312] = {  1714, 0x1, 0x69 },	/* KEY_LEFT */
+	[ 313] = {  4852, 0x1, 0x1ac },	/* KEY_VOICEMAIL */
+	[ 314] = {  4426, 0x1, 0x187 },	/* KEY_MP3 */
+	[ 315] = {  1415, 0x1, 0x4d },	/* KEY_KP6 */
+	[ 316] = {  3108, 0x1, 0xea },	/* KEY_SAVE */
+	[ 317] = {  8680, 0x2, 0x3 },	/* REL_RX */
+	[ 319] = {  8341, 0x1, 0x2e1 },	/* BTN_TRIGGER_HAPPY34 */
+	[ 320] = {  4370, 0x1, 0x181 },	/* KEY_RADIO */
+	[ 321] = {  8381, 0x1, 0x2e3 },	/* BTN_TRIGGER_HAPPY36 */
+	[ 322] = {  4320, 0x1, 0x17b },	/* KEY_VCR */
+	[ 323] = {   957, 0x1, 0x1a },	/* KEY_LEFTBRACE */
+	[ 324] = {  5752, 0x1, 0x20e },	/* KEY_NUMERIC_C */
+	[ 325] = {  5522, 0x1, 0x1f9 },	/* KEY_BRL_DOT9 */
+	[ 326] = {  4112, 0x1, 0x168 },	/* KEY_VENDOR */
+	[ 327] = {  3216, 0x1, 0xf3 },	/* KEY_BRIGHTNESS_CYCLE */
+	[ 328] = {  8828, 0x12, 0x2 },	/* SND_TONE */
+	[ 329] = {  5363, 0x1, 0x1e1 },	/* KEY_FN_E */
+	[ 330] = {   659, 0, 0x2 },	/* INPUT_PROP_BUTTONPAD */
+	[ 331] = {  3738, 0x1, 0x13e },	/* BTN_THUMBR */
+	[ 332] = {  5982, 0x1, 0x21c },	/* KEY_ATTENDANT_OFF */
+	[ 333] = {  4951, 0x1, 0x1b3 },	/* KEY_EURO */
+	[ 334] = {  6871, 0x1, 0x27d },	/* KEY_AUTOPILOT_ENGAGE_TOGGLE */
+	[ 335] = {  1723, 0x1, 0x6a },	/* KEY_RIGHT */
+	[ 336] = {  1687, 0x1, 0x66 },	/* KEY_HOME */
+	[ 337] = {  6424, 0x1, 0x263 },	/* KEY_KBDINPUTASSIST_NEXTGROUP */
+	[ 338] = {   921, 0x1, 0x14 },	/* KEY_T */
+	[ 339] = {  2446, 0x1, 0xab },	/* KEY_CONFIG */
+	[ 340] = {  1200, 0x1, 0x36 },	/* KEY_RIGHTSHIFT */
+	[ 341] = {  3463, 0x1, 0x120 },	/* BTN_JOYSTICK */
+	[ 342] = {   102, 0x3, 0x11 },	/* ABS_HAT0Y */
+	[ 343] = {  6371, 0x1, 0x261 },	/* KEY_KBDINPUTASSIST_NEXT */
+	[ 344] = {  6328, 0x1, 0x250 },	/* KEY_BRIGHTNESS_MIN */
+	[ 345] = {  7164, 0x1, 0x295 },	/* KEY_MACRO6 */
+	[ 346] = {  1154, 0x1, 0x30 },	/* KEY_B */
+	[ 347] = {  6808, 0x1, 0x27a },	/* KEY_SELECTIVE_SCREENSHOT */
+	[ 348] = {    19, 0x3, 0x3 },	/* ABS_RX */
+	[ 349] = {   807, 0x1, 0x4 },	/* KEY_3 */
+	[ 350] = {  2073, 0x1, 0x8b },	/* KEY_MENU */
+	[ 351] = {  4813, 0x1, 0x1a9 },	/* KEY_PRESENTATION */
+	[ 352] = {  1795, 0x1, 0x71 },	/* KEY_MUTE */
+	[ 353] = {  1703, 0x1, 0x68 },	/* KEY_PAGEUP */
+	[ 354] = {   837, 0x1, 0x9 },	/* KEY_8 */
+	[ 355] = {  3174, 0x1, 0xf0 },	/* KEY_UNKNOWN */
+	[ 356] = {  5169, 0x1, 0x1c2 },	/* KEY_INS_LINE */
+	[ 357] = {  2869, 0x1, 0xd8 },	/* KEY_CHAT */
+	[ 358] = {  8401, 0x1, 0x2e4 },	/* BTN_TRIGGER_HAPPY37 */
+	[ 359] = {  4778, 0x1, 0x1a7 },	/* KEY_SPREADSHEET */
+	[ 360] = {   903, 0x1, 0x11 },	/* KEY_W */
+	[ 361] = {  3282, 0x1, 0xf7 },	/* KEY_RFKILL */
+	[ 362] = {  4072, 0x1, 0x164 },	/* KEY_POWER2 */
+	[ 363] = {  7041, 0x1, 0x286 },	/* KEY_CLEARVU_SONAR */
+	[ 364] = {  3374, 0x1, 0x110 },	/* BTN_LEFT */
+	[ 365] = {  8606, 0x4, 0x1 },	/* MSC_PULSELED */
+	[ 366] = {  7059, 0x1, 0x287 },	/* KEY_SIDEVU_SONAR */
+	[ 367] = {  2101, 0x1, 0x8e },	/* KEY_SLEEP */
+	[ 368] = {  8648, 0x4, 0x5 },	/* MSC_TIMESTAMP */
+	[ 369] = {  7001, 0x1, 0x284 },	/* KEY_RADAR_OVERLAY */
+	[ 370] = {  2028, 0x1, 0x86 },	/* KEY_OPEN */
+	[ 371] = {  8201, 0x1, 0x2da },	/* BTN_TRIGGER_HAPPY27 */
+	[ 372] = {  4794, 0x1, 0x1a8 },	/* KEY_GRAPHICSEDITOR */
+	[ 373] = {  2522, 0x1, 0xb2 },	/* KEY_SCROLLDOWN */
+	[ 374] = {  6545, 0x1, 0x269 },	/* KEY_LEFT_DOWN */
+	[ 375] = {  4418, 0x1, 0x186 },	/* KEY_AUX */
+	[ 377] = {   945, 0x1, 0x18 },	/* KEY_O */
+	[ 378] = {  8500, 0x11, 0x2 },	/* LED_SCROLLL */
+	[ 379] = {   897, 0x1, 0x10 },	/* KEY_Q */
+	[ 380] = {  4645, 0x1, 0x19c },	/* KEY_PREVIOUS */
+	[ 381] = {  2428, 0x1, 0xa9 },	/* KEY_PHONE */
+	[ 382] = {  1265, 0x1, 0x3b },	/* KEY_F1 */
+	[ 383] = {  2262, 0x1, 0x9c },	/* KEY_BOOKMARKS */
+	[ 384] = {  8461, 0x1, 0x2e7 },	/* BTN_TRIGGER_HAPPY40 */
+	[ 385] = {  1423, 0x1, 0x4e },	/* KEY_KPPLUS */
+	[ 386] = {  7316, 0x1, 0x2a2 },	/* KEY_MACRO19 */
+	[ 387] = {    64, 0x3, 0x8 },	/* ABS_WHEEL */
+	[ 388] = {  1763, 0x1, 0x6e },	/* KEY_INSERT */
+	[ 389] = {  7244, 0x1, 0x29c },	/* KEY_MACRO13 */
+	[ 390] = {  1890, 0x1, 0x79 },	/* KEY_KPCOMMA */
+	[ 391] = {  6518, 0x1, 0x267 },	/* KEY_RIGHT_DOWN */
+	[ 392] = {  4991, 0x1, 0x1b6 },	/* KEY_CONTEXT_MENU */
+	[ 393] = {  3320, 0x1, 0x101 },	/* BTN_1 */
+	[ 394] = {  2159, 0x1, 0x93 },	/* KEY_XFER */
+	[ 395] = {  1458, 0x1, 0x52 },	/* KEY_KP0 */
+	[ 396] = {   112, 0x3, 0x12 },	/* ABS_HAT1X */
+	[ 397] = {  4614, 0x1, 0x199 },	/* KEY_SLOW */
+	[ 398] = {  8573, 0x11, 0x9 },	/* LED_MAIL */
+	[ 399] = {   132, 0x3, 0x14 },	/* ABS_HAT2X */
+	[ 400] = {  3681, 0x1, 0x138 },	/* BTN_TL2 */
+	[ 401] = {  5431, 0x1, 0x1f2 },	/* KEY_BRL_DOT2 */
+	[ 402] = {  1314, 0x1, 0x42 },	/* KEY_F8 */
+	[ 403] = {  5061, 0x1, 0x1ba },	/* KEY_IMAGES */
+	[ 404] = {  2578, 0x1, 0xb6 },	/* KEY_REDO */
+	[ 405] = {  7804, 0x1, 0x2c6 },	/* BTN_TRIGGER_HAPPY7 */
+	[ 406] = {  3131, 0x1, 0xec },	/* KEY_BATTERY */
+	[ 407] = {  1371, 0x1, 0x48 },	/* KEY_KP8 */
+	[ 408] = {  2082, 0x1, 0x8c },	/* KEY_CALC */
+	[ 409] = {  2417, 0x1, 0xa8 },	/* KEY_REWIND */
+	[ 410] = {  2913, 0x1, 0xdc },	/* KEY_SPORT */
+	[ 411] = {  1051, 0x1, 0x25 },	/* KEY_K */
+	[ 412] = {  1286, 0x1, 0x3e },	/* KEY_F4 */
+	[ 413] = {  4390, 0x1, 0x183 },	/* KEY_PLAYER */
+	[ 414] = {  8940, 0x5, 0x7 },	/* SW_JACK_PHYSICAL_INSERT */
+	[ 415] = {  3445, 0x1, 0x116 },	/* BTN_BACK */
+	[ 416] = {  4635, 0x1, 0x19b },	/* KEY_BREAK */
+	[ 417] = {  1696, 0x1, 0x67 },	/* KEY_UP */
+	[ 418] = {  5233, 0x1, 0x1d4 },	/* KEY_FN_F3 */
+	[ 419] = {    33, 0x3, 0x5 },	/* ABS_RZ */
+	[ 420] = {  6917, 0x1, 0x27f },	/* KEY_SOS */
+	[ 421] = {  5130, 0x1, 0x1bf },	/* KEY_LINK_PHONE */
+	[ 422] = {  8101, 0x1, 0x2d5 },	/* BTN_TRIGGER_HAPPY22 */
+	[ 423] = {  3454, 0x1, 0x117 },	/* BTN_TASK */
+	[ 424] = {  4103, 0x1, 0x167 },	/* KEY_TIME */
+	[ 425] = {  8161, 0x1, 0x2d8 },	/* BTN_TRIGGER_HAPPY25 */
+	[ 426] = {   142, 0x3, 0x15 },	/* ABS_HAT2Y */
+	[ 427] = {   258, 0x3, 0x28 },	/* ABS_MISC */
+	[ 428] = {  8512, 0x11, 0x3 },	/* LED_COMPOSE */
+	[ 429] = {   996, 0x1, 0x1d },	/* KEY_LEFTCTRL */
+	[ 430] = {  7448, 0x1, 0x2ad },	/* KEY_MACRO30 */
+	[ 431] = {  5273, 0x1, 0x1d8 },	/* KEY_FN_F7 */
+	[ 432] = {  7766, 0x1, 0x2c4 },	/* BTN_TRIGGER_HAPPY5 */
+	[ 433] = {  1990, 0x1, 0x82 },	/* KEY_PROPS */
+	[ 434] = {  5535, 0x1, 0x1fa },	/* KEY_BRL_DOT10 */
+	[ 435] = {  3157, 0x1, 0xee },	/* KEY_WLAN */
+	[ 436] = {  6708, 0x1, 0x274 },	/* KEY_UNMUTE */
+	[ 437] = {  2310, 0x1, 0xa0 },	/* KEY_CLOSECD */
+	[ 438] = {  8753, 0x2, 0xb },	/* REL_WHEEL_HI_RES */
+	[ 439] = {  5883, 0x1, 0x216 },	/* KEY_CAMERA_ZOOMOUT */
+	[ 440] = {  7921, 0x1, 0x2cc },	/* BTN_TRIGGER_HAPPY13 */
+	[ 441] = {  6453, 0x1, 0x264 },	/* KEY_KBDINPUTASSIST_ACCEPT */
+	[ 442] = {  6065, 0x1, 0x222 },	/* BTN_DPAD_LEFT */
+	[ 443] = {  4062, 0x1, 0x163 },	/* KEY_CLEAR */
+	[ 444] = {  2047, 0x1, 0x88 },	/* KEY_FIND */
+	[ 445] = {  2168, 0x1, 0x94 },	/* KEY_PROG1 */
+	[ 446] = {  5577, 0x1, 0x202 },	/* KEY_NUMERIC_2 */
+	[ 447] = {   562, 0, 0x4 },	/* EV_MSC */
+	[ 448] = {  8983, 0x5, 0x9 },	/* SW_CAMERA_LENS_COVER */
+	[ 449] = {  3362, 0x1, 0x108 },	/* BTN_8 */
+	[ 450] = {  4517, 0x1, 0x190 },	/* KEY_YELLOW */
+	[ 451] = {  6265, 0x1, 0x247 },	/* KEY_ASSISTANT */
+	[ 452] = {  4593, 0x1, 0x197 },	/* KEY_NEXT */
+	[ 453] = {  1804, 0x1, 0x72 },	/* KEY_VOLUMEDOWN */
+	[ 454] = {  3476, 0x1, 0x120 },	/* BTN_TRIGGER */
+	[ 455] = {  3727, 0x1, 0x13d },	/* BTN_THUMBL */
+	[ 456] = {  4767, 0x1, 0x1a6 },	/* KEY_EDITOR */
+	[ 457] = {   520, 0x3, 0x3d },	/* ABS_MT_TOOL_Y */
+	[ 458] = {  5157, 0x1, 0x1c1 },	/* KEY_DEL_EOS */
+	[ 459] = {   680, 0, 0x3 },	/* INPUT_PROP_SEMI_MT */
+	[ 460] = {  1045, 0x1, 0x24 },	/* KEY_J */
+	[ 461] = {  3944, 0x1, 0x14d },	/* BTN_TOOL_DOUBLETAP */
+	[ 462] = {  6751, 0x1, 0x277 },	/* KEY_DATA */
+	[ 463] = {  3802, 0x1, 0x143 },	/* BTN_TOOL_PENCIL */
+	[ 464] = {  4537, 0x1, 0x192 },	/* KEY_CHANNELUP */
+	[ 465] = {  1541, 0x1, 0x5b },	/* KEY_HIRAGANA */
+	[ 466] = {  9119, 0, 0 },	/* SYN_REPORT */
+	[ 467] = {  6094, 0x1, 0x230 },	/* KEY_ALS_TOGGLE */
+	[ 468] = {  4882, 0x1, 0x1ae },	/* KEY_MESSENGER */
+	[ 469] = {  3718, 0x1, 0x13c },	/* BTN_MODE */
+	[ 470] = {  2206, 0x1, 0x98 },	/* KEY_COFFEE */
+	[ 471] = {  8914, 0x5, 0x5 },	/* SW_DOCK */
+	[ 472] = {   490, 0x3, 0x3b },	/* ABS_MT_DISTANCE */
+	[ 473] = {  4181, 0x1, 0x16e },	/* KEY_PVR */
+	[ 474] = {  3509, 0x1, 0x123 },	/* BTN_TOP */
+	[ 475] = {  6039, 0x1, 0x220 },	/* BTN_DPAD_UP */
+	[ 476] = {  4345, 0x1, 0x17e },	/* KEY_SAT2 */
+	[ 477] = {  9130, 0, 0x1 },	/* SYN_CONFIG */
+	[ 478] = {  8731, 0x2, 0x9 },	/* REL_MISC */
+	[ 479] = {  3911, 0x1, 0x14a },	/* BTN_TOUCH */
+	[ 480] = {   825, 0x1, 0x7 },	/* KEY_6 */
+	[ 481] = {  6109, 0x1, 0x231 },	/* KEY_ROTATE_LOCK_TOGGLE */
+	[ 482] = {  4658, 0x1, 0x19d },	/* KEY_DIGITS */
+	[ 483] = {  5072, 0x1, 0x1bc },	/* KEY_NOTIFICATION_CENTER */
+	[ 484] = {  8582, 0x11, 0xa },	/* LED_CHARGING */
+	[ 485] = {  4507, 0x1, 0x18f },	/* KEY_GREEN */
+	[ 486] = {  8674, 0x2, 0x2 },	/* REL_Z */
+	[ 487] = {   172, 0x3, 0x18 },	/* ABS_PRESSURE */
+	[ 488] = {  2956, 0x1, 0xe0 },	/* KEY_BRIGHTNESSDOWN */
+	[ 489] = {  3368, 0x1, 0x109 },	/* BTN_9 */
+	[ 490] = {  5263, 0x1, 0x1d7 },	/* KEY_FN_F6 */
+	[ 491] = {  4233, 0x1, 0x173 },	/* KEY_ANGLE */
+	[ 492] = {  5832, 0x1, 0x213 },	/* KEY_TOUCHPAD_ON */
+	[ 493] = {  2144, 0x1, 0x92 },	/* KEY_DELETEFILE */
+	[ 494] = {  6021, 0x1, 0x21e },	/* KEY_LIGHTS_TOGGLE */
+	[ 495] = {   220, 0x3, 0x1c },	/* ABS_TOOL_WIDTH */
+	[ 496] = {  5689, 0x1, 0x20a },	/* KEY_NUMERIC_STAR */
+	[ 497] = {  6899, 0x1, 0x27e },	/* KEY_MARK_WAYPOINT */
+	[ 498] = {   541, 0, 0x1 },	/* EV_KEY */
+	[ 499] = {  6232, 0x1, 0x245 },	/* KEY_SCREENSAVER */
+	[ 500] = {  7304, 0x1, 0x2a1 },	/* KEY_MACRO18 */
+	[ 501] = {  5293, 0x1, 0x1da },	/* KEY_FN_F9 */
+	[ 502] = {  1945, 0x1, 0x7e },	/* KEY_RIGHTMETA */
+	[ 503] = {  3627, 0x1, 0x131 },	/* BTN_EAST */
+	[ 504] = {  4477, 0x1, 0x18c },	/* KEY_MEMO */
+	[ 505] = {   423, 0x3, 0x37 },	/* ABS_MT_TOOL_TYPE */
+	[ 506] = {  4281, 0x1, 0x177 },	/* KEY_ASPECT_RATIO */
+	[ 507] = {  4577, 0x1, 0x195 },	/* KEY_LAST */
+	[ 508] = {  5797, 0x1, 0x211 },	/* KEY_WPS_BUTTON */
+	[ 509] = {  7941, 0x1, 0x2cd },	/* BTN_TRIGGER_HAPPY14 */
+	[ 510] = {  7352, 0x1, 0x2a5 },	/* KEY_MACRO22 */
+	[ 511] = {  3517, 0x1, 0x124 },	/* BTN_TOP2 */
+	[ 512] = {  3999, 0x1, 0x150 },	/* BTN_GEAR_DOWN */
+	[ 513] = {  3546, 0x1, 0x127 },	/* BTN_BASE2 */
+	[ 514] = {   596, 0, 0x15 },	/* EV_FF */
+	[ 515] = {  2769, 0x1, 0xcf },	/* KEY_PLAY */
+	[ 516] = {  4830, 0x1, 0x1aa },	/* KEY_DATABASE */
+	[ 517] = {  3526, 0x1, 0x125 },	/* BTN_PINKIE */
+	[ 518] = {  3771, 0x1, 0x141 },	/* BTN_TOOL_RUBBER */
+	[ 519] = {  2253, 0x1, 0x9b },	/* KEY_MAIL */
+	[ 520] = {  3166, 0x1, 0xef },	/* KEY_UWB */
+	[ 521] = {  8668, 0x2, 0x1 },	/* REL_Y */
+	[ 522] = {  5381, 0x1, 0x1e3 },	/* KEY_FN_S */
+	[ 523] = {  5042, 0x1, 0x1b9 },	/* KEY_10CHANNELSDOWN */
+	[ 524] = {  3311, 0x1, 0x100 },	/* BTN_MISC */
+	[ 525] = {  1819, 0x1, 0x73 },	/* KEY_VOLUMEUP */
+	[ 526] = {  1513, 0x1, 0x58 },	/* KEY_F12 */
+	[ 527] = {  8844, 0x5, 0x1 },	/* SW_TABLET_MODE */
+	[ 528] = {  3576, 0x1, 0x12a },	/* BTN_BASE5 */
+	[ 529] = {  7153, 0x1, 0x294 },	/* KEY_MACRO5 */
+	[ 530] = {   330, 0x3, 0x32 },	/* ABS_MT_WIDTH_MAJOR */
+	[ 531] = {  7460, 0x1, 0x2b0 },	/* KEY_MACRO_RECORD_START */
+	[ 532] = {  3393, 0x1, 0x111 },	/* BTN_RIGHT */
+	[ 533] = {  7388, 0x1, 0x2a8 },	/* KEY_MACRO25 */
+	[ 534] = {  3932, 0x1, 0x14c },	/* BTN_STYLUS2 */
+	[ 535] = {  6667, 0x1, 0x271 },	/* KEY_STOP_RECORD */
+	[ 536] = {  5096, 0x1, 0x1bd },	/* KEY_PICKUP_PHONE */
+	[ 537] = {  1586, 0x1, 0x5e },	/* KEY_MUHENKAN */
+	[ 538] = {  4220, 0x1, 0x172 },	/* KEY_SUBTITLE */
+	[ 539] = {  3758, 0x1, 0x140 },	/* BTN_TOOL_PEN */
+	[ 540] = {  5283, 0x1, 0x1d9 },	/* KEY_FN_F8 */
+	[ 541] = {   801, 0x1, 0x3 },	/* KEY_2 */
+	[ 542] = {  7089, 0x1, 0x289 },	/* KEY_BRIGHTNESS_MENU */
+	[ 543] = {  7747, 0x1, 0x2c3 },	/* BTN_TRIGGER_HAPPY4 */
+	[ 544] = {  2818, 0x1, 0xd3 },	/* KEY_HP */
+	[ 545] = {  8740, 0x2, 0xa },	/* REL_RESERVED */
+	[ 546] = {  3058, 0x1, 0xe6 },	/* KEY_KBDILLUMUP */
+	[ 547] = {   534, 0, 0 },	/* EV_SYN */
+	[ 548] = {  1130, 0x1, 0x2c },	/* KEY_Z */
+	[ 549] = {  2651, 0x1, 0xbf },	/* KEY_F21 */
+	[ 550] = {  4914, 0x1, 0x1b0 },	/* KEY_SPELLCHECK */
+	[ 551] = {  7280, 0x1, 0x29f },	/* KEY_MACRO16 */
+	[ 552] = {  8001, 0x1, 0x2d0 },	/* BTN_TRIGGER_HAPPY17 */
+	[ 553] = {  2587, 0x1, 0xb7 },	/* KEY_F13 */
+	[ 554] = {  3117, 0x1, 0xeb },	/* KEY_DOCUMENTS */
+	[ 555] = {  7505, 0x1, 0x2b2 },	/* KEY_MACRO_PRESET_CYCLE */
+	[ 556] = {   609, 0, 0x17 },	/* EV_FF_STATUS */
+	[ 557] = {  2438, 0x1, 0xaa },	/* KEY_ISO */
+	[ 558] = {  7618, 0x1, 0x2ba },	/* KEY_KBD_LCD_MENU3 */
+	[ 559] = {  2509, 0x1, 0xb1 },	/* KEY_SCROLLUP */
+	[ 560] = {  4354, 0x1, 0x17f },	/* KEY_CD */
+	[ 561] = {  2570, 0x1, 0xb5 },	/* KEY_NEW */
+	[ 562] = {  3636, 0x1, 0x132 },	/* BTN_C */
+	[ 563] = {  2037, 0x1, 0x87 },	/* KEY_PASTE */
+	[ 564] = {  6316, 0x1, 0x24a },	/* KEY_DICTATE */
+	[ 565] = {  5633, 0x1, 0x206 },	/* KEY_NUMERIC_6 */
+	[ 566] = {  2111, 0x1, 0x8f },	/* KEY_WAKEUP */
+	[ 567] = {   267, 0x3, 0x2e },	/* ABS_RESERVED */
+	[ 568] = {  6347, 0x1, 0x260 },	/* KEY_KBDINPUTASSIST_PREV */
+	[ 569] = {    82, 0x3, 0xa },	/* ABS_BRAKE */
+	[ 570] = {  1528, 0x1, 0x5a },	/* KEY_KATAKANA */
+	[ 571] = {   787, 0x1, 0x1 },	/* KEY_ESC */
+	[ 572] = {  7076, 0x1, 0x288 },	/* KEY_NAV_INFO */
+	[ 573] = {  8770, 0x2, 0xc },	/* REL_HWHEEL_HI_RES */
+	[ 574] = {  3305, 0x1, 0x100 },	/* BTN_0 */
+	[ 575] = {  2808, 0x1, 0xd2 },	/* KEY_PRINT */
+	[ 576] = {  7019, 0x1, 0x285 },	/* KEY_TRADITIONAL_SONAR */
+	[ 577] = {  4312, 0x1, 0x17a },	/* KEY_TV2 */
+	[ 578] = {   971, 0x1, 0x1b },	/* KEY_RIGHTBRACE */
+	[ 579] = {  8893, 0x5, 0x4 },	/* SW_MICROPHONE_INSERT */
+	[ 580] = {  3332, 0x1, 0x103 },	/* BTN_3 */
+	[ 581] = {    13, 0x3, 0x2 },	/* ABS_Z */
+	[ 582] = {  7981, 0x1, 0x2cf },	/* BTN_TRIGGER_HAPPY16 */
+	[ 583] = {  6189, 0x1, 0x242 },	/* KEY_JOURNAL */
+	[ 584] = {   280, 0x3, 0x2f },	/* ABS_MT_SLOT */
+	[ 585] = {  8261, 0x1, 0x2dd },	/* BTN_TRIGGER_HAPPY30 */
+	[ 586] = {  3350, 0x1, 0x106 },	/* BTN_6 */
+	[ 587] = {  1077, 0x1, 0x28 },	/* KEY_APOSTROPHE */
+	[ 588] = {  8859, 0x5, 0x2 },	/* SW_HEADPHONE_INSERT */
+	[ 589] = {  2334, 0x1, 0xa2 },	/* KEY_EJECTCLOSECD */
+	[ 590] = {  6559, 0x1, 0x26a },	/* KEY_ROOT_MENU */
+	[ 591] = {  7881, 0x1, 0x2ca },	/* BTN_TRIGGER_HAPPY11 */
+	[ 592] = {  4602, 0x1, 0x198 },	/* KEY_RESTART */
+	[ 593] = {  3661, 0x1, 0x135 },	/* BTN_Z */
+	[ 594] = {  5902, 0x1, 0x217 },	/* KEY_CAMERA_UP */
+	[ 595] = {  3423, 0x1, 0x114 },	/* BTN_EXTRA */
+	[ 596] = {  5253, 0x1, 0x1d6 },	/* KEY_FN_F5 */
+	[ 597] = {   843, 0x1, 0xa },	/* KEY_9 */
+	[ 598] = {   122, 0x3, 0x13 },	/* ABS_HAT1Y */
+	[ 599] = {  5202, 0x1, 0x1d1 },	/* KEY_FN_ESC */
+	[ 600] = {  4586, 0x1, 0x196 },	/* KEY_AB */
+	[ 601] = {  7256, 0x1, 0x29d },	/* KEY_MACRO14 */
+	[ 602] = {  1092, 0x1, 0x29 },	/* KEY_GRAVE */
+	[ 603] = {  8321, 0x1, 0x2e0 },	/* BTN_TRIGGER_HAPPY33 */
+	[ 604] = {  3787, 0x1, 0x142 },	/* BTN_TOOL_BRUSH */
+	[ 605] = {  3708, 0x1, 0x13b },	/* BTN_START */
+	[ 606] = {  4551, 0x1, 0x193 },	/* KEY_CHANNELDOWN */
+	[ 607] = {  2859, 0x1, 0xd7 },	/* KEY_EMAIL */
+	[ 608] = {  4268, 0x1, 0x176 },	/* KEY_KEYBOARD */
+	[ 609] = {  1932, 0x1, 0x7d },	/* KEY_LEFTMETA */
+	[ 610] = {  8524, 0x11, 0x4 },	/* LED_KANA */
+	[ 611] = {   699, 0, 0x4 },	/* INPUT_PROP_TOPBUTTONPAD */
+	[ 612] = {  1182, 0x1, 0x34 },	/* KEY_DOT */
+	[ 613] = {  2975, 0x1, 0xe1 },	/* KEY_BRIGHTNESSUP */
+	[ 614] = {   162, 0x3, 0x17 },	/* ABS_HAT3Y */
+	[ 615] = {  4380, 0x1, 0x182 },	/* KEY_TUNER */
+	[ 616] = {  6649, 0x1, 0x270 },	/* KEY_NEXT_FAVORITE */
+	[ 617] = {  6782, 0x1, 0x279 },	/* KEY_PRIVACY_SCREEN_TOGGLE */
+	[ 618] = {    40, 0x3, 0x6 },	/* ABS_THROTTLE */
+	[ 619] = {  8701, 0x2, 0x6 },	/* REL_HWHEEL */
+	[ 620] = {  2289, 0x1, 0x9e },	/* KEY_BACK */
+	[ 621] = {   548, 0, 0x2 },	/* EV_REL */
+	[ 622] = {  5965, 0x1, 0x21b },	/* KEY_ATTENDANT_ON */
+	[ 623] = {  8061, 0x1, 0x2d3 },	/* BTN_TRIGGER_HAPPY20 */
+	[ 624] = {  8788, 0x14, 0 },	/* REP_DELAY */
+	[ 625] = {  1166, 0x1, 0x32 },	/* KEY_M */
+	[ 626] = {  8595, 0x4, 0 },	/* MSC_SERIAL */
+	[ 627] = {  7328, 0x1, 0x2a3 },	/* KEY_MACRO20 */
+	[ 628] = {  7131, 0x1, 0x292 },	/* KEY_MACRO3 */
+	[ 629] = {   209, 0x3, 0x1b },	/* ABS_TILT_Y */
+	[ 630] = {  7436, 0x1, 0x2ac },	/* KEY_MACRO29 */
+	[ 631] = {  8181, 0x1, 0x2d9 },	/* BTN_TRIGGER_HAPPY26 */
+	[ 632] = {  6156, 0x1, 0x240 },	/* KEY_BUTTONCONFIG */
+	[ 633] = {  7400, 0x1, 0x2a9 },	/* KEY_MACRO26 */
+	[ 634] = {  8141, 0x1, 0x2d7 },	/* BTN_TRIGGER_HAPPY24 */
+	[ 635] = {   235, 0x3, 0x20 },	/* ABS_VOLUME */
+	[ 636] = {  5195, 0x1, 0x1d0 },	/* KEY_FN */
+	[ 637] = {  8555, 0x11, 0x7 },	/* LED_MUTE */
+	[ 638] = {  2611, 0x1, 0xba },	/* KEY_F16 */
+	[ 639] = {  5470, 0x1, 0x1f5 },	/* KEY_BRL_DOT5 */
+	[ 640] = {  1348, 0x1, 0x46 },	/* KEY_SCROLLLOCK */
+	[ 641] = {  2537, 0x1, 0xb3 },	/* KEY_KPLEFTPAREN */
+	[ 642] = {  2627, 0x1, 0xbc },	/* KEY_F18 */
+	[ 643] = {  5496, 0x1, 0x1f7 },	/* KEY_BRL_DOT7 */
+	[ 644] = {  2635, 0x1, 0xbd },	/* KEY_F19 */
+	[ 645] = {  5509, 0x1, 0x1f8 },	/* KEY_BRL_DOT8 */
+	[ 646] = {   569, 0, 0x5 },	/* EV_SW */
+	[ 647] = {  5780, 0x1, 0x210 },	/* KEY_CAMERA_FOCUS */
+	[ 648] = {  4499, 0x1, 0x18e },	/* KEY_RED */
+	[ 649] = {  5706, 0x1, 0x20b },	/* KEY_NUMERIC_POUND */
+	[ 650] = {  3273, 0x1, 0xf6 },	/* KEY_WWAN */
+	[ 651] = {  3403, 0x1, 0x112 },	/* BTN_MIDDLE */
+	[ 652] = {    74, 0x3, 0x9 },	/* ABS_GAS */
+	[ 653] = {   387, 0x3, 0x35 },	/* ABS_MT_POSITION_X */
+	[ 654] = {  1476, 0x1, 0x55 },	/* KEY_ZENKAKUHANKAKU */
+	[ 655] = {  7600, 0x1, 0x2b9 },	/* KEY_KBD_LCD_MENU2 */
+	[ 656] = {  5390, 0x1, 0x1e4 },	/* KEY_FN_B */
+	[ 657] = {  5549, 0x1, 0x200 },	/* KEY_NUMERIC_0 */
+	[ 658] = {  3899, 0x1, 0x149 },	/* BTN_STYLUS3 */
+	[ 659] = {  3022, 0x1, 0xe4 },	/* KEY_KBDILLUMTOGGLE */
+	[ 660] = {  1252, 0x1, 0x3a },	/* KEY_CAPSLOCK */
+	[ 661] = {  3867, 0x1, 0x147 },	/* BTN_TOOL_LENS */
+	[ 662] = {  4328, 0x1, 0x17c },	/* KEY_VCR2 */
+	[ 663] = {  4243, 0x1, 0x174 },	/* KEY_FULL_SCREEN */
+	[ 664] = {   915, 0x1, 0x13 },	/* KEY_R */
+	[ 665] = {  2236, 0x1, 0x9a },	/* KEY_CYCLEWINDOWS */
+	[ 666] = {  3488, 0x1, 0x121 },	/* BTN_THUMB */
+	[ 667] = {  1190, 0x1, 0x35 },	/* KEY_SLASH */
+	[ 668] = {   889, 0x1, 0xf },	/* KEY_TAB */
+	[ 669] = {  8564, 0x11, 0x8 },	/* LED_MISC */
+	[ 670] = {  1116, 0x1, 0x2b },	/* KEY_BACKSLASH */
+	[ 671] = {  2932, 0x1, 0xde },	/* KEY_ALTERASE */
+	[ 672] = {   575, 0, 0x11 },	/* EV_LED */
+	[ 673] = {  1661, 0x1, 0x64 },	/* KEY_RIGHTALT */
+	[ 674] = {  1959, 0x1, 0x7f },	/* KEY_COMPOSE */
+	[ 675] = {  5182, 0x1, 0x1c3 },	/* KEY_DEL_LINE */
+	[ 676] = {  1902, 0x1, 0x7a },	/* KEY_HANGEUL */
+	[ 677] = {  9071, 0x5, 0xe },	/* SW_MUTE_DEVICE */
+	[ 678] = {  5766, 0x1, 0x20f },	/* KEY_NUMERIC_D */
+	[ 679] = {  1880, 0x1, 0x78 },	/* KEY_SCALE */
+	[ 680] = {  2122, 0x1, 0x90 },	/* KEY_FILE */
+	[ 681] = {  4866, 0x1, 0x1ad },	/* KEY_ADDRESSBOOK */
+	[ 682] = {  2378, 0x1, 0xa5 },	/* KEY_PREVIOUSSONG */
+	[ 683] = {  5336, 0x1, 0x1de },	/* KEY_FN_1 */
+	[ 684] = {  8041, 0x1, 0x2d2 },	/* BTN_TRIGGER_HAPPY19 */
+	[ 685] = {  4454, 0x1, 0x18a },	/* KEY_DIRECTORY */
+	[ 686] = {  2694, 0x1, 0xc9 },	/* KEY_PAUSECD */
+	[ 687] = {  2217, 0x1, 0x99 },	/* KEY_ROTATE_DISPLAY */
+	[ 688] = {  5724, 0x1, 0x20c },	/* KEY_NUMERIC_A */
+	[ 689] = {  4053, 0x1, 0x162 },	/* KEY_GOTO */
+	[ 690] = {  7208, 0x1, 0x299 },	/* KEY_MACRO10 */
+	[ 691] = {  1387, 0x1, 0x4a },	/* KEY_KPMINUS */
+	[ 692] = {  1009, 0x1, 0x1e },	/* KEY_A */
+	[ 693] = {  2923, 0x1, 0xdd },	/* KEY_SHOP */
+	[ 694] = {   602, 0, 0x16 },	/* EV_PWR */
+	[ 695] = {  8301, 0x1, 0x2df },	/* BTN_TRIGGER_HAPPY32 */
+	[ 696] = {  4486, 0x1, 0x18d },	/* KEY_CALENDAR */
+	[ 697] = {  5145, 0x1, 0x1c0 },	/* KEY_DEL_EOL */
+	[ 699] = {  1160, 0x1, 0x31 },	/* KEY_N */
+	[ 700] = {  5483, 0x1, 0x1f6 },	/* KEY_BRL_DOT6 */
+	[ 701] = {  3237, 0x1, 0xf4 },	/* KEY_BRIGHTNESS_AUTO */
+	[ 702] = {  1674, 0x1, 0x65 },	/* KEY_LINEFEED */
+	[ 703] = {  6248, 0x1, 0x246 },	/* KEY_VOICECOMMAND */
+	[ 704] = {  5113, 0x1, 0x1be },	/* KEY_HANGUP_PHONE */
+	[ 705] = {  1033, 0x1, 0x22 },	/* KEY_G */
+	[ 706] = {  3697, 0x1, 0x13a },	/* BTN_SELECT */
+	[ 707] = {  5314, 0x1, 0x1dc },	/* KEY_FN_F11 */
+	[ 708] = {  1599, 0x1, 0x5f },	/* KEY_KPJPCOMMA */
+	[ 709] = {  9020, 0x5, 0xb },	/* SW_FRONT_PROXIMITY */
+	[ 710] = {  8421, 0x1, 0x2e5 },	/* BTN_TRIGGER_HAPPY38 */
+	[ 711] = {  4094, 0x1, 0x166 },	/* KEY_INFO */
+	[ 712] = {  4305, 0x1, 0x179 },	/* KEY_TV */
+	[ 713] = {   349, 0x3, 0x33 },	/* ABS_MT_WIDTH_MINOR */
+	[ 714] = {  8922, 0x5, 0x6 },	/* SW_LINEOUT_INSERT */
+	[ 715] = {  4135, 0x1, 0x16a },	/* KEY_PROGRAM */
+	[ 716] = {  2603, 0x1, 0xb9 },	/* KEY_F15 */
+	[ 717] = {   749, 0, 0x6 },	/* INPUT_PROP_ACCELEROMETER */
+	[ 718] = {  1733, 0x1, 0x6b },	/* KEY_END */
+	[ 719] = {  2091, 0x1, 0x8d },	/* KEY_SETUP */
+	[ 720] = {     7, 0x3, 0x1 },	/* ABS_Y */
+	[ 721] = {  9155, 0, 0x3 },	/* SYN_DROPPED */
+	[ 722] = {  3749, 0x1, 0x140 },	/* BTN_DIGI */
+	[ 723] = {  2878, 0x1, 0xd9 },	/* KEY_SEARCH */
+	[ 724] = {  8533, 0x11, 0x5 },	/* LED_SLEEP */
+	[ 725] = {  8809, 0x12, 0 },	/* SND_CLICK */
+	[ 726] = {  3566, 0x1, 0x129 },	/* BTN_BASE4 */
+	[ 727] = {  5563, 0x1, 0x201 },	/* KEY_NUMERIC_1 */
+	[ 728] = {   405, 0x3, 0x36 },	/* ABS_MT_POSITION_Y */
+	[ 729] = {  4702, 0x1, 0x1a1 },	/* KEY_GAMES */
+	[ 730] = {  4940, 0x1, 0x1b2 },	/* KEY_DOLLAR */
+	[ 731] = {  5865, 0x1, 0x215 },	/* KEY_CAMERA_ZOOMIN */
+	[ 732] = {  7142, 0x1, 0x293 },	/* KEY_MACRO4 */
+	[ 733] = {  1495, 0x1, 0x56 },	/* KEY_102ND */
+	[ 734] = {  2364, 0x1, 0xa4 },	/* KEY_PLAYPAUSE */
+	[ 735] = {  6939, 0x1, 0x281 },	/* KEY_FISHING_CHART */
+	[ 736] = {  8631, 0x4, 0x3 },	/* MSC_RAW */
+	[ 737] = {  4083, 0x1, 0x165 },	/* KEY_OPTION */
+	[ 738] = {  5932, 0x1, 0x219 },	/* KEY_CAMERA_LEFT */
+};
+
+static const unsigned short code_names[] = {
+	[    0] =     1,	/* ABS_X */
+	[    1] =     7,	/* ABS_Y */
+	[    2] =    13,	/* ABS_Z */
+	[    3] =    19,	/* ABS_RX */
+	[    4] =    26,	/* ABS_RY */
+	[    5] =    33,	/* ABS_RZ */
+	[    6] =    40,	/* ABS_THROTTLE */
+	[    7] =    53,	/* ABS_RUDDER */
+	[    8] =    64,	/* ABS_WHEEL */
+	[    9] =    74,	/* ABS_GAS */
+	[   10] =    82,	/* ABS_BRAKE */
+	[   16] =    92,	/* ABS_HAT0X */
+	[   17] =   102,	/* ABS_HAT0Y */
+	[   18] =   112,	/* ABS_HAT1X */
+	[   19] =   122,	/* ABS_HAT1Y */
+	[   20] =   132,	/* ABS_HAT2X */
+	[   21] =   142,	/* ABS_HAT2Y */
+	[   22] =   152,	/* ABS_HAT3X */
+	[   23] =   162,	/* ABS_HAT3Y */
+	[   24] =   172,	/* ABS_PRESSURE */
+	[   25] =   185,	/* ABS_DISTANCE */
+	[   26] =   198,	/* ABS_TILT_X */
+	[   27] =   209,	/* ABS_TILT_Y */
+	[   28] =   220,	/* ABS_TOOL_WIDTH */
+	[   32] =   235,	/* ABS_VOLUME */
+	[   33] =   246,	/* ABS_PROFILE */
+	[   40] =   258,	/* ABS_MISC */
+	[   46] =   267,	/* ABS_RESERVED */
+	[   47] =   280,	/* ABS_MT_SLOT */
+	[   48] =   292,	/* ABS_MT_TOUCH_MAJOR */
+	[   49] =   311,	/* ABS_MT_TOUCH_MINOR */
+	[   50] =   330,	/* ABS_MT_WIDTH_MAJOR */
+	[   51] =   349,	/* ABS_MT_WIDTH_MINOR */
+	[   52] =   368,	/* ABS_MT_ORIENTATION */
+	[   53] =   387,	/* ABS_MT_POSITION_X */
+	[   54] =   405,	/* ABS_MT_POSITION_Y */
+	[   55] =   423,	/* ABS_MT_TOOL_TYPE */
+	[   56] =   440,	/* ABS_MT_BLOB_ID */
+	[   57] =   455,	/* ABS_MT_TRACKING_ID */
+	[   58] =   474,	/* ABS_MT_PRESSURE */
+	[   59] =   490,	/* ABS_MT_DISTANCE */
+	[   60] =   506,	/* ABS_MT_TOOL_X */
+	[   61] =   520,	/* ABS_MT_TOOL_Y */
+	[   62] =   774,	/* KEY_RESERVED */
+	[   63] =   787,	/* KEY_ESC */
+	[   64] =   795,	/* KEY_1 */
+	[   65] =   801,	/* KEY_2 */
+	[   66] =   807,	/* KEY_3 */
+	[   67] =   813,	/* KEY_4 */
+	[   68] =   819,	/* KEY_5 */
+	[   69] =   825,	/* KEY_6 */
+	[   70] =   831,	/* KEY_7 */
+	[   71] =   837,	/* KEY_8 */
+	[   72] =   843,	/* KEY_9 */
+	[   73] =   849,	/* KEY_0 */
+	[   74] =   855,	/* KEY_MINUS */
+	[   75] =   865,	/* KEY_EQUAL */
+	[   76] =   875,	/* KEY_BACKSPACE */
+	[   77] =   889,	/* KEY_TAB */
+	[   78] =   897,	/* KEY_Q */
+	[   79] =   903,	/* KEY_W */
+	[   80] =   909,	/* KEY_E */
+	[   81] =   915,	/* KEY_R */
+	[   82] =   921,	/* KEY_T */
+	[   83] =   927,	/* KEY_Y */
+	[   84] =   933,	/* KEY_U */
+	[   85] =   939,	/* KEY_I */
+	[   86] =   945,	/* KEY_O */
+	[   87] =   951,	/* KEY_P */
+	[   88] =   957,	/* KEY_LEFTBRACE */
+	[   89] =   971,	/* KEY_RIGHTBRACE */
+	[   90] =   986,	/* KEY_ENTER */
+	[   91] =   996,	/* KEY_LEFTCTRL */
+	[   92] =  1009,	/* KEY_A */
+	[   93] =  1015,	/* KEY_S */
+	[   94] =  1021,	/* KEY_D */
+	[   95] =  1027,	/* KEY_F */
+	[   96] =  1033,	/* KEY_G */
+	[   97] =  1039,	/* KEY_H */
+	[   98] =  1045,	/* KEY_J */
+	[   99] =  1051,	/* KEY_K */
+	[  100] =  1057,	/* KEY_L */
+	[  101] =  1063,	/* KEY_SEMICOLON */
+	[  102] =  1077,	/* KEY_APOSTROPHE */
+	[  103] =  1092,	/* KEY_GRAVE */
+	[  104] =  1102,	/* KEY_LEFTSHIFT */
+	[  105] =  1116,	/* KEY_BACKSLASH */
+	[  106] =  1130,	/* KEY_Z */
+	[  107] =  1136,	/* KEY_X */
+	[  108] =  1142,	/* KEY_C */
+	[  109] =  1148,	/* KEY_V */
+	[  110] =  1154,	/* KEY_B */
+	[  111] =  1160,	/* KEY_N */
+	[  112] =  1166,	/* KEY_M */
+	[  113] =  1172,	/* KEY_COMMA */
+	[  114] =  1182,	/* KEY_DOT */
+	[  115] =  1190,	/* KEY_SLASH */
+	[  116] =  1200,	/* KEY_RIGHTSHIFT */
+	[  117] =  1215,	/* KEY_KPASTERISK */
+	[  118] =  1230,	/* KEY_LEFTALT */
+	[  119] =  1242,	/* KEY_SPACE */
+	[  120] =  1252,	/* KEY_CAPSLOCK */
+	[  121] =  1265,	/* KEY_F1 */
+	[  122] =  1272,	/* KEY_F2 */
+	[  123] =  1279,	/* KEY_F3 */
+	[  124] =  1286,	/* KEY_F4 */
+	[  125] =  1293,	/* KEY_F5 */
+	[  126] =  1300,	/* KEY_F6 */
+	[  127] =  1307,	/* KEY_F7 */
+	[  128] =  1314,	/* KEY_F8 */
+	[  129] =  1321,	/* KEY_F9 */
+	[  130] =  1328,	/* KEY_F10 */
+	[  131] =  1336,	/* KEY_NUMLOCK */
+	[  132] =  1348,	/* KEY_SCROLLLOCK */
+	[  133] =  1363,	/* KEY_KP7 */
+	[  134] =  1371,	/* KEY_KP8 */
+	[  135] =  1379,	/* KEY_KP9 */
+	[  136] =  1387,	/* KEY_KPMINUS */
+	[  137] =  1399,	/* KEY_KP4 */
+	[  138] =  1407,	/* KEY_KP5 */
+	[  139] =  1415,	/* KEY_KP6 */
+	[  140] =  1423,	/* KEY_KPPLUS */
+	[  141] =  1434,	/* KEY_KP1 */
+	[  142] =  1442,	/* KEY_KP2 */
+	[  143] =  1450,	/* KEY_KP3 */
+	[  144] =  1458,	/* KEY_KP0 */
+	[  145] =  1466,	/* KEY_KPDOT */
+	[  147] =  1476,	/* KEY_ZENKAKUHANKAKU */
+	[  148] =  1495,	/* KEY_102ND */
+	[  149] =  1505,	/* KEY_F11 */
+	[  150] =  1513,	/* KEY_F12 */
+	[  151] =  1521,	/* KEY_RO */
+	[  152] =  1528,	/* KEY_KATAKANA */
+	[  153] =  1541,	/* KEY_HIRAGANA */
+	[  154] =  1554,	/* KEY_HENKAN */
+	[  155] =  1565,	/* KEY_KATAKANAHIRAGANA */
+	[  156] =  1586,	/* KEY_MUHENKAN */
+	[  157] =  1599,	/* KEY_KPJPCOMMA */
+	[  158] =  1613,	/* KEY_KPENTER */
+	[  159] =  1625,	/* KEY_RIGHTCTRL */
+	[  160] =  1639,	/* KEY_KPSLASH */
+	[  161] =  1651,	/* KEY_SYSRQ */
+	[  162] =  1661,	/* KEY_RIGHTALT */
+	[  163] =  1674,	/* KEY_LINEFEED */
+	[  164] =  1687,	/* KEY_HOME */
+	[  165] =  1696,	/* KEY_UP */
+	[  166] =  1703,	/* KEY_PAGEUP */
+	[  167] =  1714,	/* KEY_LEFT */
+	[  168] =  1723,	/* KEY_RIGHT */
+	[  169] =  1733,	/* KEY_END */
+	[  170] =  1741,	/* KEY_DOWN */
+	[  171] =  1750,	/* KEY_PAGEDOWN */
+	[  172] =  1763,	/* KEY_INSERT */
+	[  173] =  1774,	/* KEY_DELETE */
+	[  174] =  1785,	/* KEY_MACRO */
+	[  175] =  1795,	/* KEY_MUTE */
+	[  176] =  1804,	/* KEY_VOLUMEDOWN */
+	[  177] =  1819,	/* KEY_VOLUMEUP */
+	[  178] =  1832,	/* KEY_POWER */
+	[  179] =  1842,	/* KEY_KPEQUAL */
+	[  180] =  1854,	/* KEY_KPPLUSMINUS */
+	[  181] =  1870,	/* KEY_PAUSE */
+	[  182] =  1880,	/* KEY_SCALE */
+	[  183] =  1890,	/* KEY_KPCOMMA */
+	[  184] =  1902,	/* KEY_HANGEUL */
+	[  185] =  1914,	/* KEY_HANJA */
+	[  186] =  1924,	/* KEY_YEN */
+	[  187] =  1932,	/* KEY_LEFTMETA */
+	[  188] =  1945,	/* KEY_RIGHTMETA */
+	[  189] =  1959,	/* KEY_COMPOSE */
+	[  190] =  1971,	/* KEY_STOP */
+	[  191] =  1980,	/* KEY_AGAIN */
+	[  192] =  1990,	/* KEY_PROPS */
+	[  193] =  2000,	/* KEY_UNDO */
+	[  194] =  2009,	/* KEY_FRONT */
+	[  195] =  2019,	/* KEY_COPY */
+	[  196] =  2028,	/* KEY_OPEN */
+	[  197] =  2037,	/* KEY_PASTE */
+	[  198] =  2047,	/* KEY_FIND */
+	[  199] =  2056,	/* KEY_CUT */
+	[  200] =  2064,	/* KEY_HELP */
+	[  201] =  2073,	/* KEY_MENU */
+	[  202] =  2082,	/* KEY_CALC */
+	[  203] =  2091,	/* KEY_SETUP */
+	[  204] =  2101,	/* KEY_SLEEP */
+	[  205] =  2111,	/* KEY_WAKEUP */
+	[  206] =  2122,	/* KEY_FILE */
+	[  207] =  2131,	/* KEY_SENDFILE */
+	[  208] =  2144,	/* KEY_DELETEFILE */
+	[  209] =  2159,	/* KEY_XFER */
+	[  210] =  2168,	/* KEY_PROG1 */
+	[  211] =  2178,	/* KEY_PROG2 */
+	[  212] =  2188,	/* KEY_WWW */
+	[  213] =  2196,	/* KEY_MSDOS */
+	[  214] =  2206,	/* KEY_COFFEE */
+	[  215] =  2217,	/* KEY_ROTATE_DISPLAY */
+	[  216] =  2236,	/* KEY_CYCLEWINDOWS */
+	[  217] =  2253,	/* KEY_MAIL */
+	[  218] =  2262,	/* KEY_BOOKMARKS */
+	[  219] =  2276,	/* KEY_COMPUTER */
+	[  220] =  2289,	/* KEY_BACK */
+	[  221] =  2298,	/* KEY_FORWARD */
+	[  222] =  2310,	/* KEY_CLOSECD */
+	[  223] =  2322,	/* KEY_EJECTCD */
+	[  224] =  2334,	/* KEY_EJECTCLOSECD */
+	[  225] =  2351,	/* KEY_NEXTSONG */
+	[  226] =  2364,	/* KEY_PLAYPAUSE */
+	[  227] =  2378,	/* KEY_PREVIOUSSONG */
+	[  228] =  2395,	/* KEY_STOPCD */
+	[  229] =  2406,	/* KEY_RECORD */
+	[  230] =  2417,	/* KEY_REWIND */
+	[  231] =  2428,	/* KEY_PHONE */
+	[  232] =  2438,	/* KEY_ISO */
+	[  233] =  2446,	/* KEY_CONFIG */
+	[  234] =  2457,	/* KEY_HOMEPAGE */
+	[  235] =  2470,	/* KEY_REFRESH */
+	[  236] =  2482,	/* KEY_EXIT */
+	[  237] =  2491,	/* KEY_MOVE */
+	[  238] =  2500,	/* KEY_EDIT */
+	[  239] =  2509,	/* KEY_SCROLLUP */
+	[  240] =  2522,	/* KEY_SCROLLDOWN */
+	[  241] =  2537,	/* KEY_KPLEFTPAREN */
+	[  242] =  2553,	/* KEY_KPRIGHTPAREN */
+	[  243] =  2570,	/* KEY_NEW */
+	[  244] =  2578,	/* KEY_REDO */
+	[  245] =  2587,	/* KEY_F13 */
+	[  246] =  2595,	/* KEY_F14 */
+	[  247] =  2603,	/* KEY_F15 */
+	[  248] =  2611,	/* KEY_F16 */
+	[  249] =  2619,	/* KEY_F17 */
+	[  250] =  2627,	/* KEY_F18 */
+	[  251] =  2635,	/* KEY_F19 */
+	[  252] =  2643,	/* KEY_F20 */
+	[  253] =  2651,	/* KEY_F21 */
+	[  254] =  2659,	/* KEY_F22 */
+	[  255] =  2667,	/* KEY_F23 */
+	[  256] =  2675,	/* KEY_F24 */
+	[  262] =  2683,	/* KEY_PLAYCD */
+	[  263] =  2694,	/* KEY_PAUSECD */
+	[  264] =  2706,	/* KEY_PROG3 */
+	[  265] =  2716,	/* KEY_PROG4 */
+	[  266] =  2726,	/* KEY_ALL_APPLICATIONS */
+	[  267] =  2747,	/* KEY_SUSPEND */
+	[  268] =  2759,	/* KEY_CLOSE */
+	[  269] =  2769,	/* KEY_PLAY */
+	[  270] =  2778,	/* KEY_FASTFORWARD */
+	[  271] =  2794,	/* KEY_BASSBOOST */
+	[  272] =  2808,	/* KEY_PRINT */
+	[  273] =  2818,	/* KEY_HP */
+	[  274] =  2825,	/* KEY_CAMERA */
+	[  275] =  2836,	/* KEY_SOUND */
+	[  276] =  2846,	/* KEY_QUESTION */
+	[  277] =  2859,	/* KEY_EMAIL */
+	[  278] =  2869,	/* KEY_CHAT */
+	[  279] =  2878,	/* KEY_SEARCH */
+	[  280] =  2889,	/* KEY_CONNECT */
+	[  281] =  2901,	/* KEY_FINANCE */
+	[  282] =  2913,	/* KEY_SPORT */
+	[  283] =  2923,	/* KEY_SHOP */
+	[  284] =  2932,	/* KEY_ALTERASE */
+	[  285] =  2945,	/* KEY_CANCEL */
+	[  286] =  2956,	/* KEY_BRIGHTNESSDOWN */
+	[  287] =  2975,	/* KEY_BRIGHTNESSUP */
+	[  288] =  2992,	/* KEY_MEDIA */
+	[  289] =  3002,	/* KEY_SWITCHVIDEOMODE */
+	[  290] =  3022,	/* KEY_KBDILLUMTOGGLE */
+	[  291] =  3041,	/* KEY_KBDILLUMDOWN */
+	[  292] =  3058,	/* KEY_KBDILLUMUP */
+	[  293] =  3073,	/* KEY_SEND */
+	[  294] =  3082,	/* KEY_REPLY */
+	[  295] =  3092,	/* KEY_FORWARDMAIL */
+	[  296] =  3108,	/* KEY_SAVE */
+	[  297] =  3117,	/* KEY_DOCUMENTS */
+	[  298] =  3131,	/* KEY_BATTERY */
+	[  299] =  3143,	/* KEY_BLUETOOTH */
+	[  300] =  3157,	/* KEY_WLAN */
+	[  301] =  3166,	/* KEY_UWB */
+	[  302] =  3174,	/* KEY_UNKNOWN */
+	[  303] =  3186,	/* KEY_VIDEO_NEXT */
+	[  304] =  3201,	/* KEY_VIDEO_PREV */
+	[  305] =  3216,	/* KEY_BRIGHTNESS_CYCLE */
+	[  306] =  3237,	/* KEY_BRIGHTNESS_AUTO */
+	[  307] =  3257,	/* KEY_DISPLAY_OFF */
+	[  308] =  3273,	/* KEY_WWAN */
+	[  309] =  3282,	/* KEY_RFKILL */
+	[  310] =  3293,	/* KEY_MICMUTE */
+	[  318] =  3311,	/* BTN_MISC */
+	[  319] =  3320,	/* BTN_1 */
+	[  320] =  3326,	/* BTN_2 */
+	[  321] =  3332,	/* BTN_3 */
+	[  322] =  3338,	/* BTN_4 */
+	[  323] =  3344,	/* BTN_5 */
+	[  324] =  3350,	/* BTN_6 */
+	[  325] =  3356,	/* BTN_7 */
+	[  326] =  3362,	/* BTN_8 */
+	[  327] =  3368,	/* BTN_9 */
+	[  334] =  3383,	/* BTN_MOUSE */
+	[  335] =  3393,	/* BTN_RIGHT */
+	[  336] =  3403,	/* BTN_MIDDLE */
+	[  337] =  3414,	/* BTN_SIDE */
+	[  338] =  3423,	/* BTN_EXTRA */
+	[  339] =  3433,	/* BTN_FORWARD */
+	[  340] =  3445,	/* BTN_BACK */
+	[  341] =  3454,	/* BTN_TASK */
+	[  350] =  3476,	/* BTN_TRIGGER */
+	[  351] =  3488,	/* BTN_THUMB */
+	[  352] =  3498,	/* BTN_THUMB2 */
+	[  353] =  3509,	/* BTN_TOP */
+	[  354] =  3517,	/* BTN_TOP2 */
+	[  355] =  3526,	/* BTN_PINKIE */
+	[  356] =  3537,	/* BTN_BASE */
+	[  357] =  3546,	/* BTN_BASE2 */
+	[  358] =  3556,	/* BTN_BASE3 */
+	[  359] =  3566,	/* BTN_BASE4 */
+	[  360] =  3576,	/* BTN_BASE5 */
+	[  361] =  3586,	/* BTN_BASE6 */
+	[  365] =  3596,	/* BTN_DEAD */
+	[  366] =  3617,	/* BTN_SOUTH */
+	[  367] =  3627,	/* BTN_EAST */
+	[  368] =  3636,	/* BTN_C */
+	[  369] =  3642,	/* BTN_NORTH */
+	[  370] =  3652,	/* BTN_WEST */
+	[  371] =  3661,	/* BTN_Z */
+	[  372] =  3667,	/* BTN_TL */
+	[  373] =  3674,	/* BTN_TR */
+	[  374] =  3681,	/* BTN_TL2 */
+	[  375] =  3689,	/* BTN_TR2 */
+	[  376] =  3697,	/* BTN_SELECT */
+	[  377] =  3708,	/* BTN_START */
+	[  378] =  3718,	/* BTN_MODE */
+	[  379] =  3727,	/* BTN_THUMBL */
+	[  380] =  3738,	/* BTN_THUMBR */
+	[  382] =  3758,	/* BTN_TOOL_PEN */
+	[  383] =  3771,	/* BTN_TOOL_RUBBER */
+	[  384] =  3787,	/* BTN_TOOL_BRUSH */
+	[  385] =  3802,	/* BTN_TOOL_PENCIL */
+	[  386] =  3818,	/* BTN_TOOL_AIRBRUSH */
+	[  387] =  3836,	/* BTN_TOOL_FINGER */
+	[  388] =  3852,	/* BTN_TOOL_MOUSE */
+	[  389] =  3867,	/* BTN_TOOL_LENS */
+	[  390] =  3881,	/* BTN_TOOL_QUINTTAP */
+	[  391] =  3899,	/* BTN_STYLUS3 */
+	[  392] =  3911,	/* BTN_TOUCH */
+	[  393] =  3921,	/* BTN_STYLUS */
+	[  394] =  3932,	/* BTN_STYLUS2 */
+	[  395] =  3944,	/* BTN_TOOL_DOUBLETAP */
+	[  396] =  3963,	/* BTN_TOOL_TRIPLETAP */
+	[  397] =  3982,	/* BTN_TOOL_QUADTAP */
+	[  398] =  4013,	/* BTN_WHEEL */
+	[  399] =  4023,	/* BTN_GEAR_UP */
+	[  414] =  4035,	/* KEY_OK */
+	[  415] =  4042,	/* KEY_SELECT */
+	[  416] =  4053,	/* KEY_GOTO */
+	[  417] =  4062,	/* KEY_CLEAR */
+	[  418] =  4072,	/* KEY_POWER2 */
+	[  419] =  4083,	/* KEY_OPTION */
+	[  420] =  4094,	/* KEY_INFO */
+	[  421] =  4103,	/* KEY_TIME */
+	[  422] =  4112,	/* KEY_VENDOR */
+	[  423] =  4123,	/* KEY_ARCHIVE */
+	[  424] =  4135,	/* KEY_PROGRAM */
+	[  425] =  4147,	/* KEY_CHANNEL */
+	[  426] =  4159,	/* KEY_FAVORITES */
+	[  427] =  4173,	/* KEY_EPG */
+	[  428] =  4181,	/* KEY_PVR */
+	[  429] =  4189,	/* KEY_MHP */
+	[  430] =  4197,	/* KEY_LANGUAGE */
+	[  431] =  4210,	/* KEY_TITLE */
+	[  432] =  4220,	/* KEY_SUBTITLE */
+	[  433] =  4233,	/* KEY_ANGLE */
+	[  434] =  4243,	/* KEY_FULL_SCREEN */
+	[  435] =  4259,	/* KEY_MODE */
+	[  436] =  4268,	/* KEY_KEYBOARD */
+	[  437] =  4281,	/* KEY_ASPECT_RATIO */
+	[  438] =  4298,	/* KEY_PC */
+	[  439] =  4305,	/* KEY_TV */
+	[  440] =  4312,	/* KEY_TV2 */
+	[  441] =  4320,	/* KEY_VCR */
+	[  442] =  4328,	/* KEY_VCR2 */
+	[  443] =  4337,	/* KEY_SAT */
+	[  444] =  4345,	/* KEY_SAT2 */
+	[  445] =  4354,	/* KEY_CD */
+	[  446] =  4361,	/* KEY_TAPE */
+	[  447] =  4370,	/* KEY_RADIO */
+	[  448] =  4380,	/* KEY_TUNER */
+	[  449] =  4390,	/* KEY_PLAYER */
+	[  450] =  4401,	/* KEY_TEXT */
+	[  451] =  4410,	/* KEY_DVD */
+	[  452] =  4418,	/* KEY_AUX */
+	[  453] =  4426,	/* KEY_MP3 */
+	[  454] =  4434,	/* KEY_AUDIO */
+	[  455] =  4444,	/* KEY_VIDEO */
+	[  456] =  4454,	/* KEY_DIRECTORY */
+	[  457] =  4468,	/* KEY_LIST */
+	[  458] =  4477,	/* KEY_MEMO */
+	[  459] =  4486,	/* KEY_CALENDAR */
+	[  460] =  4499,	/* KEY_RED */
+	[  461] =  4507,	/* KEY_GREEN */
+	[  462] =  4517,	/* KEY_YELLOW */
+	[  463] =  4528,	/* KEY_BLUE */
+	[  464] =  4537,	/* KEY_CHANNELUP */
+	[  465] =  4551,	/* KEY_CHANNELDOWN */
+	[  466] =  4567,	/* KEY_FIRST */
+	[  467] =  4577,	/* KEY_LAST */
+	[  468] =  4586,	/* KEY_AB */
+	[  469] =  4593,	/* KEY_NEXT */
+	[  470] =  4602,	/* KEY_RESTART */
+	[  471] =  4614,	/* KEY_SLOW */
+	[  472] =  4623,	/* KEY_SHUFFLE */
+	[  473] =  4635,	/* KEY_BREAK */
+	[  474] =  4645,	/* KEY_PREVIOUS */
+	[  475] =  4658,	/* KEY_DIGITS */
+	[  476] =  4669,	/* KEY_TEEN */
+	[  477] =  4678,	/* KEY_TWEN */
+	[  478] =  4687,	/* KEY_VIDEOPHONE */
+	[  479] =  4702,	/* KEY_GAMES */
+	[  480] =  4712,	/* KEY_ZOOMIN */
+	[  481] =  4723,	/* KEY_ZOOMOUT */
+	[  482] =  4735,	/* KEY_ZOOMRESET */
+	[  483] =  4749,	/* KEY_WORDPROCESSOR */
+	[  484] =  4767,	/* KEY_EDITOR */
+	[  485] =  4778,	/* KEY_SPREADSHEET */
+	[  486] =  4794,	/* KEY_GRAPHICSEDITOR */
+	[  487] =  4813,	/* KEY_PRESENTATION */
+	[  488] =  4830,	/* KEY_DATABASE */
+	[  489] =  4843,	/* KEY_NEWS */
+	[  490] =  4852,	/* KEY_VOICEMAIL */
+	[  491] =  4866,	/* KEY_ADDRESSBOOK */
+	[  492] =  4882,	/* KEY_MESSENGER */
+	[  493] =  4896,	/* KEY_DISPLAYTOGGLE */
+	[  494] =  4914,	/* KEY_SPELLCHECK */
+	[  495] =  4929,	/* KEY_LOGOFF */
+	[  496] =  4940,	/* KEY_DOLLAR */
+	[  497] =  4951,	/* KEY_EURO */
+	[  498] =  4960,	/* KEY_FRAMEBACK */
+	[  499] =  4974,	/* KEY_FRAMEFORWARD */
+	[  500] =  4991,	/* KEY_CONTEXT_MENU */
+	[  501] =  5008,	/* KEY_MEDIA_REPEAT */
+	[  502] =  5025,	/* KEY_10CHANNELSUP */
+	[  503] =  5042,	/* KEY_10CHANNELSDOWN */
+	[  504] =  5061,	/* KEY_IMAGES */
+	[  506] =  5072,	/* KEY_NOTIFICATION_CENTER */
+	[  507] =  5096,	/* KEY_PICKUP_PHONE */
+	[  508] =  5113,	/* KEY_HANGUP_PHONE */
+	[  509] =  5130,	/* KEY_LINK_PHONE */
+	[  510] =  5145,	/* KEY_DEL_EOL */
+	[  511] =  5157,	/* KEY_DEL_EOS */
+	[  512] =  5169,	/* KEY_INS_LINE */
+	[  513] =  5182,	/* KEY_DEL_LINE */
+	[  526] =  5195,	/* KEY_FN */
+	[  527] =  5202,	/* KEY_FN_ESC */
+	[  528] =  5213,	/* KEY_FN_F1 */
+	[  529] =  5223,	/* KEY_FN_F2 */
+	[  530] =  5233,	/* KEY_FN_F3 */
+	[  531] =  5243,	/* KEY_FN_F4 */
+	[  532] =  5253,	/* KEY_FN_F5 */
+	[  533] =  5263,	/* KEY_FN_F6 */
+	[  534] =  5273,	/* KEY_FN_F7 */
+	[  535] =  5283,	/* KEY_FN_F8 */
+	[  536] =  5293,	/* KEY_FN_F9 */
+	[  537] =  5303,	/* KEY_FN_F10 */
+	[  538] =  5314,	/* KEY_FN_F11 */
+	[  539] =  5325,	/* KEY_FN_F12 */
+	[  540] =  5336,	/* KEY_FN_1 */
+	[  541] =  5345,	/* KEY_FN_2 */
+	[  542] =  5354,	/* KEY_FN_D */
+	[  543] =  5363,	/* KEY_FN_E */
+	[  544] =  5372,	/* KEY_FN_F */
+	[  545] =  5381,	/* KEY_FN_S */
+	[  546] =  5390,	/* KEY_FN_B */
+	[  547] =  5399,	/* KEY_FN_RIGHT_SHIFT */
+	[  559] =  5418,	/* KEY_BRL_DOT1 */
+	[  560] =  5431,	/* KEY_BRL_DOT2 */
+	[  561] =  5444,	/* KEY_BRL_DOT3 */
+	[  562] =  5457,	/* KEY_BRL_DOT4 */
+	[  563] =  5470,	/* KEY_BRL_DOT5 */
+	[  564] =  5483,	/* KEY_BRL_DOT6 */
+	[  565] =  5496,	/* KEY_BRL_DOT7 */
+	[  566] =  5509,	/* KEY_BRL_DOT8 */
+	[  567] =  5522,	/* KEY_BRL_DOT9 */
+	[  568] =  5535,	/* KEY_BRL_DOT10 */
+	[  574] =  5549,	/* KEY_NUMERIC_0 */
+	[  575] =  5563,	/* KEY_NUMERIC_1 */
+	[  576] =  5577,	/* KEY_NUMERIC_2 */
+	[  577] =  5591,	/* KEY_NUMERIC_3 */
+	[  578] =  5605,	/* KEY_NUMERIC_4 */
+	[  579] =  5619,	/* KEY_NUMERIC_5 */
+	[  580] =  5633,	/* KEY_NUMERIC_6 */
+	[  581] =  5647,	/* KEY_NUMERIC_7 */
+	[  582] =  5661,	/* KEY_NUMERIC_8 */
+	[  583] =  5675,	/* KEY_NUMERIC_9 */
+	[  584] =  5689,	/* KEY_NUMERIC_STAR */
+	[  585] =  5706,	/* KEY_NUMERIC_POUND */
+	[  586] =  5724,	/* KEY_NUMERIC_A */
+	[  587] =  5738,	/* KEY_NUMERIC_B */
+	[  588] =  5752,	/* KEY_NUMERIC_C */
+	[  589] =  5766,	/* KEY_NUMERIC_D */
+	[  590] =  5780,	/* KEY_CAMERA_FOCUS */
+	[  591] =  5797,	/* KEY_WPS_BUTTON */
+	[  592] =  5812,	/* KEY_TOUCHPAD_TOGGLE */
+	[  593] =  5832,	/* KEY_TOUCHPAD_ON */
+	[  594] =  5848,	/* KEY_TOUCHPAD_OFF */
+	[  595] =  5865,	/* KEY_CAMERA_ZOOMIN */
+	[  596] =  5883,	/* KEY_CAMERA_ZOOMOUT */
+	[  597] =  5902,	/* KEY_CAMERA_UP */
+	[  598] =  5916,	/* KEY_CAMERA_DOWN */
+	[  599] =  5932,	/* KEY_CAMERA_LEFT */
+	[  600] =  5948,	/* KEY_CAMERA_RIGHT */
+	[  601] =  5965,	/* KEY_ATTENDANT_ON */
+	[  602] =  5982,	/* KEY_ATTENDANT_OFF */
+	[  603] =  6000,	/* KEY_ATTENDANT_TOGGLE */
+	[  604] =  6021,	/* KEY_LIGHTS_TOGGLE */
+	[  606] =  6039,	/* BTN_DPAD_UP */
+	[  607] =  6051,	/* BTN_DPAD_DOWN */
+	[  608] =  6065,	/* BTN_DPAD_LEFT */
+	[  609] =  6079,	/* BTN_DPAD_RIGHT */
+	[  622] =  6094,	/* KEY_ALS_TOGGLE */
+	[  623] =  6109,	/* KEY_ROTATE_LOCK_TOGGLE */
+	[  624] =  6132,	/* KEY_REFRESH_RATE_TOGGLE */
+	[  638] =  6156,	/* KEY_BUTTONCONFIG */
+	[  639] =  6173,	/* KEY_TASKMANAGER */
+	[  640] =  6189,	/* KEY_JOURNAL */
+	[  641] =  6201,	/* KEY_CONTROLPANEL */
+	[  642] =  6218,	/* KEY_APPSELECT */
+	[  643] =  6232,	/* KEY_SCREENSAVER */
+	[  644] =  6248,	/* KEY_VOICECOMMAND */
+	[  645] =  6265,	/* KEY_ASSISTANT */
+	[  646] =  6279,	/* KEY_KBD_LAYOUT_NEXT */
+	[  647] =  6299,	/* KEY_EMOJI_PICKER */
+	[  648] =  6316,	/* KEY_DICTATE */
+	[  654] =  6328,	/* KEY_BRIGHTNESS_MIN */
+	[  670] =  6347,	/* KEY_KBDINPUTASSIST_PREV */
+	[  671] =  6371,	/* KEY_KBDINPUTASSIST_NEXT */
+	[  672] =  6395,	/* KEY_KBDINPUTASSIST_PREVGROUP */
+	[  673] =  6424,	/* KEY_KBDINPUTASSIST_NEXTGROUP */
+	[  674] =  6453,	/* KEY_KBDINPUTASSIST_ACCEPT */
+	[  675] =  6479,	/* KEY_KBDINPUTASSIST_CANCEL */
+	[  676] =  6505,	/* KEY_RIGHT_UP */
+	[  677] =  6518,	/* KEY_RIGHT_DOWN */
+	[  678] =  6533,	/* KEY_LEFT_UP */
+	[  679] =  6545,	/* KEY_LEFT_DOWN */
+	[  680] =  6559,	/* KEY_ROOT_MENU */
+	[  681] =  6573,	/* KEY_MEDIA_TOP_MENU */
+	[  682] =  6592,	/* KEY_NUMERIC_11 */
+	[  683] =  6607,	/* KEY_NUMERIC_12 */
+	[  684] =  6622,	/* KEY_AUDIO_DESC */
+	[  685] =  6637,	/* KEY_3D_MODE */
+	[  686] =  6649,	/* KEY_NEXT_FAVORITE */
+	[  687] =  6667,	/* KEY_STOP_RECORD */
+	[  688] =  6683,	/* KEY_PAUSE_RECORD */
+	[  689] =  6700,	/* KEY_VOD */
+	[  690] =  6708,	/* KEY_UNMUTE */
+	[  691] =  6719,	/* KEY_FASTREVERSE */
+	[  692] =  6735,	/* KEY_SLOWREVERSE */
+	[  693] =  6751,	/* KEY_DATA */
+	[  694] =  6760,	/* KEY_ONSCREEN_KEYBOARD */
+	[  695] =  6782,	/* KEY_PRIVACY_SCREEN_TOGGLE */
+	[  696] =  6808,	/* KEY_SELECTIVE_SCREENSHOT */
+	[  697] =  6833,	/* KEY_NEXT_ELEMENT */
+	[  698] =  6850,	/* KEY_PREVIOUS_ELEMENT */
+	[  699] =  6871,	/* KEY_AUTOPILOT_ENGAGE_TOGGLE */
+	[  700] =  6899,	/* KEY_MARK_WAYPOINT */
+	[  701] =  6917,	/* KEY_SOS */
+	[  702] =  6925,	/* KEY_NAV_CHART */
+	[  703] =  6939,	/* KEY_FISHING_CHART */
+	[  704] =  6957,	/* KEY_SINGLE_RANGE_RADAR */
+	[  705] =  6980,	/* KEY_DUAL_RANGE_RADAR */
+	[  706] =  7001,	/* KEY_RADAR_OVERLAY */
+	[  707] =  7019,	/* KEY_TRADITIONAL_SONAR */
+	[  708] =  7041,	/* KEY_CLEARVU_SONAR */
+	[  709] =  7059,	/* KEY_SIDEVU_SONAR */
+	[  710] =  7076,	/* KEY_NAV_INFO */
+	[  711] =  7089,	/* KEY_BRIGHTNESS_MENU */
+	[  718] =  7109,	/* KEY_MACRO1 */
+	[  719] =  7120,	/* KEY_MACRO2 */
+	[  720] =  7131,	/* KEY_MACRO3 */
+	[  721] =  7142,	/* KEY_MACRO4 */
+	[  722] =  7153,	/* KEY_MACRO5 */
+	[  723] =  7164,	/* KEY_MACRO6 */
+	[  724] =  7175,	/* KEY_MACRO7 */
+	[  725] =  7186,	/* KEY_MACRO8 */
+	[  726] =  7197,	/* KEY_MACRO9 */
+	[  727] =  7208,	/* KEY_MACRO10 */
+	[  728] =  7220,	/* KEY_MACRO11 */
+	[  729] =  7232,	/* KEY_MACRO12 */
+	[  730] =  7244,	/* KEY_MACRO13 */
+	[  731] =  7256,	/* KEY_MACRO14 */
+	[  732] =  7268,	/* KEY_MACRO15 */
+	[  733] =  7280,	/* KEY_MACRO16 */
+	[  734] =  7292,	/* KEY_MACRO17 */
+	[  735] =  7304,	/* KEY_MACRO18 */
+	[  736] =  7316,	/* KEY_MACRO19 */
+	[  737] =  7328,	/* KEY_MACRO20 */
+	[  738] =  7340,	/* KEY_MACRO21 */
+	[  739] =  7352,	/* KEY_MACRO22 */
+	[  740] =  7364,	/* KEY_MACRO23 */
+	[  741] =  7376,	/* KEY_MACRO24 */
+	[  742] =  7388,	/* KEY_MACRO25 */
+	[  743] =  7400,	/* KEY_MACRO26 */
+	[  744] =  7412,	/* KEY_MACRO27 */
+	[  745] =  7424,	/* KEY_MACRO28 */
+	[  746] =  7436,	/* KEY_MACRO29 */
+	[  747] =  7448,	/* KEY_MACRO30 */
+	[  750] =  7460,	/* KEY_MACRO_RECORD_START */
+	[  751] =  7483,	/* KEY_MACRO_RECORD_STOP */
+	[  752] =  7505,	/* KEY_MACRO_PRESET_CYCLE */
+	[  753] =  7528,	/* KEY_MACRO_PRESET1 */
+	[  754] =  7546,	/* KEY_MACRO_PRESET2 */
+	[  755] =  7564,	/* KEY_MACRO_PRESET3 */
+	[  758] =  7582,	/* KEY_KBD_LCD_MENU1 */
+	[  759] =  7600,	/* KEY_KBD_LCD_MENU2 */
+	[  760] =  7618,	/* KEY_KBD_LCD_MENU3 */
+	[  761] =  7636,	/* KEY_KBD_LCD_MENU4 */
+	[  762] =  7654,	/* KEY_KBD_LCD_MENU5 */
+	[  766] =  7690,	/* BTN_TRIGGER_HAPPY1 */
+	[  767] =  7709,	/* BTN_TRIGGER_HAPPY2 */
+	[  768] =  7728,	/* BTN_TRIGGER_HAPPY3 */
+	[  769] =  7747,	/* BTN_TRIGGER_HAPPY4 */
+	[  770] =  7766,	/* BTN_TRIGGER_HAPPY5 */
+	[  771] =  7785,	/* BTN_TRIGGER_HAPPY6 */
+	[  772] =  7804,	/* BTN_TRIGGER_HAPPY7 */
+	[  773] =  7823,	/* BTN_TRIGGER_HAPPY8 */
+	[  774] =  7842,	/* BTN_TRIGGER_HAPPY9 */
+	[  775] =  7861,	/* BTN_TRIGGER_HAPPY10 */
+	[  776] =  7881,	/* BTN_TRIGGER_HAPPY11 */
+	[  777] =  7901,	/* BTN_TRIGGER_HAPPY12 */
+	[  778] =  7921,	/* BTN_TRIGGER_HAPPY13 */
+	[  779] =  7941,	/* BTN_TRIGGER_HAPPY14 */
+	[  780] =  7961,	/* BTN_TRIGGER_HAPPY15 */
+	[  781] =  7981,	/* BTN_TRIGGER_HAPPY16 */
+	[  782] =  8001,	/* BTN_TRIGGER_HAPPY17 */
+	[  783] =  8021,	/* BTN_TRIGGER_HAPPY18 */
+	[  784] =  8041,	/* BTN_TRIGGER_HAPPY19 */
+	[  785] =  8061,	/* BTN_TRIGGER_HAPPY20 */
+	[  786] =  8081,	/* BTN_TRIGGER_HAPPY21 */
+	[  787] =  8101,	/* BTN_TRIGGER_HAPPY22 */
+	[  788] =  8121,	/* BTN_TRIGGER_HAPPY23 */
+	[  789] =  8141,	/* BTN_TRIGGER_HAPPY24 */
+	[  790] =  8161,	/* BTN_TRIGGER_HAPPY25 */
+	[  791] =  8181,	/* BTN_TRIGGER_HAPPY26 */
+	[  792] =  8201,	/* BTN_TRIGGER_HAPPY27 */
+	[  793] =  8221,	/* BTN_TRIGGER_HAPPY28 */
+	[  794] =  8241,	/* BTN_TRIGGER_HAPPY29 */
+	[  795] =  8261,	/* BTN_TRIGGER_HAPPY30 */
+	[  796] =  8281,	/* BTN_TRIGGER_HAPPY31 */
+	[  797] =  8301,	/* BTN_TRIGGER_HAPPY32 */
+	[  798] =  8321,	/* BTN_TRIGGER_HAPPY33 */
+	[  799] =  8341,	/* BTN_TRIGGER_HAPPY34 */
+	[  800] =  8361,	/* BTN_TRIGGER_HAPPY35 */
+	[  801] =  8381,	/* BTN_TRIGGER_HAPPY36 */
+	[  802] =  8401,	/* BTN_TRIGGER_HAPPY37 */
+	[  803] =  8421,	/* BTN_TRIGGER_HAPPY38 */
+	[  804] =  8441,	/* BTN_TRIGGER_HAPPY39 */
+	[  805] =  8461,	/* BTN_TRIGGER_HAPPY40 */
+	[  806] =  8481,	/* LED_NUML */
+	[  807] =  8490,	/* LED_CAPSL */
+	[  808] =  8500,	/* LED_SCROLLL */
+	[  809] =  8512,	/* LED_COMPOSE */
+	[  810] =  8524,	/* LED_KANA */
+	[  811] =  8533,	/* LED_SLEEP */
+	[  812] =  8543,	/* LED_SUSPEND */
+	[  813] =  8555,	/* LED_MUTE */
+	[  814] =  8564,	/* LED_MISC */
+	[  815] =  8573,	/* LED_MAIL */
+	[  816] =  8582,	/* LED_CHARGING */
+	[  817] =  8595,	/* MSC_SERIAL */
+	[  818] =  8606,	/* MSC_PULSELED */
+	[  819] =  8619,	/* MSC_GESTURE */
+	[  820] =  8631,	/* MSC_RAW */
+	[  821] =  8639,	/* MSC_SCAN */
+	[  822] =  8648,	/* MSC_TIMESTAMP */
+	[  823] =  8662,	/* REL_X */
+	[  824] =  8668,	/* REL_Y */
+	[  825] =  8674,	/* REL_Z */
+	[  826] =  8680,	/* REL_RX */
+	[  827] =  8687,	/* REL_RY */
+	[  828] =  8694,	/* REL_RZ */
+	[  829] =  8701,	/* REL_HWHEEL */
+	[  830] =  8712,	/* REL_DIAL */
+	[  831] =  8721,	/* REL_WHEEL */
+	[  832] =  8731,	/* REL_MISC */
+	[  833] =  8740,	/* REL_RESERVED */
+	[  834] =  8753,	/* REL_WHEEL_HI_RES */
+	[  835] =  8770,	/* REL_HWHEEL_HI_RES */
+	[  836] =  8788,	/* REP_DELAY */
+	[  837] =  8798,	/* REP_PERIOD */
+	[  838] =  8809,	/* SND_CLICK */
+	[  839] =  8819,	/* SND_BELL */
+	[  840] =  8828,	/* SND_TONE */
+	[  841] =  8837,	/* SW_LID */
+	[  842] =  8844,	/* SW_TABLET_MODE */
+	[  843] =  8859,	/* SW_HEADPHONE_INSERT */
+	[  844] =  8879,	/* SW_RFKILL_ALL */
+	[  845] =  8893,	/* SW_MICROPHONE_INSERT */
+	[  846] =  8914,	/* SW_DOCK */
+	[  847] =  8922,	/* SW_LINEOUT_INSERT */
+	[  848] =  8940,	/* SW_JACK_PHYSICAL_INSERT */
+	[  849] =  8964,	/* SW_VIDEOOUT_INSERT */
+	[  850] =  8983,	/* SW_CAMERA_LENS_COVER */
+	[  851] =  9004,	/* SW_KEYPAD_SLIDE */
+	[  852] =  9020,	/* SW_FRONT_PROXIMITY */
+	[  853] =  9039,	/* SW_ROTATE_LOCK */
+	[  854] =  9054,	/* SW_LINEIN_INSERT */
+	[  855] =  9071,	/* SW_MUTE_DEVICE */
+	[  856] =  9086,	/* SW_PEN_INSERTED */
+	[  857] =  9102,	/* SW_MACHINE_COVER */
+	[  858] =  9119,	/* SYN_REPORT */
+	[  859] =  9130,	/* SYN_CONFIG */
+	[  860] =  9141,	/* SYN_MT_REPORT */
+	[  861] =  9155,	/* SYN_DROPPED */
+};
+
+static const struct {
+	unsigned short name;
+	unsigned short base;
+	unsigned short count;
+} typetab[] = {
+	[  0x3] = {   558,     0,    62 },	/* ABS */
+	[  0x1] = {   544,    62,   744 },	/* KEY */
+	[ 0x11] = {   578,   806,    11 },	/* LED */
+	[  0x4] = {   565,   817,     6 },	/* MSC */
+	[  0x2] = {   551,   823,    13 },	/* REL */
+	[ 0x14] = {   592,   836,     2 },	/* REP */
+	[ 0x12] = {   585,   838,     3 },	/* SND */
+	[  0x5] = {   572,   841,    17 },	/* SW */
+	[    0] = {   537,   858,     4 },	/* SYN */
+};
+
+static u32 code_hash(const char *name, unsigned int len, u32 h, u32 m)
+{
+	while (len--)
+		h = h * m + (unsigned char)*name++;
+
+	return h;
+}
+
+const struct code_entry *code_lookup(const char *name, unsigned int len)
+{
+	const struct code_entry *e;
+	u32 h1 = code_hash(name, len, CODE_SEED, 16777619);
+	u32 h2 = code_hash(name, len, CODE_SEED, 2654435761u);
+	u32 d = code_disp[h1 % CODE_BUCKETS];
+
+	e = &codetab[(h1 % CODE_SIZE +
+			(d % CODE_SIZE) * (h2 % (CODE_SIZE - 1) + 1) % CODE_SIZE +
+			d / CODE_SIZE) % CODE_SIZE];
+	if (e->name == 0 || strncmp(code_strings + e->name, name, len) ||
+			code_strings[e->name + len] != '\0')
+		return NULL;
+
+	return e;
+}
+
+const char *code_type_name(unsigned int type)
+{
+	if (type >= ARRAY_SIZE(typetab) || typetab[type].name == 0)
+		return NULL;
+
+	return code_strings + typetab[type].name;
+}
+
+const char *code_name(unsigned int type, unsigned int code)
+{
+	unsigned short name;
+
+	if (type >= ARRAY_SIZE(typetab) || code >= typetab[type].count)
+		return NULL;
+
+	name = code_names[typetab[type].base + code];
+	if (name == 0)
+		return NULL;
+
+	return code_strings + name;
+}
@@ -2,20 +2,16 @@
 #define __TABLES_H_
 
 struct code_entry {
-	const char *name;
+	unsigned short name;
 	unsigned short type;
 	unsigned short code;
 };
 
-extern const struct code_entry codetab[];
-extern const unsigned int codetab_sz;
+/* names are stored as offsets into this pool */
+extern const char code_strings[];
 
-struct nametab_entry {
-	const char *name;
-	const char **tab;
-};
-
-extern const struct nametab_entry nametab[];
-extern const unsigned int nametab_sz;
+const struct code_entry *code_lookup(const char *name, unsigned int len);
+const char *code_type_name(unsigned int type);
+const char *code_name(unsigned int type, unsigned int code);
 
 #endif
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright (c) 2017 Courtney Cavin
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+
+#include "uinput.h"
+
+#ifndef UINPUT_PATH
+#define UINPUT_PATH "/dev/uinput"
+#endif
+
+/*
+ * The output device, created the first time an event is to be emitted
+ * and kept for as long as evev runs.  Its phys is unique to this process
+ * so evev can tell it apart from the devices it reads.
+ */
+static int uinput_fd = -1;
+static char uinput_physname[32];
+
+/*
+ * The keys and buttons of keyboards and mice; joystick, gamepad and
+ * tablet buttons are left out lest the device be taken for one of those.
+ */
+int uinput_supports(unsigned int type, unsigned int code)
+{
+	switch (type) {
+	case EV_KEY:
+		return (code > KEY_RESERVED && code < BTN_MISC) ||
+			(code >= BTN_LEFT && code <= BTN_TASK) ||
+			(code >= KEY_OK && code < BTN_DPAD_UP) ||
+			(code >= KEY_ALS_TOGGLE && code < BTN_TRIGGER_HAPPY) ||
+			(code > BTN_TRIGGER_HAPPY40 && code <= KEY_MAX);
+	case EV_REL:
+		return code == REL_X || code == REL_Y ||
+			code == REL_WHEEL || code == REL_HWHEEL;
+	}
+
+	return 0;
+}
+
+static int uinput_setup(int fd)
+{
+	struct uinput_setup us = { { BUS_VIRTUAL, 0, 0, 1 }, "evev", };
+
+	if (ioctl(fd, UI_SET_EVBIT, EV_KEY) == -1 ||
+			ioctl(fd, UI_SET_EVBIT, EV_REL) == -1)
+		return -1;
+
+	for (unsigned int code = 0; code <= KEY_MAX; ++code) {
+		if (uinput_supports(EV_KEY, code) &&
+				ioctl(fd, UI_SET_KEYBIT, code) == -1)
+			return -1;
+	}
+
+	for (unsigned int code = 0; code <= REL_MAX; ++code) {
+		if (uinput_supports(EV_REL, code) &&
+				ioctl(fd, UI_SET_RELBIT, code) == -1)
+			return -1;
+	}
+
+	snprintf(uinput_physname, sizeof(uinput_physname), "evev/%d",
+			getpid());
+	if (ioctl(fd, UI_SET_PHYS, uinput_physname) == -1 ||
+			ioctl(fd, UI_DEV_SETUP, &us) == -1 ||
+			ioctl(fd, UI_DEV_CREATE) == -1)
+		return -1;
+
+	return 0;
+}
+
+/* create the output device, unless that's done already */
+int uinput_open(void)
+{
+	int fd;
+
+	if (uinput_fd != -1)
+		return 0;
+
+	fd = open(UINPUT_PATH, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+	if (fd == -1)
+		return -1;
+
+	if (uinput_setup(fd)) {
+		int saved = errno;
+
+		close(fd);
+		uinput_physname[0] = '\0';
+		errno = saved;
+		return -1;
+	}
+
+	uinput_fd = fd;
+
+	return 0;
+}
+
+/* whether phys is that of the output device */
+int uinput_is_own(const char *phys)
+{
+	return uinput_physname[0] && !strcmp(phys, uinput_physname);
+}
+
+/* emit the n events of evs, which ought to end in a SYN_REPORT */
+int uinput_emit(const struct input_event *evs, unsigned int n)
+{
+	ssize_t len = n * sizeof(*evs);
+	ssize_t rc;
+
+	if (uinput_open())
+		return -1;
+
+	do {
+		rc = write(uinput_fd, evs, len);
+	} while (rc == -1 && errno == EINTR);
+
+	if (rc == -1)
+		return -1;
+	if (rc != len) {
+		errno = EIO;
+		return -1;
+	}
+
+	return 0;
+}
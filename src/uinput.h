@@ -0,0 +1,11 @@
+#ifndef __UINPUT_H_
+#define __UINPUT_H_
+
+#include <linux/input.h>
+
+int uinput_supports(unsigned int type, unsigned int code);
+int uinput_open(void);
+int uinput_is_own(const char *phys);
+int uinput_emit(const struct input_event *evs, unsigned int n);
+
+#endif